@@ -0,0 +1,9 @@
+﻿#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+#include <cstdint>
+
+class AllocationCounter {
+public:
+    static std::uint64_t threadAllocations();
+};
+#endif
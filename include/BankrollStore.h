@@ -0,0 +1,146 @@
+﻿#ifndef BANKROLL_STORE_H
+#define BANKROLL_STORE_H
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class BankrollStore {
+public:
+    struct Transfer {
+        std::uint64_t account;
+        std::int64_t delta;
+    };
+
+    struct Header {
+        std::array<char, 4> magic;
+        std::uint32_t version;
+        std::uint64_t capacity;
+        std::uint64_t count;
+        std::uint64_t appliedLsn;
+    };
+
+    struct Slot {
+        std::uint64_t account;
+        std::int64_t balance;
+    };
+
+    struct Record {
+        std::uint64_t lsn;
+        std::uint32_t entries;
+        std::uint32_t checksum;
+    };
+
+    static constexpr std::array<char, 4> MAGIC{'P', 'K', 'B', 'R'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint64_t HOUSE_ACCOUNT = 1;
+    static constexpr std::size_t MAX_TRANSFERS = 64;
+
+    explicit BankrollStore(const std::string &path, std::uint64_t capacity = 1 << 16);
+
+    ~BankrollStore();
+
+    BankrollStore(const BankrollStore &) = delete;
+
+    BankrollStore &operator=(const BankrollStore &) = delete;
+
+    std::int64_t balance(std::uint64_t account) const;
+
+    std::optional<std::uint64_t> deposit(std::uint64_t account, std::int64_t amount);
+
+    std::optional<std::uint64_t> settle(std::span<const Transfer> transfers);
+
+    std::optional<std::uint64_t> buyIn(std::uint64_t account, std::int64_t stake, std::int64_t grant);
+
+    std::optional<std::uint64_t> cashOut(std::uint64_t account);
+
+    void waitDurable(std::uint64_t lsn);
+
+    void checkpoint();
+
+    std::uint64_t getDurableLsn() const;
+
+    std::uint64_t getSettlements() const;
+
+    std::uint64_t getGroupCommits() const;
+
+    std::uint64_t getRejected() const;
+
+    std::uint64_t getRecoveredRecords() const;
+
+    std::size_t size() const;
+
+    static std::uint64_t accountId(std::string_view name);
+
+    static std::uint64_t escrowAccount(std::uint64_t account);
+
+private:
+    static constexpr std::uint64_t WAL_CHECKPOINT_BYTES = 64 << 20;
+
+    struct Pending {
+        std::int64_t balance;
+        std::uint64_t lsn;
+    };
+
+    std::string tablePath_;
+    std::string walPath_;
+    int tableFd_;
+    int walFd_;
+    void *mapping_;
+    std::size_t length_;
+    Header *header_;
+    Slot *slots_;
+    std::uint64_t walBytes_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable pendingReady_;
+    std::condition_variable durable_;
+    std::unordered_map<std::uint64_t, Pending> pending_;
+    std::unordered_set<std::uint64_t> seated_;
+    std::vector<std::uint8_t> log_;
+    std::vector<Slot> scratch_;
+    std::uint64_t nextLsn_;
+    std::uint64_t durableLsn_;
+    std::uint64_t settlements_;
+    std::uint64_t groupCommits_;
+    std::uint64_t rejected_;
+    std::uint64_t recoveredRecords_;
+    bool stopping_;
+    std::exception_ptr failure_;
+    std::thread committer_;
+
+    std::optional<std::uint64_t> append(std::span<const Transfer> transfers, bool balanced);
+
+    std::int64_t projected(std::uint64_t account) const;
+
+    bool known(std::uint64_t account) const;
+
+    void commitLoop();
+
+    void apply(std::span<const std::uint8_t> log);
+
+    void store(std::uint64_t account, std::int64_t balance);
+
+    Slot *find(std::uint64_t account) const;
+
+    void map(std::uint64_t capacity);
+
+    void grow();
+
+    void recover();
+
+    void truncateLog();
+
+    void release();
+};
+#endif
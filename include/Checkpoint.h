@@ -0,0 +1,67 @@
+﻿#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Checkpoint {
+public:
+    static constexpr std::uint32_t MAGIC = 0x50434B50;
+    static constexpr std::uint32_t VERSION = 2;
+    static constexpr std::size_t HEADER_SIZE = 16;
+    static constexpr std::size_t MAX_TEXT = 16 * 1024;
+
+    class Writer {
+    public:
+        explicit Writer(std::vector<std::uint8_t> &out);
+
+        void u8(std::uint8_t value) const;
+
+        void u32(std::uint32_t value) const;
+
+        void i32(std::int32_t value) const;
+
+        void text(std::string_view value) const;
+
+        void bytes(std::span<const std::uint8_t> value) const;
+
+    private:
+        std::vector<std::uint8_t> &out_;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(std::span<const std::uint8_t> payload);
+
+        std::uint8_t u8();
+
+        std::uint32_t u32();
+
+        std::int32_t i32();
+
+        std::string text();
+
+        void bytes(std::span<std::uint8_t> value);
+
+        bool ok() const;
+
+        bool complete() const;
+
+    private:
+        std::span<const std::uint8_t> payload_;
+        std::size_t pos_;
+        bool ok_;
+
+        bool require(std::size_t bytes);
+    };
+
+    static void writeFile(const std::string &path, std::span<const std::uint8_t> payload);
+
+    static std::optional<std::vector<std::uint8_t> > readFile(const std::string &path);
+
+    static std::uint32_t checksum(std::span<const std::uint8_t> bytes);
+};
+#endif
@@ -1,15 +1,55 @@
 ﻿#ifndef COMPUTER_PLAYER_H
 #define COMPUTER_PLAYER_H
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <random>
 
+#include "DecisionService.h"
+#include "DecisionSlot.h"
 #include "Player.h"
 
+class HandAbstraction;
+
 class ComputerPlayer final : public Player {
 public:
     explicit ComputerPlayer(const std::string &name, int initialChips = 1000);
 
-    Action makeDecision(int currentBet, int chipsCommitted, const std::vector<Card> &_) override;
+    ~ComputerPlayer() override;
+
+    Action makeDecision(int currentBet, int chipsCommitted, const std::vector<Card> &communityCards) override;
 
     int getRaiseAmount(int currentBet, int _) override;
+
+    Task<Decision> decide(const DecisionView &view) override;
+
+    void setDecisionService(std::shared_ptr<DecisionService> service);
+
+    void setHandAbstraction(std::shared_ptr<const HandAbstraction> abstraction);
+
+    void setSeed(std::uint32_t seed);
+
+private:
+    struct ServiceLink {
+        std::mutex mutex;
+        DecisionSlot *slot = nullptr;
+    };
+
+    std::mt19937 gen_;
+    std::shared_ptr<DecisionService> decisionService_;
+    std::shared_ptr<ServiceLink> serviceLink_;
+    std::shared_ptr<const HandAbstraction> abstraction_;
+    DecisionSlot serviceSlot_;
+    int plannedRaise_;
+    int opponents_;
+
+    void unlinkService();
+
+    double abstractionStrength(const std::vector<Card> &communityCards) const;
+
+    DecisionService::Request makeServiceRequest(int currentBet, int chipsCommitted,
+                                                const std::vector<Card> &communityCards, int opponents) const;
+
+    Action announce(Action action);
 };
 #endif
@@ -0,0 +1,13 @@
+﻿#ifndef CONSOLE_H
+#define CONSOLE_H
+#include <ostream>
+
+class Console {
+public:
+    static std::ostream &out();
+
+    static void setQuiet(bool quiet);
+
+    static bool isQuiet();
+};
+#endif
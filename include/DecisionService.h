@@ -0,0 +1,104 @@
+﻿#ifndef DECISION_SERVICE_H
+#define DECISION_SERVICE_H
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <random>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "HandEvaluator.h"
+#include "Player.h"
+
+class DecisionService {
+public:
+    struct Request {
+        HandEvaluator::CardMask holeCards;
+        HandEvaluator::CardMask communityCards;
+        int opponents;
+        int currentBet;
+        int chipsCommitted;
+        int chipCount;
+    };
+
+    struct Result {
+        Player::Action action;
+        int raiseAmount;
+        double equity;
+    };
+
+    explicit DecisionService(std::size_t maxBatchSize = 512, int samplesPerDecision = 400,
+                             std::size_t cacheCapacity = 1 << 16);
+
+    ~DecisionService();
+
+    DecisionService(const DecisionService &) = delete;
+
+    DecisionService &operator=(const DecisionService &) = delete;
+
+    std::future<Result> submit(const Request &request);
+
+    void submit(const Request &request, std::function<void(const Result &)> onReady);
+
+    Result decideNow(const Request &request) const;
+
+    static Result chooseAction(const Request &request, double equity);
+
+    std::uint64_t getDecisionsServed() const;
+
+    std::uint64_t getBatchesProcessed() const;
+
+    std::uint64_t getCacheHits() const;
+
+    static constexpr int MAX_OPPONENTS = 9;
+
+private:
+    struct Pending {
+        Request request;
+        std::promise<Result> promise;
+        std::function<void(const Result &)> onReady;
+    };
+
+    struct CacheKey {
+        std::uint64_t hand;
+        std::uint64_t board;
+        int street;
+        int opponents;
+
+        bool operator==(const CacheKey &other) const = default;
+    };
+
+    struct CacheKeyHash {
+        std::size_t operator()(const CacheKey &key) const;
+    };
+
+    void workerLoop();
+
+    void processBatch(std::vector<Pending> &batch);
+
+    static CacheKey cacheKey(const Request &request);
+
+    static void computeEquities(std::span<const Request *const> requests, std::span<double> equities,
+                                int samples, std::mt19937_64 &rng);
+
+    std::size_t maxBatchSize_;
+    int samplesPerDecision_;
+    std::size_t cacheCapacity_;
+    std::unordered_map<CacheKey, double, CacheKeyHash> equityCache_;
+    std::mt19937_64 rng_;
+
+    std::atomic<std::uint64_t> decisionsServed_;
+    std::atomic<std::uint64_t> batchesProcessed_;
+    std::atomic<std::uint64_t> cacheHits_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::vector<Pending> queue_;
+    bool stopping_;
+    std::thread worker_;
+};
+#endif
@@ -0,0 +1,44 @@
+﻿#ifndef DECISION_SLOT_H
+#define DECISION_SLOT_H
+#include <atomic>
+#include <coroutine>
+
+#include "Player.h"
+
+class TableScheduler;
+
+class DecisionSlot {
+public:
+    class Awaiter {
+    public:
+        Awaiter(DecisionSlot &slot, TableScheduler *scheduler);
+
+        bool await_ready() const noexcept;
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept;
+
+        Player::Decision await_resume() const noexcept;
+
+    private:
+        DecisionSlot &slot_;
+        TableScheduler *scheduler_;
+    };
+
+    DecisionSlot();
+
+    Awaiter wait(TableScheduler *scheduler);
+
+    bool fulfill(const Player::Decision &decision);
+
+    bool isWaiting() const;
+
+private:
+    enum class State { IDLE, ARMED, SUSPENDED, READY };
+
+    std::atomic<State> state_;
+    Player::Decision decision_;
+    std::atomic<bool> claimed_;
+    std::coroutine_handle<> waiter_;
+    TableScheduler *scheduler_;
+};
+#endif
@@ -0,0 +1,57 @@
+﻿#ifndef EXPLOITATIVE_PLAYER_H
+#define EXPLOITATIVE_PLAYER_H
+#include <memory>
+#include <random>
+
+#include "OpponentModel.h"
+#include "Player.h"
+
+class HandAbstraction;
+
+class ExploitativePlayer final : public Player {
+public:
+    explicit ExploitativePlayer(const std::string &name, int initialChips = 1000,
+                                std::size_t modelCapacity = 256, int samples = 600);
+
+    Action makeDecision(int currentBet, int chipsCommitted, const std::vector<Card> &communityCards) override;
+
+    int getRaiseAmount(int currentBet, int _) override;
+
+    void observeAction(const std::string &playerName, Action action, int amount, int pot, int street) override;
+
+    void observeShowdown(const std::string &playerName, const std::vector<Card> &holeCards,
+                         const std::vector<Card> &communityCards) override;
+
+    void clearHand() override;
+
+    const OpponentModelStore &getOpponentModels() const;
+
+    void setHandAbstraction(std::shared_ptr<const HandAbstraction> abstraction);
+
+private:
+    static constexpr std::size_t MAX_TRACKED_OPPONENTS = 9;
+
+    struct HandOpponent {
+        std::uint64_t id;
+        bool folded;
+        bool raised;
+    };
+
+    OpponentModelStore models_;
+    std::shared_ptr<const HandAbstraction> abstraction_;
+    std::vector<HandOpponent> handOpponents_;
+    std::vector<HandOpponent> lastHandOpponents_;
+    std::mt19937_64 gen_;
+    int samples_;
+    int plannedRaise_;
+
+    double estimateEquity(const std::vector<Card> &communityCards, int street);
+
+    double rangeWeight(const HandOpponent &opponent, int firstCard, int secondCard,
+                       HandEvaluator::CardMask board, int street) const;
+
+    double handStrength(int firstCard, int secondCard, HandEvaluator::CardMask board, int street) const;
+
+    static double preflopStrength(int firstCard, int secondCard);
+};
+#endif
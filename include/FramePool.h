@@ -0,0 +1,15 @@
+﻿#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+#include <cstddef>
+
+class FramePool {
+public:
+    static void *allocate(std::size_t size);
+
+    static void deallocate(void *frame, std::size_t size) noexcept;
+
+    static constexpr std::size_t GRANULE = 64;
+    static constexpr std::size_t SIZE_CLASSES = 64;
+    static constexpr std::size_t MAX_CACHED = 256;
+};
+#endif
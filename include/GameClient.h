@@ -0,0 +1,55 @@
+﻿#ifndef GAME_CLIENT_H
+#define GAME_CLIENT_H
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Protocol.h"
+
+class GameClient {
+public:
+    static GameClient connectTcp(const std::string &host, std::uint16_t port);
+
+    static GameClient connectUnix(const std::string &path);
+
+    GameClient(GameClient &&other) noexcept;
+
+    GameClient &operator=(GameClient &&other) noexcept;
+
+    GameClient(const GameClient &) = delete;
+
+    GameClient &operator=(const GameClient &) = delete;
+
+    ~GameClient();
+
+    template<typename Message>
+    void send(const Message &message) {
+        out_.clear();
+        Protocol::encode(out_, message);
+        writeAll();
+    }
+
+    std::optional<Protocol::Frame> receive();
+
+    std::optional<Protocol::Frame> poll();
+
+    bool fillNonBlocking();
+
+    void setNonBlocking();
+
+    int getFd() const;
+
+private:
+    explicit GameClient(int fd);
+
+    int fd_;
+    std::vector<std::uint8_t> in_;
+    std::size_t consumed_;
+    std::vector<std::uint8_t> out_;
+
+    void writeAll() const;
+
+    bool fill();
+};
+#endif
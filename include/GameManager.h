@@ -3,11 +3,13 @@
 #include <memory>
 #include <vector>
 
+#include "Checkpoint.h"
+#include "Leaderboard.h"
 #include "Player.h"
 
 class GameManager {
 public:
-    explicit GameManager(int maxRounds = 100);
+    explicit GameManager(int maxRounds = 100, bool historyRecorded = true);
 
     void displayGameStatus(const std::vector<std::unique_ptr<Player> > &players) const;
 
@@ -15,6 +17,16 @@ public:
 
     void recordRoundResult(const std::string &result);
 
+    void recordRoundWinner(const std::string &name);
+
+    void recordRoundSplit(std::size_t winners);
+
+    void recordChips(const Player &player);
+
+    void recordElimination(const Player &player);
+
+    const Leaderboard &getLeaderboard() const;
+
     void saveGameHistory() const;
 
     void displayGameOver(const std::vector<std::unique_ptr<Player> > &players) const;
@@ -23,12 +35,25 @@ public:
 
     int getRoundsPlayed() const;
 
+    int getMaxRounds() const;
+
+    bool isSaveRequested() const;
+
     void endGame();
 
+    void save(const Checkpoint::Writer &writer) const;
+
+    bool restore(Checkpoint::Reader &reader);
+
 private:
     bool gameRunning_;
+    bool saveRequested_;
+    bool historyRecorded_;
     int roundsPlayed_;
     int maxRounds_;
     std::vector<std::string> gameHistory_;
+    std::unique_ptr<Leaderboard> leaderboard_;
+
+    static constexpr std::size_t STANDINGS_SHOWN = 10;
 };
 #endif
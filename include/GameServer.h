@@ -0,0 +1,105 @@
+﻿#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Protocol.h"
+
+class BankrollStore;
+class DecisionService;
+class HandAbstraction;
+
+class GameServer {
+public:
+    struct Config {
+        std::string bindAddress = "127.0.0.1";
+        std::uint16_t tcpPort = 0;
+        bool enableTcp = true;
+        std::string unixPath;
+        int workers = 1;
+        int seatsPerTable = 3;
+        int botsPerTable = 2;
+        int handsPerTable = 50;
+        int initialChips = 1000;
+        int decisionTimeoutMs = 0;
+        int timeBankMs = 0;
+        std::string bankrollPath;
+        bool decisionService = false;
+        std::string abstractionPath;
+    };
+
+    explicit GameServer(Config config);
+
+    ~GameServer();
+
+    GameServer(const GameServer &) = delete;
+
+    GameServer &operator=(const GameServer &) = delete;
+
+    void start();
+
+    void stop();
+
+    std::uint16_t getTcpPort() const;
+
+    std::uint64_t getTablesOpened() const;
+
+    std::uint64_t getHandsPlayed() const;
+
+    std::uint64_t getActionsReceived() const;
+
+    std::uint64_t getConnectionsAccepted() const;
+
+    std::uint64_t getDecisionTimeouts() const;
+
+    std::uint64_t getSpectators() const;
+
+    std::uint64_t getSpectatorEventsDropped() const;
+
+    std::uint64_t getSettlements() const;
+
+    std::uint64_t getSettlementsRejected() const;
+
+private:
+    class Worker;
+
+    struct PendingConnection {
+        std::vector<std::uint8_t> buffer;
+    };
+
+    Config config_;
+    int tcpListener_;
+    int unixListener_;
+    int acceptEpoll_;
+    int stopEvent_;
+    std::uint16_t boundPort_;
+    std::atomic<bool> running_;
+    std::atomic<std::uint64_t> tablesOpened_;
+    std::atomic<std::uint64_t> handsPlayed_;
+    std::atomic<std::uint64_t> actionsReceived_;
+    std::atomic<std::uint64_t> connectionsAccepted_;
+    std::atomic<std::uint64_t> decisionTimeouts_;
+    std::atomic<std::uint64_t> spectators_;
+    std::atomic<std::uint64_t> spectatorEventsDropped_;
+    std::atomic<std::uint64_t> settlementsRejected_;
+    std::unordered_map<int, PendingConnection> pending_;
+    std::unique_ptr<BankrollStore> bankroll_;
+    std::shared_ptr<DecisionService> decisionService_;
+    std::shared_ptr<const HandAbstraction> abstraction_;
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::thread acceptor_;
+
+    void acceptLoop();
+
+    void acceptFrom(int listener);
+
+    void readJoin(int fd);
+
+    void dropPending(int fd);
+};
+#endif
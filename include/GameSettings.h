@@ -1,8 +1,11 @@
 ﻿#ifndef GAME_SETTINGS_H
 #define GAME_SETTINGS_H
+#include "Checkpoint.h"
 
 class GameSettings {
 public:
+    enum class Variant { TEXAS_HOLDEM, POT_LIMIT_OMAHA };
+
     GameSettings();
 
     void displaySettings() const;
@@ -15,9 +18,27 @@ public:
 
     int getDifficulty() const;
 
+    Variant getVariant() const;
+
+    void setVariant(Variant variant);
+
+    bool isHistoryRecorded() const;
+
+    void setHistoryRecorded(bool recorded);
+
+    int getHoleCardCount() const;
+
+    void save(const Checkpoint::Writer &writer) const;
+
+    bool restore(Checkpoint::Reader &reader);
+
+    static const char *variantName(Variant variant);
+
 private:
     int initialChips_;
     int maxRounds_;
     int difficulty_;
+    Variant variant_;
+    bool historyRecorded_;
 };
 #endif
@@ -0,0 +1,84 @@
+﻿#ifndef GAME_VARIANT_H
+#define GAME_VARIANT_H
+#include <array>
+#include <cstdint>
+
+#include "HandEvaluator.h"
+
+template<int LowestRank, int HoleCards, bool FlushBeatsFullHouse>
+struct GameVariant {
+    static_assert(LowestRank >= 2 && LowestRank <= 10, "A variant needs at least one straight");
+
+    static constexpr int LOWEST_RANK = LowestRank;
+    static constexpr int HOLE_CARDS = HoleCards;
+    static constexpr int DECK_SIZE = 4 * (15 - LowestRank);
+
+    static constexpr auto DECK = [] {
+        std::array<int, DECK_SIZE> deck{};
+        auto next = 0;
+        for (auto suit = 0; suit < 4; suit++) {
+            for (auto rank = LowestRank; rank <= 14; rank++) {
+                deck[next++] = suit * 13 + rank - 2;
+            }
+        }
+        return deck;
+    }();
+
+    static constexpr auto CATEGORY_ORDER = [] {
+        std::array<int, 9> order{};
+        for (auto category = 0; category < 9; category++) {
+            order[category] = category;
+        }
+        if (FlushBeatsFullHouse) {
+            order[static_cast<int>(HandEvaluator::Category::FLUSH)] =
+                    static_cast<int>(HandEvaluator::Category::FULL_HOUSE);
+            order[static_cast<int>(HandEvaluator::Category::FULL_HOUSE)] =
+                    static_cast<int>(HandEvaluator::Category::FLUSH);
+        }
+        return order;
+    }();
+
+    static constexpr std::uint32_t WHEEL_RANKS = 1u << 12 | 0xFu << (LowestRank - 2);
+
+    static int evaluate(HandEvaluator::CardMask cards);
+
+    static HandEvaluator::Category categoryOf(int score);
+};
+
+using HoldemVariant = GameVariant<2, 2, false>;
+using ShortDeckVariant = GameVariant<6, 2, true>;
+
+template<int LowestRank, int HoleCards, bool FlushBeatsFullHouse>
+int GameVariant<LowestRank, HoleCards, FlushBeatsFullHouse>::evaluate(const HandEvaluator::CardMask cards) {
+    auto score = HandEvaluator::evaluate(cards);
+    if constexpr (LowestRank != 2) {
+        constexpr auto WHEEL_HIGH = LowestRank + 3;
+        std::uint32_t ranks = 0;
+        for (auto suit = 0; suit < 4; suit++) {
+            const auto suitRanks = static_cast<std::uint32_t>(cards >> suit * HandEvaluator::SUIT_STRIDE) &
+                                   HandEvaluator::RANK_BITS;
+            if ((suitRanks & WHEEL_RANKS) == WHEEL_RANKS &&
+                HandEvaluator::categoryOf(score) < HandEvaluator::Category::STRAIGHT_FLUSH) {
+                score = static_cast<int>(HandEvaluator::Category::STRAIGHT_FLUSH) << HandEvaluator::CATEGORY_SHIFT |
+                        WHEEL_HIGH;
+            }
+            ranks |= suitRanks;
+        }
+        if ((ranks & WHEEL_RANKS) == WHEEL_RANKS &&
+            HandEvaluator::categoryOf(score) < HandEvaluator::Category::STRAIGHT) {
+            score = static_cast<int>(HandEvaluator::Category::STRAIGHT) << HandEvaluator::CATEGORY_SHIFT | WHEEL_HIGH;
+        }
+    }
+    if constexpr (FlushBeatsFullHouse) {
+        constexpr auto KICKERS = (1 << HandEvaluator::CATEGORY_SHIFT) - 1;
+        score = CATEGORY_ORDER[score >> HandEvaluator::CATEGORY_SHIFT] << HandEvaluator::CATEGORY_SHIFT |
+                (score & KICKERS);
+    }
+    return score;
+}
+
+template<int LowestRank, int HoleCards, bool FlushBeatsFullHouse>
+HandEvaluator::Category GameVariant<LowestRank, HoleCards, FlushBeatsFullHouse>::categoryOf(const int score) {
+    return static_cast<HandEvaluator::Category>(CATEGORY_ORDER[score >> HandEvaluator::CATEGORY_SHIFT]);
+}
+#endif
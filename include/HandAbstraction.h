@@ -0,0 +1,95 @@
+﻿#ifndef HAND_ABSTRACTION_H
+#define HAND_ABSTRACTION_H
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Card.h"
+#include "HandEvaluator.h"
+#include "HandIndexer.h"
+
+class BucketMap {
+public:
+    struct Header {
+        std::array<char, 4> magic;
+        std::uint32_t version;
+        std::uint32_t street;
+        std::uint32_t buckets;
+        std::uint64_t count;
+    };
+
+    static constexpr std::array<char, 4> MAGIC{'P', 'K', 'A', 'B'};
+    static constexpr std::uint32_t VERSION = 1;
+
+    explicit BucketMap(const std::string &path);
+
+    ~BucketMap();
+
+    BucketMap(BucketMap &&other) noexcept;
+
+    BucketMap &operator=(BucketMap &&other) noexcept;
+
+    BucketMap(const BucketMap &) = delete;
+
+    BucketMap &operator=(const BucketMap &) = delete;
+
+    int getStreet() const;
+
+    int getBuckets() const;
+
+    std::uint64_t size() const;
+
+    int bucket(HandIndexer::Index index) const;
+
+    int bucket(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards) const;
+
+private:
+    void *mapping_;
+    std::size_t length_;
+    const Header *header_;
+    const std::uint16_t *buckets_;
+
+    void release();
+};
+
+class HandAbstraction {
+public:
+    struct BuildConfig {
+        int street = 1;
+        int buckets = 50;
+        int bins = 8;
+        int rollouts = 32;
+        int opponents = 16;
+        int iterations = 12;
+        int threads = 1;
+        std::uint64_t seed = 1;
+    };
+
+    struct BuildStats {
+        std::uint64_t hands;
+        int iterations;
+        double featureSeconds;
+        double clusterSeconds;
+    };
+
+    explicit HandAbstraction(const std::string &directory);
+
+    int bucket(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards) const;
+
+    double strength(HandEvaluator::CardMask holeCards, HandEvaluator::CardMask communityCards) const;
+
+    bool hasStreet(int street) const;
+
+    static BuildStats build(const BuildConfig &config, const std::string &path);
+
+    static std::string fileName(int street);
+
+private:
+    std::array<std::optional<BucketMap>, 4> maps_;
+
+    static int streetOf(std::size_t communityCards);
+};
+#endif
@@ -0,0 +1,43 @@
+﻿#ifndef HAND_ARENA_H
+#define HAND_ARENA_H
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+class HandArena final : public std::pmr::memory_resource {
+public:
+    explicit HandArena(std::size_t capacity = 16 * 1024);
+
+    ~HandArena() override;
+
+    HandArena(const HandArena &) = delete;
+
+    HandArena &operator=(const HandArena &) = delete;
+
+    void reset();
+
+    std::size_t getCapacity() const;
+
+    std::size_t getHighWater() const;
+
+private:
+    struct Overflow {
+        void *block;
+        std::size_t alignment;
+    };
+
+    std::unique_ptr<std::byte[]> buffer_;
+    std::size_t capacity_;
+    std::size_t used_;
+    std::size_t highWater_;
+    std::size_t overflowBytes_;
+    std::vector<Overflow> overflow_;
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void *block, std::size_t bytes, std::size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+};
+#endif
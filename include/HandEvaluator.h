@@ -0,0 +1,48 @@
+﻿#ifndef HAND_EVALUATOR_H
+#define HAND_EVALUATOR_H
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Card.h"
+
+class HandEvaluator {
+public:
+    enum class Category {
+        HIGH_CARD, ONE_PAIR, TWO_PAIR, THREE_OF_A_KIND, STRAIGHT,
+        FLUSH, FULL_HOUSE, FOUR_OF_A_KIND, STRAIGHT_FLUSH
+    };
+
+    using CardMask = std::uint64_t;
+
+    static constexpr int CATEGORY_SHIFT = 20;
+    static constexpr int SUIT_STRIDE = 16;
+    static constexpr std::uint32_t RANK_BITS = 0x1FFF;
+
+    static int cardIndex(const Card &card);
+
+    static Card cardFromIndex(int index);
+
+    static CardMask cardBit(const Card &card);
+
+    static CardMask cardBit(int index);
+
+    static CardMask toMask(const std::vector<Card> &cards);
+
+    static int evaluate(CardMask cards);
+
+    static int evaluate(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards);
+
+    static int evaluateFive(CardMask cards);
+
+    static void evaluateFiveBatch(std::span<const CardMask> hands, std::span<int> scores);
+
+    static int evaluateOmaha(CardMask holeCards, CardMask board);
+
+    static constexpr int MAX_OMAHA_COMBINATIONS = 60;
+
+    static Category categoryOf(int score);
+
+    static const char *categoryName(Category category);
+};
+#endif
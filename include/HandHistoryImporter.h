@@ -0,0 +1,66 @@
+﻿#ifndef HAND_HISTORY_IMPORTER_H
+#define HAND_HISTORY_IMPORTER_H
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "HandEvaluator.h"
+#include "Player.h"
+
+class HandHistoryImporter {
+public:
+    struct Seat {
+        std::string_view name;
+        int number;
+        int chips;
+        HandEvaluator::CardMask holeCards;
+        int committed;
+        int collected;
+    };
+
+    struct Action {
+        int seat;
+        Player::Action action;
+        int amount;
+        int pot;
+        int street;
+        bool allIn;
+    };
+
+    struct Hand {
+        std::uint64_t id;
+        int smallBlind;
+        int bigBlind;
+        int button;
+        HandEvaluator::CardMask board;
+        std::vector<Seat> seats;
+        std::vector<Action> actions;
+
+        void clear();
+
+        int seatIndex(int number) const;
+    };
+
+    struct Stats {
+        std::size_t files;
+        std::uint64_t bytes;
+        std::uint64_t hands;
+        std::uint64_t skipped;
+        std::uint64_t actions;
+        double seconds;
+    };
+
+    using HandHandler = std::function<void(const Hand &hand, int thread)>;
+
+    static constexpr std::size_t MAX_SEATS = 10;
+    static constexpr std::uint64_t CHUNK_BYTES = 4 << 20;
+
+    static Stats import(const std::vector<std::string> &paths, int threads, const HandHandler &onHand);
+
+    static bool parse(std::string_view text, Hand &hand);
+
+    static std::size_t findDelimiter(std::string_view text, std::size_t from);
+};
+#endif
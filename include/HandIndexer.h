@@ -0,0 +1,68 @@
+﻿#ifndef HAND_INDEXER_H
+#define HAND_INDEXER_H
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Card.h"
+#include "HandEvaluator.h"
+
+class HandIndexer {
+public:
+    using Index = std::uint64_t;
+
+    static constexpr int SUITS = 4;
+    static constexpr int RANKS = 13;
+    static constexpr std::size_t MAX_ROUNDS = 8;
+
+    explicit HandIndexer(std::vector<int> cardsPerRound);
+
+    static const HandIndexer &forStreet(int street);
+
+    static const HandIndexer &flops();
+
+    int getRounds() const;
+
+    int getCardsThrough(int round) const;
+
+    Index getSize(int round) const;
+
+    Index index(std::span<const Card> holeCards, std::span<const Card> communityCards = {}) const;
+
+    Index index(std::span<const HandEvaluator::CardMask> rounds) const;
+
+    std::vector<Card> unindex(int round, Index index) const;
+
+    void unindex(int round, Index index, std::span<HandEvaluator::CardMask> rounds) const;
+
+private:
+    using Configuration = std::array<std::uint32_t, SUITS>;
+
+    struct Round {
+        int cards;
+        int start;
+        Index size;
+        std::vector<Configuration> configurations;
+        std::vector<std::array<Index, SUITS> > suitSizes;
+        std::vector<std::uint32_t> equalSuits;
+        std::vector<Index> offsets;
+        std::vector<std::uint32_t> permutationToConfiguration;
+        std::vector<std::array<std::uint8_t, SUITS> > permutationToSuits;
+    };
+
+    std::vector<Round> rounds_;
+
+    template<typename Observe>
+    void enumerate(int round, int remaining, int suit, std::array<int, SUITS> &used, Configuration &counts,
+                   bool canonical, std::uint32_t equal, Observe &observe) const;
+
+    void tabulateConfiguration(int round, const Configuration &configuration);
+
+    void tabulatePermutation(int round, const Configuration &counts);
+
+    std::size_t permutationIndex(const Configuration &counts, int round) const;
+
+    std::uint32_t nibble(std::uint32_t configuration, int round) const;
+};
+#endif
@@ -0,0 +1,23 @@
+﻿#ifndef HAND_ODDS_H
+#define HAND_ODDS_H
+#include <array>
+#include <cstdint>
+
+#include "HandEvaluator.h"
+
+class HandOdds {
+public:
+    struct Report {
+        HandEvaluator::Category category;
+        std::array<int, 9> outs;
+        int totalOuts;
+        double equity;
+        bool exact;
+        std::uint64_t showdowns;
+    };
+
+    static Report analyze(HandEvaluator::CardMask holeCards, HandEvaluator::CardMask board, int samples = 2000);
+
+    static double potOdds(int toCall, int pot);
+};
+#endif
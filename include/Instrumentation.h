@@ -0,0 +1,103 @@
+﻿#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class Instrumentation {
+public:
+    enum class Phase {
+        HAND, SHUFFLE, DEAL, PREFLOP, FLOP, TURN, RIVER, SHOWDOWN, DECISION
+    };
+
+    enum class Counter { FOLDS, CHECKS, CALLS, RAISES };
+
+    static constexpr int PHASES = 9;
+    static constexpr int COUNTERS = 4;
+    static constexpr std::uint32_t SAMPLE_PERIOD = 8;
+
+    struct Summary {
+        Phase phase;
+        std::uint64_t count;
+        double p50;
+        double p99;
+        double p999;
+        double max;
+    };
+
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(const Phase phase) : phase_(phase), started_(sampled(phase) ? ticks() : 0) {
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        ~ScopedTimer() {
+            if (started_ != 0) {
+                record(phase_, ticks() - started_, SAMPLE_PERIOD);
+            }
+        }
+
+    private:
+        Phase phase_;
+        std::uint64_t started_;
+    };
+
+    static std::uint64_t ticks();
+
+    static bool sampled(Phase phase);
+
+    static void record(Phase phase, std::uint64_t elapsedTicks, std::uint64_t weight = 1);
+
+    static void count(Counter counter, std::uint64_t amount = 1);
+
+    static std::vector<Summary> summarize();
+
+    static std::array<std::uint64_t, COUNTERS> counters();
+
+    static void reset();
+
+    static Phase streetPhase(int street);
+
+    static const char *phaseName(Phase phase);
+
+    static const char *counterName(Counter counter);
+};
+
+inline std::uint64_t Instrumentation::ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline bool Instrumentation::sampled(const Phase phase) {
+    thread_local std::array<std::uint32_t, PHASES> countdown{};
+    auto &remaining = countdown[static_cast<std::size_t>(phase)];
+    if (remaining == 0) {
+        remaining = SAMPLE_PERIOD - 1;
+        return true;
+    }
+    remaining--;
+    return false;
+}
+
+#ifdef POKER_INSTRUMENT
+#define POKER_INSTRUMENT_CONCAT_(a, b) a##b
+#define POKER_INSTRUMENT_CONCAT(a, b) POKER_INSTRUMENT_CONCAT_(a, b)
+#define POKER_TIME_SCOPE(phase) \
+    const Instrumentation::ScopedTimer POKER_INSTRUMENT_CONCAT(scopedTimer, __LINE__)(phase)
+#define POKER_COUNT(counter) Instrumentation::count(counter)
+#else
+#define POKER_TIME_SCOPE(phase)
+#define POKER_COUNT(counter)
+#endif
+#endif
@@ -0,0 +1,69 @@
+﻿#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Leaderboard {
+public:
+    struct Entry {
+        std::string name;
+        int chips;
+    };
+
+    Leaderboard();
+
+    Leaderboard(const Leaderboard &) = delete;
+
+    Leaderboard &operator=(const Leaderboard &) = delete;
+
+    void update(const std::string &name, int chips);
+
+    bool remove(const std::string &name);
+
+    std::optional<std::size_t> rankOf(const std::string &name) const;
+
+    std::vector<Entry> top(std::size_t count) const;
+
+    std::size_t size() const;
+
+    void clear();
+
+private:
+    static constexpr int NIL = -1;
+
+    struct Node {
+        std::string name;
+        int chips;
+        std::uint32_t priority;
+        int left;
+        int right;
+        std::uint32_t size;
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::vector<Node> nodes_;
+    std::vector<int> freeNodes_;
+    std::unordered_map<std::string, int> index_;
+    std::mt19937 rng_;
+    int root_;
+
+    bool precedes(int a, int b) const;
+
+    std::uint32_t sizeOf(int node) const;
+
+    void pull(int node);
+
+    int merge(int left, int right);
+
+    std::pair<int, int> split(int tree, int key);
+
+    int insert(int tree, int node);
+
+    int erase(int tree, int node);
+};
+#endif
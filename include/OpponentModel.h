@@ -0,0 +1,65 @@
+﻿#ifndef OPPONENT_MODEL_H
+#define OPPONENT_MODEL_H
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "HandEvaluator.h"
+#include "Player.h"
+
+class OpponentModelStore {
+public:
+    static constexpr int STREETS = 4;
+    static constexpr int ACTIONS = 4;
+    static constexpr int SIZE_BUCKETS = 4;
+    static constexpr int CATEGORIES = 9;
+
+    struct Model {
+        std::uint64_t id;
+        std::uint32_t lastUpdate;
+        std::array<std::array<std::array<std::uint16_t, SIZE_BUCKETS>, ACTIONS>, STREETS> actions;
+        std::array<std::uint16_t, CATEGORIES> showdowns;
+
+        int actionCount(int street, Player::Action action) const;
+
+        double looseness(int street) const;
+
+        double aggression(int street) const;
+
+        double showdownStrength() const;
+    };
+
+    explicit OpponentModelStore(std::size_t capacity = 256);
+
+    Model &modelFor(std::string_view playerName);
+
+    const Model *find(std::string_view playerName) const;
+
+    const Model *find(std::uint64_t id) const;
+
+    void recordAction(std::string_view playerName, Player::Action action, int amount, int pot, int street);
+
+    void recordShowdown(std::string_view playerName, HandEvaluator::Category category);
+
+    void merge(const OpponentModelStore &other);
+
+    static std::uint64_t idOf(std::string_view playerName);
+
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+    std::size_t memoryFootprint() const;
+
+private:
+    static constexpr std::size_t PROBE_LIMIT = 8;
+
+    std::vector<Model> slots_;
+    std::size_t mask_;
+    std::size_t used_;
+    std::uint32_t clock_;
+
+    Model &slotFor(std::uint64_t id);
+};
+#endif
@@ -5,11 +5,29 @@
 
 #include "Card.h"
 #include "ChipPool.h"
+#include "Task.h"
+
+class TableScheduler;
 
 class Player {
 public:
     enum class Action { FOLD, CHECK, CALL, RAISE };
 
+    struct Decision {
+        Action action;
+        int raiseAmount;
+    };
+
+    struct DecisionView {
+        int currentBet;
+        int chipsCommitted;
+        int pot;
+        int opponents;
+        int street;
+        const std::vector<Card> &communityCards;
+        TableScheduler *scheduler;
+    };
+
     explicit Player(std::string name, int initialChips = 1000);
 
     virtual ~Player() = default;
@@ -18,9 +36,16 @@ public:
 
     virtual int getRaiseAmount(int currentBet, int chipsCommitted) = 0;
 
+    virtual Task<Decision> decide(const DecisionView &view);
+
+    virtual void observeAction(const std::string &playerName, Action action, int amount, int pot, int street);
+
+    virtual void observeShowdown(const std::string &playerName, const std::vector<Card> &holeCards,
+                                 const std::vector<Card> &communityCards);
+
     void receiveCard(Card card);
 
-    void clearHand();
+    virtual void clearHand();
 
     bool takeChips(int amount);
 
@@ -40,6 +65,8 @@ public:
 
     bool isAllIn() const;
 
+    virtual bool isHuman() const;
+
 protected:
     std::string name_;
     ChipPool chips_;
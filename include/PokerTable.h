@@ -1,26 +1,86 @@
 ﻿#ifndef POKER_TABLE_H
 #define POKER_TABLE_H
 
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <random>
+#include <span>
+
 #include "GameManager.h"
+#include "HandArena.h"
 #include "GameSettings.h"
 #include "PotDisplay.h"
+#include "TableObserver.h"
 
 class PokerTable {
 public:
+    using PlayerFactory = std::function<std::unique_ptr<Player>(const std::string &name, int chips, bool human)>;
+
+    struct Settlement {
+        const Player *player;
+        int delta;
+    };
+
+    using SettlementHandler = std::function<void(std::span<const Settlement> settlements)>;
+
     PokerTable();
 
     void addPlayer(std::unique_ptr<Player> player);
 
     void startGame();
 
+    Task<> playHandsAsync(int maxHands);
+
+    void playHand();
+
+    void setBlinds(int smallBlind, int bigBlind, int ante = 0);
+
+    void setVariant(GameSettings::Variant variant);
+
+    void setHistoryRecorded(bool recorded);
+
+    void setSeed(std::uint32_t seed);
+
+    std::unique_ptr<Player> takePlayer(std::size_t seat);
+
+    std::vector<std::unique_ptr<Player> > takeBustedPlayers();
+
+    const std::vector<std::unique_ptr<Player> > &getPlayers() const;
+
+    void setSettlementHandler(SettlementHandler handler);
+
+    void setObserver(TableObserver *observer);
+
+    void setCheckpointPath(std::string path);
+
+    std::vector<std::uint8_t> saveCheckpoint() const;
+
+    bool restoreCheckpoint(std::span<const std::uint8_t> payload, const PlayerFactory &factory);
+
 private:
+    friend class PokerTableBench;
+    friend class EvaluatorHarness;
+
     std::vector<std::unique_ptr<Player> > players_;
     std::vector<Card> deck_;
     std::vector<Card> communityCards_;
+    std::mt19937 rng_;
+    HandArena arena_;
     int pot_;
+    std::vector<int> contributed_;
+    int smallBlind_;
+    int bigBlind_;
+    int ante_;
+    std::size_t button_;
     PotDisplay potDisplay_;
     GameManager gameManager_;
     GameSettings gameSettings_;
+    SettlementHandler onSettlement_;
+    TableObserver *observer_;
+    std::vector<Settlement> settlements_;
+    std::string checkpointPath_;
+    bool restored_;
 
     void showWelcomeScreen();
 
@@ -30,16 +90,33 @@ private:
 
     void dealHoleCards();
 
-    static int evaluateHandStrength(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards);
+    static int evaluateHandStrength(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards,
+                                    std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
     void determineWinner();
 
-    void awardPot(const std::vector<bool> &folded) const;
+    void awardShare(bool mainPot, bool onlyPot, int eligible, int amount, std::span<const int> winners);
 
-    bool bettingRound();
+    void awardPot(const std::pmr::vector<bool> &folded) const;
 
-    void playHand();
+    int postForcedBet(std::size_t seat, int amount);
+
+    Task<bool> bettingRoundAsync(std::pmr::vector<int> chipsCommitted, int currentBet, int startPlayer);
+
+    int currentStreet() const;
+
+    void notifyAction(int seat, Player::Action action, int amount, int pot) const;
+
+    Task<> playHandAsync();
+
+    void recordStacks();
+
+    void settleHand();
+
+    void removeBustedPlayers();
 
     void showCommunityCards() const;
+
+    void notifyStreet() const;
 };
 #endif
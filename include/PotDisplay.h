@@ -2,6 +2,8 @@
 #define POT_DISPLAY_H
 #include <iostream>
 #include <memory>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include "Player.h"
@@ -28,8 +30,8 @@ public:
 
     void distributeToWinner(const std::string &playerName);
 
-    void distributeToWinners(const std::vector<int>& winnerIndices,
-                            const std::vector<std::string>& winnerNames);
+    void distributeToWinners(std::span<const int> winnerIndices,
+                            std::span<const std::string_view> winnerNames);
 
 private:
     int mainPot_;
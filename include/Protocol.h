@@ -0,0 +1,162 @@
+﻿#ifndef PROTOCOL_H
+#define PROTOCOL_H
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Player.h"
+
+class Protocol {
+public:
+    enum class MessageType : std::uint8_t {
+        JOIN = 1,
+        ACTION = 2,
+        SPECTATE = 3,
+        JOINED = 16,
+        DECISION_REQUEST = 17,
+        ACTION_NOTICE = 18,
+        CHIP_UPDATE = 19,
+        TABLE_CLOSED = 20,
+        HAND_STARTED = 21,
+        STREET_DEALT = 22,
+        SHOWDOWN = 23
+    };
+
+    static constexpr std::size_t HEADER_SIZE = 3;
+    static constexpr std::size_t MAX_PAYLOAD = 1024;
+    static constexpr std::size_t MAX_NAME = 32;
+    static constexpr std::size_t MAX_SEATS = 10;
+
+    struct Join {
+        std::uint32_t tableKey;
+        std::string name;
+    };
+
+    struct Action {
+        std::uint32_t sequence;
+        Player::Action action;
+        std::int32_t raiseAmount;
+    };
+
+    struct Spectate {
+        std::uint32_t tableKey;
+    };
+
+    struct Joined {
+        std::uint32_t tableKey;
+        std::uint8_t seat;
+    };
+
+    struct DecisionRequest {
+        std::uint32_t sequence;
+        std::int32_t currentBet;
+        std::int32_t chipsCommitted;
+        std::int32_t pot;
+        std::int32_t chipCount;
+        std::uint32_t timeLimitMs;
+        std::uint32_t timeBankMs;
+        std::uint8_t street;
+        std::uint8_t opponents;
+        std::uint8_t holeCount;
+        std::uint8_t boardCount;
+        std::array<std::uint8_t, 4> holeCards;
+        std::array<std::uint8_t, 5> board;
+    };
+
+    struct ActionNotice {
+        std::string playerName;
+        Player::Action action;
+        std::int32_t amount;
+        std::uint8_t street;
+    };
+
+    struct ChipUpdate {
+        std::int32_t chipCount;
+        std::uint32_t handsPlayed;
+    };
+
+    struct TableClosed {
+        std::int32_t chipCount;
+    };
+
+    struct SeatState {
+        std::string name;
+        std::int32_t chipCount;
+    };
+
+    struct HandStarted {
+        std::uint32_t handNumber;
+        std::uint8_t button;
+        std::int32_t pot;
+        std::vector<SeatState> seats;
+    };
+
+    struct StreetDealt {
+        std::uint8_t street;
+        std::int32_t pot;
+        std::uint8_t boardCount;
+        std::array<std::uint8_t, 5> board;
+    };
+
+    struct Showdown {
+        std::string playerName;
+        std::uint8_t holeCount;
+        std::array<std::uint8_t, 4> holeCards;
+    };
+
+    struct Frame {
+        MessageType type;
+        std::span<const std::uint8_t> payload;
+        std::size_t size;
+    };
+
+    static std::optional<Frame> nextFrame(std::span<const std::uint8_t> buffer);
+
+    static void encode(std::vector<std::uint8_t> &out, const Join &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const Action &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const Spectate &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const Joined &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const DecisionRequest &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const ActionNotice &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const ChipUpdate &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const TableClosed &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const HandStarted &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const StreetDealt &message);
+
+    static void encode(std::vector<std::uint8_t> &out, const Showdown &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, Join &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, Action &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, Spectate &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, Joined &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, DecisionRequest &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, ActionNotice &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, ChipUpdate &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, TableClosed &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, HandStarted &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, StreetDealt &message);
+
+    static bool decode(std::span<const std::uint8_t> payload, Showdown &message);
+};
+#endif
@@ -0,0 +1,38 @@
+﻿#ifndef REMOTE_PLAYER_H
+#define REMOTE_PLAYER_H
+#include <functional>
+
+#include "DecisionSlot.h"
+#include "Player.h"
+
+class RemotePlayer final : public Player {
+public:
+    using DecisionRequestHandler = std::function<void(RemotePlayer &, const DecisionView &)>;
+    using ActionObserver = std::function<void(const std::string &, Action, int, int)>;
+
+    explicit RemotePlayer(const std::string &name, int initialChips = 1000);
+
+    Action makeDecision(int currentBet, int chipsCommitted, const std::vector<Card> &communityCards) override;
+
+    int getRaiseAmount(int currentBet, int chipsCommitted) override;
+
+    Task<Decision> decide(const DecisionView &view) override;
+
+    bool isHuman() const override;
+
+    bool deliver(const Decision &decision);
+
+    bool isAwaitingDecision() const;
+
+    void setDecisionRequestHandler(DecisionRequestHandler handler);
+
+    void observeAction(const std::string &playerName, Action action, int amount, int pot, int street) override;
+
+    void setActionObserver(ActionObserver observer);
+
+private:
+    DecisionSlot slot_;
+    DecisionRequestHandler onDecisionRequest_;
+    ActionObserver onAction_;
+};
+#endif
@@ -0,0 +1,88 @@
+﻿#ifndef SCREEN_BUFFER_H
+#define SCREEN_BUFFER_H
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ScreenBuffer {
+public:
+    enum class Style : std::uint8_t {
+        NORMAL,
+        BOLD,
+        DIM,
+        RED,
+        GREEN,
+        YELLOW,
+        CYAN
+    };
+
+    ScreenBuffer(int rows, int columns);
+
+    ScreenBuffer(const ScreenBuffer &) = delete;
+
+    ScreenBuffer &operator=(const ScreenBuffer &) = delete;
+
+    ~ScreenBuffer();
+
+    int getRows() const;
+
+    int getColumns() const;
+
+    void clear();
+
+    int draw(int row, int column, std::string_view text, Style style = Style::NORMAL,
+             int maxWidth = std::numeric_limits<int>::max());
+
+    void fill(int row, int column, int width, char32_t glyph, Style style = Style::NORMAL);
+
+    void box(int row, int column, int height, int width, std::string_view title = {});
+
+    void setCursor(int row, int column, bool visible);
+
+    std::string_view compose();
+
+    void present();
+
+    void invalidate();
+
+    std::uint64_t getFramesPresented() const;
+
+    std::uint64_t getCellsWritten() const;
+
+    std::uint64_t getBytesWritten() const;
+
+    static int glyphWidth(char32_t glyph);
+
+private:
+    static constexpr char32_t CONTINUATION = 0;
+    static constexpr char32_t STALE = 0xFFFFFFFF;
+
+    struct Cell {
+        char32_t glyph;
+        Style style;
+
+        bool operator==(const Cell &) const = default;
+    };
+
+    int rows_;
+    int columns_;
+    std::vector<Cell> front_;
+    std::vector<Cell> back_;
+    std::string frame_;
+    int cursorRow_;
+    int cursorColumn_;
+    bool cursorVisible_;
+    bool cursorShown_;
+    bool cursorMoved_;
+    bool started_;
+    std::uint64_t framesPresented_;
+    std::uint64_t cellsWritten_;
+    std::uint64_t bytesWritten_;
+
+    Cell &at(int row, int column);
+
+    void put(int row, int column, char32_t glyph, Style style);
+};
+#endif
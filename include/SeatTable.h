@@ -0,0 +1,53 @@
+﻿#ifndef SEAT_TABLE_H
+#define SEAT_TABLE_H
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "HandEvaluator.h"
+
+template<std::size_t MaxSeats>
+struct SeatTable {
+    static_assert(MaxSeats >= 2 && MaxSeats <= 16, "SeatTable supports 2 to 16 seats");
+
+    using SeatMask = std::uint32_t;
+
+    static constexpr std::size_t CAPACITY = MaxSeats;
+    static constexpr SeatMask ALL_SEATS = (SeatMask{1} << MaxSeats) - 1;
+
+    std::array<int, MaxSeats> stack{};
+    std::array<int, MaxSeats> committed{};
+    std::array<int, MaxSeats> contributed{};
+    std::array<HandEvaluator::CardMask, MaxSeats> holeCards{};
+    SeatMask occupied = 0;
+    SeatMask inHand = 0;
+    SeatMask folded = 0;
+    SeatMask allIn = 0;
+    SeatMask acted = 0;
+
+    static constexpr SeatMask bit(const std::size_t seat) { return SeatMask{1} << seat; }
+
+    SeatMask live() const { return inHand & ~folded; }
+
+    SeatMask pending() const { return live() & ~allIn & ~acted; }
+
+    int liveCount() const { return std::popcount(live()); }
+
+    static std::size_t nextSeat(const SeatMask mask, const std::size_t from) {
+        const auto rotated = (mask >> from | mask << (MaxSeats - from)) & ALL_SEATS;
+        return (from + static_cast<std::size_t>(std::countr_zero(rotated))) % MaxSeats;
+    }
+
+    int pay(const std::size_t seat, const int amount) {
+        const auto paid = amount < stack[seat] ? amount : stack[seat];
+        stack[seat] -= paid;
+        committed[seat] += paid;
+        contributed[seat] += paid;
+        if (stack[seat] == 0) {
+            allIn |= bit(seat);
+        }
+        return paid;
+    }
+};
+#endif
@@ -0,0 +1,70 @@
+﻿#ifndef SHARDED_SIMULATION_H
+#define SHARDED_SIMULATION_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class ShardedSimulation {
+public:
+    struct Config {
+        std::uint64_t hands = 1000000;
+        int processes = 1;
+        int seats = 6;
+        int stack = 1000;
+        int smallBlind = 5;
+        int bigBlind = 10;
+        std::uint64_t seed = 1;
+        bool pinCores = true;
+    };
+
+    struct SeatResult {
+        std::uint64_t wins;
+        std::int64_t chipDelta;
+    };
+
+    struct Results {
+        std::uint64_t hands;
+        std::vector<SeatResult> seats;
+        double seconds;
+    };
+
+    using ProgressHandler = std::function<void(std::uint64_t handsPlayed, std::uint64_t handsTotal)>;
+
+    static constexpr int MAX_SEATS = 10;
+    static constexpr std::uint64_t BLOCK_HANDS = 1024;
+
+    explicit ShardedSimulation(Config config);
+
+    ~ShardedSimulation();
+
+    ShardedSimulation(const ShardedSimulation &) = delete;
+
+    ShardedSimulation &operator=(const ShardedSimulation &) = delete;
+
+    Results run(const ProgressHandler &onProgress = {});
+
+    std::uint64_t getHandsPlayed() const;
+
+    static std::uint64_t digest(const Results &results);
+
+private:
+    struct alignas(64) WorkerSlot {
+        std::atomic<std::uint64_t> hands;
+        std::array<std::atomic<std::uint64_t>, MAX_SEATS> wins;
+        std::array<std::atomic<std::int64_t>, MAX_SEATS> chipDeltas;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::int64_t>::is_always_lock_free,
+                  "shared counters must not depend on process-local locks");
+
+    Config config_;
+    WorkerSlot *slots_;
+    std::size_t length_;
+
+    void runWorker(int worker);
+
+    Results collect() const;
+};
+#endif
@@ -0,0 +1,323 @@
+﻿#ifndef SIMULATION_TABLE_H
+#define SIMULATION_TABLE_H
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+#include "DecisionService.h"
+#include "GameVariant.h"
+#include "HandEvaluator.h"
+#include "Player.h"
+#include "SeatTable.h"
+
+struct SeatView {
+    std::size_t seat;
+    int currentBet;
+    int committed;
+    int stack;
+    int pot;
+    int opponents;
+    int street;
+    HandEvaluator::CardMask holeCards;
+    HandEvaluator::CardMask board;
+};
+
+template<typename Derived>
+class SeatPolicy {
+public:
+    Player::Decision decide(const SeatView &view, std::mt19937_64 &rng) {
+        return static_cast<Derived &>(*this).decideSeat(view, rng);
+    }
+};
+
+class RandomPolicy : public SeatPolicy<RandomPolicy> {
+public:
+    Player::Decision decideSeat(const SeatView &view, std::mt19937_64 &rng) const {
+        const auto roll = rng() % 100;
+        if (view.currentBet > view.committed) {
+            return {roll < 70 ? Player::Action::CALL : Player::Action::FOLD, 0};
+        }
+        if (roll < 50) {
+            return {Player::Action::RAISE, view.currentBet + view.currentBet / 2 + 10};
+        }
+        return {Player::Action::CHECK, 0};
+    }
+};
+
+class StrengthPolicy : public SeatPolicy<StrengthPolicy> {
+public:
+    Player::Decision decideSeat(const SeatView &view, std::mt19937_64 &) const {
+        const DecisionService::Request request{
+            view.holeCards, view.board, view.opponents, view.currentBet, view.committed, view.stack
+        };
+        const auto result = DecisionService::chooseAction(request, estimateEquity(view));
+        return {result.action, result.raiseAmount};
+    }
+
+    static double estimateEquity(const SeatView &view) {
+        static constexpr std::array categoryStrength{0.35, 0.55, 0.7, 0.78, 0.83, 0.86, 0.93, 0.97, 0.99};
+
+        double strength;
+        if (view.board == 0) {
+            const auto low = std::countr_zero(view.holeCards);
+            const auto high = 63 - std::countl_zero(view.holeCards);
+            const auto lowRank = low % HandEvaluator::SUIT_STRIDE + 2;
+            const auto highRank = high % HandEvaluator::SUIT_STRIDE + 2;
+            strength = lowRank == highRank ? 0.5 + highRank / 28.0 : (lowRank + highRank) / 34.0;
+            if (low / HandEvaluator::SUIT_STRIDE == high / HandEvaluator::SUIT_STRIDE) {
+                strength += 0.04;
+            }
+        } else {
+            const auto category = HandEvaluator::categoryOf(HandEvaluator::evaluate(view.holeCards | view.board));
+            strength = categoryStrength[static_cast<int>(category)];
+        }
+        return std::pow(std::min(strength, 0.99), std::sqrt(static_cast<double>(std::max(1, view.opponents))));
+    }
+};
+
+template<std::size_t MaxSeats, typename Policy, typename Variant = HoldemVariant>
+class SimulationTable {
+public:
+    using Seats = SeatTable<MaxSeats>;
+
+    SimulationTable(int seats, int startingStack, std::uint64_t seed, Policy policy = Policy());
+
+    void setBlinds(int smallBlind, int bigBlind, int ante = 0);
+
+    void playHand();
+
+    void refill(int stack);
+
+    const Seats &getSeats() const;
+
+    std::uint64_t getHandsPlayed() const;
+
+    std::uint64_t getDecisions() const;
+
+private:
+    Seats seats_;
+    Policy policy_;
+    std::mt19937_64 rng_;
+    std::array<int, Variant::DECK_SIZE> deck_;
+    std::size_t dealt_;
+    std::size_t button_;
+    int pot_;
+    int smallBlind_;
+    int bigBlind_;
+    int ante_;
+    std::uint64_t handsPlayed_;
+    std::uint64_t decisions_;
+
+    HandEvaluator::CardMask draw();
+
+    bool bettingRound(int currentBet, std::size_t start, int street, HandEvaluator::CardMask board);
+
+    void showdown(HandEvaluator::CardMask board);
+};
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+SimulationTable<MaxSeats, Policy, Variant>::SimulationTable(const int seats, const int startingStack,
+                                                            const std::uint64_t seed, Policy policy)
+    : policy_(std::move(policy)), rng_(seed), deck_(Variant::DECK), dealt_(0), button_(0), pot_(0), smallBlind_(5),
+      bigBlind_(10), ante_(0), handsPlayed_(0), decisions_(0) {
+    for (std::size_t seat = 0; seat < std::min<std::size_t>(seats, MaxSeats); seat++) {
+        seats_.occupied |= Seats::bit(seat);
+        seats_.stack[seat] = startingStack;
+    }
+}
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+void SimulationTable<MaxSeats, Policy, Variant>::setBlinds(const int smallBlind, const int bigBlind,
+                                                            const int ante) {
+    smallBlind_ = smallBlind;
+    bigBlind_ = bigBlind;
+    ante_ = ante;
+}
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+void SimulationTable<MaxSeats, Policy, Variant>::refill(const int stack) {
+    for (auto mask = seats_.occupied; mask; mask &= mask - 1) {
+        if (const auto seat = static_cast<std::size_t>(std::countr_zero(mask)); seats_.stack[seat] == 0) {
+            seats_.stack[seat] = stack;
+        }
+    }
+}
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+const SeatTable<MaxSeats> &SimulationTable<MaxSeats, Policy, Variant>::getSeats() const { return seats_; }
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+std::uint64_t SimulationTable<MaxSeats, Policy, Variant>::getHandsPlayed() const { return handsPlayed_; }
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+std::uint64_t SimulationTable<MaxSeats, Policy, Variant>::getDecisions() const { return decisions_; }
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+HandEvaluator::CardMask SimulationTable<MaxSeats, Policy, Variant>::draw() {
+    const auto pick = dealt_ + rng_() % (deck_.size() - dealt_);
+    std::swap(deck_[dealt_], deck_[pick]);
+    return HandEvaluator::cardBit(deck_[dealt_++]);
+}
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+void SimulationTable<MaxSeats, Policy, Variant>::playHand() {
+    seats_.inHand = 0;
+    for (auto mask = seats_.occupied; mask; mask &= mask - 1) {
+        if (const auto seat = static_cast<std::size_t>(std::countr_zero(mask)); seats_.stack[seat] > 0) {
+            seats_.inHand |= Seats::bit(seat);
+        }
+    }
+    if (std::popcount(seats_.inHand) < 2) {
+        return;
+    }
+
+    handsPlayed_++;
+    seats_.folded = 0;
+    seats_.allIn = 0;
+    seats_.committed.fill(0);
+    seats_.contributed.fill(0);
+    pot_ = 0;
+    dealt_ = 0;
+    button_ = Seats::nextSeat(seats_.inHand, (button_ + 1) % MaxSeats);
+
+    for (auto mask = seats_.inHand; mask; mask &= mask - 1) {
+        const auto seat = static_cast<std::size_t>(std::countr_zero(mask));
+        seats_.holeCards[seat] = 0;
+        for (auto card = 0; card < Variant::HOLE_CARDS; card++) {
+            seats_.holeCards[seat] |= draw();
+        }
+        pot_ += seats_.pay(seat, ante_);
+    }
+    seats_.committed.fill(0);
+
+    const auto small = std::popcount(seats_.inHand) == 2
+                           ? button_
+                           : Seats::nextSeat(seats_.inHand, (button_ + 1) % MaxSeats);
+    const auto big = Seats::nextSeat(seats_.inHand, (small + 1) % MaxSeats);
+    pot_ += seats_.pay(small, smallBlind_);
+    pot_ += seats_.pay(big, bigBlind_);
+
+    HandEvaluator::CardMask board = 0;
+    auto contested = bettingRound(bigBlind_, (big + 1) % MaxSeats, 0, board);
+    for (auto street = 1; contested && street <= 3; street++) {
+        for (auto card = street == 1 ? 3 : 1; card > 0; card--) {
+            board |= draw();
+        }
+        seats_.committed.fill(0);
+        contested = bettingRound(0, (button_ + 1) % MaxSeats, street, board);
+    }
+
+    if (contested) {
+        showdown(board);
+    } else {
+        seats_.stack[static_cast<std::size_t>(std::countr_zero(seats_.live()))] += pot_;
+    }
+}
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+bool SimulationTable<MaxSeats, Policy, Variant>::bettingRound(int currentBet, const std::size_t start,
+                                                              const int street,
+                                                              const HandEvaluator::CardMask board) {
+    seats_.acted = 0;
+    auto seat = start;
+    while (seats_.liveCount() > 1) {
+        const auto pending = seats_.pending();
+        if (!pending) {
+            return true;
+        }
+        seat = Seats::nextSeat(pending, seat);
+
+        const SeatView view{
+            seat, currentBet, seats_.committed[seat], seats_.stack[seat], pot_, seats_.liveCount() - 1, street,
+            seats_.holeCards[seat], board
+        };
+        auto [action, raiseAmount] = policy_.decide(view, rng_);
+        decisions_++;
+
+        const auto owed = currentBet - seats_.committed[seat];
+        if (action == Player::Action::CHECK && owed > 0) {
+            action = Player::Action::FOLD;
+        } else if (action == Player::Action::RAISE && raiseAmount <= currentBet) {
+            action = owed > 0 ? Player::Action::CALL : Player::Action::CHECK;
+        }
+
+        switch (action) {
+            case Player::Action::FOLD:
+                seats_.folded |= Seats::bit(seat);
+                break;
+            case Player::Action::CHECK:
+                break;
+            case Player::Action::CALL:
+                pot_ += seats_.pay(seat, owed);
+                break;
+            case Player::Action::RAISE:
+                pot_ += seats_.pay(seat, raiseAmount - seats_.committed[seat]);
+                if (seats_.committed[seat] > currentBet) {
+                    currentBet = seats_.committed[seat];
+                    seats_.acted = 0;
+                }
+                break;
+        }
+        seats_.acted |= Seats::bit(seat);
+        seat = (seat + 1) % MaxSeats;
+    }
+    return false;
+}
+
+template<std::size_t MaxSeats, typename Policy, typename Variant>
+void SimulationTable<MaxSeats, Policy, Variant>::showdown(const HandEvaluator::CardMask board) {
+    std::array<int, MaxSeats> scores{};
+    for (auto mask = seats_.live(); mask; mask &= mask - 1) {
+        const auto seat = static_cast<std::size_t>(std::countr_zero(mask));
+        scores[seat] = Variant::evaluate(seats_.holeCards[seat] | board);
+    }
+
+    auto remaining = pot_;
+    auto previous = 0;
+    typename Seats::SeatMask winners = 0;
+    while (remaining > 0) {
+        auto cap = previous;
+        for (auto mask = seats_.live(); mask; mask &= mask - 1) {
+            const auto contributed = seats_.contributed[static_cast<std::size_t>(std::countr_zero(mask))];
+            if (contributed > previous && (cap == previous || contributed < cap)) {
+                cap = contributed;
+            }
+        }
+        if (cap == previous) {
+            break;
+        }
+
+        auto amount = 0;
+        for (auto mask = seats_.inHand; mask; mask &= mask - 1) {
+            const auto contributed = seats_.contributed[static_cast<std::size_t>(std::countr_zero(mask))];
+            amount += std::clamp(contributed, previous, cap) - previous;
+        }
+        auto best = -1;
+        winners = 0;
+        for (auto mask = seats_.live(); mask; mask &= mask - 1) {
+            const auto seat = static_cast<std::size_t>(std::countr_zero(mask));
+            if (seats_.contributed[seat] < cap) continue;
+            if (scores[seat] > best) {
+                best = scores[seat];
+                winners = Seats::bit(seat);
+            } else if (scores[seat] == best) {
+                winners |= Seats::bit(seat);
+            }
+        }
+
+        const auto share = amount / std::popcount(winners);
+        for (auto mask = winners; mask; mask &= mask - 1) {
+            seats_.stack[static_cast<std::size_t>(std::countr_zero(mask))] += share;
+        }
+        seats_.stack[static_cast<std::size_t>(std::countr_zero(winners))] += amount - share * std::popcount(winners);
+        remaining -= amount;
+        previous = cap;
+    }
+    if (remaining > 0 && winners) {
+        seats_.stack[static_cast<std::size_t>(std::countr_zero(winners))] += remaining;
+    }
+}
+#endif
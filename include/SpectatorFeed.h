@@ -0,0 +1,49 @@
+﻿#ifndef SPECTATOR_FEED_H
+#define SPECTATOR_FEED_H
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+class SpectatorFeed {
+public:
+    using Buffer = std::shared_ptr<const std::vector<std::uint8_t> >;
+
+    static constexpr std::size_t HISTORY = 256;
+
+    struct Cursor {
+        std::uint64_t sequence = 0;
+        std::size_t offset = 0;
+        Buffer partial;
+        bool resync = false;
+        std::uint64_t dropped = 0;
+    };
+
+    SpectatorFeed();
+
+    void publish(Buffer buffer, bool keyframe);
+
+    Cursor subscribe() const;
+
+    std::size_t gather(Cursor &cursor, std::span<std::span<const std::uint8_t> > out) const;
+
+    void consume(Cursor &cursor, std::size_t bytes) const;
+
+    bool hasPending(const Cursor &cursor) const;
+
+    std::uint64_t getPublished() const;
+
+private:
+    static constexpr auto NO_KEYFRAME = ~std::uint64_t{0};
+
+    std::array<Buffer, HISTORY> ring_;
+    std::array<bool, HISTORY> keyframes_;
+    std::uint64_t head_;
+    std::uint64_t lastKeyframe_;
+
+    bool retained(std::uint64_t sequence) const;
+
+    void catchUp(Cursor &cursor) const;
+};
+#endif
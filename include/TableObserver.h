@@ -0,0 +1,22 @@
+﻿#ifndef TABLE_OBSERVER_H
+#define TABLE_OBSERVER_H
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Card.h"
+#include "Player.h"
+
+class TableObserver {
+public:
+    virtual ~TableObserver() = default;
+
+    virtual void onHandStarted(const std::vector<std::unique_ptr<Player> > &players, std::size_t button, int pot) = 0;
+
+    virtual void onAction(const std::string &playerName, Player::Action action, int amount, int pot, int street) = 0;
+
+    virtual void onStreet(int street, const std::vector<Card> &communityCards, int pot) = 0;
+
+    virtual void onShowdown(const std::string &playerName, const std::vector<Card> &holeCards) = 0;
+};
+#endif
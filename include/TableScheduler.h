@@ -0,0 +1,43 @@
+﻿#ifndef TABLE_SCHEDULER_H
+#define TABLE_SCHEDULER_H
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "Task.h"
+
+class TableScheduler {
+public:
+    TableScheduler();
+
+    TableScheduler(const TableScheduler &) = delete;
+
+    TableScheduler &operator=(const TableScheduler &) = delete;
+
+    void spawn(Task<> task);
+
+    void post(std::coroutine_handle<> handle);
+
+    void setNotifier(std::function<void()> notifier);
+
+    bool runOnce(bool block);
+
+    void run();
+
+    std::size_t getActiveTasks() const;
+
+    static TableScheduler *current();
+
+private:
+    std::vector<Task<> > tasks_;
+    std::vector<std::coroutine_handle<> > ready_;
+    std::vector<std::coroutine_handle<> > incoming_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::function<void()> notifier_;
+
+    void reapFinished();
+};
+#endif
@@ -0,0 +1,60 @@
+﻿#ifndef TABLE_SCREEN_H
+#define TABLE_SCREEN_H
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ScreenBuffer.h"
+#include "TableObserver.h"
+
+class TableScreen final : public TableObserver, private std::streambuf {
+public:
+    explicit TableScreen(int rows = 24, int columns = 80);
+
+    ~TableScreen() override;
+
+    TableScreen(const TableScreen &) = delete;
+
+    TableScreen &operator=(const TableScreen &) = delete;
+
+    void onHandStarted(const std::vector<std::unique_ptr<Player> > &players, std::size_t button, int pot) override;
+
+    void onAction(const std::string &playerName, Player::Action action, int amount, int pot, int street) override;
+
+    void onStreet(int street, const std::vector<Card> &communityCards, int pot) override;
+
+    void onShowdown(const std::string &playerName, const std::vector<Card> &holeCards) override;
+
+    static bool isTerminal();
+
+private:
+    static constexpr std::size_t LOG_LINES = 64;
+
+    ScreenBuffer screen_;
+    std::streambuf *previous_;
+    const std::vector<std::unique_ptr<Player> > *players_;
+    std::unordered_map<std::string, std::string> lastActions_;
+    std::string board_;
+    std::deque<std::string> log_;
+    std::string line_;
+    std::size_t button_;
+    int handNumber_;
+    int pot_;
+    bool awaitingInput_;
+    bool rendering_;
+
+    int_type overflow(int_type ch) override;
+
+    std::streamsize xsputn(const char *text, std::streamsize count) override;
+
+    int sync() override;
+
+    void append(char ch);
+
+    void render();
+};
+#endif
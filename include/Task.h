@@ -0,0 +1,142 @@
+﻿#ifndef TASK_H
+#define TASK_H
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "FramePool.h"
+
+template<typename T>
+class Task;
+
+namespace detail {
+    struct TaskPromiseBase {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+
+            template<typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                if (const auto continuation = handle.promise().continuation) {
+                    return continuation;
+                }
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        static void *operator new(const std::size_t size) { return FramePool::allocate(size); }
+
+        static void operator delete(void *frame, const std::size_t size) noexcept {
+            FramePool::deallocate(frame, size);
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    template<typename T>
+    struct TaskPromise : TaskPromiseBase {
+        std::optional<T> value;
+
+        Task<T> get_return_object();
+
+        void return_value(T result) { value.emplace(std::move(result)); }
+
+        T take() {
+            if (exception) std::rethrow_exception(exception);
+            return std::move(*value);
+        }
+    };
+
+    template<>
+    struct TaskPromise<void> : TaskPromiseBase {
+        Task<void> get_return_object();
+
+        void return_void() const noexcept {
+        }
+
+        void take() const {
+            if (exception) std::rethrow_exception(exception);
+        }
+    };
+}
+
+template<typename T = void>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+
+    explicit Task(const Handle handle) : handle_(handle) {
+    }
+
+    Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {
+    }
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+
+    Task &operator=(const Task &) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+    std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().take(); }
+
+    void start() const { handle_.resume(); }
+
+    bool done() const { return !handle_ || handle_.done(); }
+
+    T result() { return handle_.promise().take(); }
+
+    Handle handle() const { return handle_; }
+
+private:
+    Handle handle_ = nullptr;
+};
+
+template<typename T>
+Task<T> detail::TaskPromise<T>::get_return_object() {
+    return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+inline Task<void> detail::TaskPromise<void>::get_return_object() {
+    return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+template<typename T>
+T runSync(Task<T> task) {
+    task.start();
+    if (!task.done()) {
+        throw std::logic_error("task suspended outside of a TableScheduler");
+    }
+    return task.result();
+}
+#endif
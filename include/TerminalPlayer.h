@@ -6,11 +6,23 @@
 
 class TerminalPlayer final : public Player {
 public:
-    explicit TerminalPlayer(const std::string &name, int initialChips = 1000);
+    explicit TerminalPlayer(const std::string &name, int initialChips = 1000, bool showHud = false);
 
     Action makeDecision(int currentBet, int chipsCommitted,
                         const std::vector<Card> &communityCards) override;
 
     int getRaiseAmount(int currentBet, int _) override;
+
+    Task<Decision> decide(const DecisionView &view) override;
+
+    bool isHuman() const override;
+
+    void setPot(int pot);
+
+private:
+    bool showHud_;
+    int pot_;
+
+    void displayHud(int toCall, const std::vector<Card> &communityCards) const;
 };
 #endif
@@ -0,0 +1,77 @@
+﻿#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class Timer {
+    public:
+        Timer();
+
+        explicit Timer(std::function<void()> callback);
+
+        ~Timer();
+
+        Timer(const Timer &) = delete;
+
+        Timer &operator=(const Timer &) = delete;
+
+        void setCallback(std::function<void()> callback);
+
+        bool isArmed() const;
+
+    private:
+        friend class TimerWheel;
+
+        Timer *next_;
+        Timer **link_;
+        TimerWheel *wheel_;
+        std::uint64_t expiry_;
+        std::uint8_t level_;
+        std::uint8_t slot_;
+        std::function<void()> callback_;
+    };
+
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(1),
+                        Clock::time_point start = Clock::now());
+
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel &) = delete;
+
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    void schedule(Timer &timer, std::chrono::milliseconds delay);
+
+    void cancel(Timer &timer);
+
+    std::size_t advance(Clock::time_point now);
+
+    int nextTimeoutMs(Clock::time_point now) const;
+
+    std::size_t size() const;
+
+private:
+    std::chrono::milliseconds tick_;
+    Clock::time_point start_;
+    std::uint64_t current_;
+    std::size_t armed_;
+    std::array<std::array<Timer *, SLOTS>, LEVELS> slots_;
+    std::array<std::uint64_t, LEVELS> occupied_;
+
+    void insert(Timer &timer);
+
+    void unlink(Timer &timer);
+
+    void cascade(int level);
+};
+#endif
@@ -0,0 +1,145 @@
+﻿#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Leaderboard.h"
+#include "PokerTable.h"
+
+class DecisionService;
+class HandAbstraction;
+
+class Tournament {
+public:
+    struct BlindLevel {
+        int smallBlind;
+        int bigBlind;
+        int ante;
+    };
+
+    struct Config {
+        int entrants = 10000;
+        int seatsPerTable = 9;
+        int startingStack = 10000;
+        int buyIn = 100;
+        int workers = 1;
+        int handsPerLevel = 10;
+        double paidFraction = 0.15;
+        GameSettings::Variant variant = GameSettings::Variant::TEXAS_HOLDEM;
+        std::vector<BlindLevel> blindSchedule;
+        bool decisionService = false;
+        std::string abstractionPath;
+    };
+
+    struct Finish {
+        std::string name;
+        int place;
+        int prize;
+    };
+
+    struct TableView {
+        int id;
+        int handsPlayed;
+        BlindLevel blinds;
+        std::vector<Leaderboard::Entry> seats;
+    };
+
+    explicit Tournament(Config config);
+
+    Tournament(const Tournament &) = delete;
+
+    Tournament &operator=(const Tournament &) = delete;
+
+    void run();
+
+    std::vector<Finish> getResults() const;
+
+    std::uint64_t getHandsPlayed() const;
+
+    std::uint64_t getTableMoves() const;
+
+    std::uint64_t getTablesBroken() const;
+
+    std::uint64_t getAllocatingHands() const;
+
+    int getTablesOpened() const;
+
+    int getPrizePool() const;
+
+    const Leaderboard &getStandings() const;
+
+    std::vector<TableView> getTableViews(std::size_t count) const;
+
+    static std::vector<BlindLevel> defaultBlindSchedule(int startingStack);
+
+    static std::vector<int> payoutTable(int entrants, int prizePool, double paidFraction);
+
+private:
+    static constexpr int WARMUP_HANDS = 64;
+
+    struct Table {
+        int id;
+        PokerTable poker;
+        std::vector<std::unique_ptr<Player> > inbox;
+        std::vector<Leaderboard::Entry> seats;
+        int seated = 0;
+        int handsPlayed = 0;
+        bool parked = false;
+        bool broken = false;
+    };
+
+    Config config_;
+    std::shared_ptr<DecisionService> decisionService_;
+    std::shared_ptr<const HandAbstraction> abstraction_;
+    std::vector<std::unique_ptr<Table> > tables_;
+    std::vector<int> payouts_;
+    Leaderboard standings_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Table *> readyTables_;
+    std::set<std::pair<int, int> > openTables_;
+    std::vector<Finish> finishes_;
+    int remaining_;
+    int activeTables_;
+    bool finished_;
+
+    std::atomic<std::uint64_t> handsPlayed_;
+    std::atomic<std::uint64_t> tableMoves_;
+    std::atomic<std::uint64_t> tablesBroken_;
+    std::atomic<std::uint64_t> allocatingHands_;
+
+    void seatEntrants();
+
+    void workerLoop();
+
+    void finishHand(Table &table, const std::vector<std::pair<const Player *, int> > &startingStacks);
+
+    void recordFinish(const Player &player);
+
+    const BlindLevel &levelOf(const Table &table) const;
+
+    void applyLevel(Table &table) const;
+
+    static void snapshotSeats(Table &table);
+
+    void breakTable(Table &table);
+
+    void balanceFrom(Table &table);
+
+    void moveSeat(std::unique_ptr<Player> player, Table &from, Table &to);
+
+    void resize(Table &table, int seated);
+
+    Table *shortestTable(const Table &exclude) const;
+
+    static void absorbInbox(Table &table);
+};
+#endif
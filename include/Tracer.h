@@ -0,0 +1,79 @@
+﻿#ifndef TRACER_H
+#define TRACER_H
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+class Tracer {
+public:
+    static constexpr std::size_t RING_CAPACITY = std::size_t{1} << 16;
+    static constexpr std::int32_t NO_ARGUMENT = -1;
+
+    class Scope {
+    public:
+        explicit Scope(const char *name, const std::int32_t argument = NO_ARGUMENT) : name_(name) {
+            begin(name, argument);
+        }
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope() { end(name_); }
+
+    private:
+        const char *name_;
+    };
+
+    class AsyncScope {
+    public:
+        AsyncScope(const char *name, const void *track, const std::int32_t argument = NO_ARGUMENT)
+            : name_(name), id_(reinterpret_cast<std::uintptr_t>(track)) {
+            beginAsync(name, id_, argument);
+        }
+
+        AsyncScope(const AsyncScope &) = delete;
+
+        AsyncScope &operator=(const AsyncScope &) = delete;
+
+        ~AsyncScope() { endAsync(name_, id_); }
+
+    private:
+        const char *name_;
+        std::uint64_t id_;
+    };
+
+    static void begin(const char *name, std::int32_t argument = NO_ARGUMENT);
+
+    static void end(const char *name);
+
+    static void beginAsync(const char *name, std::uint64_t id, std::int32_t argument = NO_ARGUMENT);
+
+    static void endAsync(const char *name, std::uint64_t id);
+
+    static void setThreadName(const char *name);
+
+    static std::size_t dump(std::ostream &out);
+
+    static std::size_t dump(const std::string &path);
+
+    static void requestDump();
+
+    static bool takeDumpRequest();
+
+    static const char *streetName(int street);
+};
+
+#ifdef POKER_TRACE
+#define POKER_TRACE_CONCAT_(a, b) a##b
+#define POKER_TRACE_CONCAT(a, b) POKER_TRACE_CONCAT_(a, b)
+#define POKER_TRACE_SCOPE(...) const Tracer::Scope POKER_TRACE_CONCAT(traceScope, __LINE__)(__VA_ARGS__)
+#define POKER_TRACE_ASYNC_SCOPE(...) const Tracer::AsyncScope POKER_TRACE_CONCAT(traceScope, __LINE__)(__VA_ARGS__)
+#define POKER_TRACE_THREAD(name) Tracer::setThreadName(name)
+#else
+#define POKER_TRACE_SCOPE(...)
+#define POKER_TRACE_ASYNC_SCOPE(...)
+#define POKER_TRACE_THREAD(name)
+#endif
+#endif
@@ -0,0 +1,67 @@
+﻿#include "AllocationCounter.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local std::uint64_t allocations = 0;
+
+    void *allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) {
+        allocations++;
+        const auto bytes = size == 0 ? 1 : size;
+        void *block = alignment <= alignof(std::max_align_t)
+                          ? std::malloc(bytes)
+                          : std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return block;
+    }
+}
+
+std::uint64_t AllocationCounter::threadAllocations() { return allocations; }
+
+void *operator new(const std::size_t size) { return allocate(size); }
+
+void *operator new[](const std::size_t size) { return allocate(size); }
+
+void *operator new(const std::size_t size, const std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *block) noexcept { std::free(block); }
+
+void operator delete[](void *block) noexcept { std::free(block); }
+
+void operator delete(void *block, std::size_t) noexcept { std::free(block); }
+
+void operator delete[](void *block, std::size_t) noexcept { std::free(block); }
+
+void operator delete(void *block, std::align_val_t) noexcept { std::free(block); }
+
+void operator delete[](void *block, std::align_val_t) noexcept { std::free(block); }
+
+void operator delete(void *block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+
+void operator delete[](void *block, std::size_t, std::align_val_t) noexcept { std::free(block); }
@@ -0,0 +1,468 @@
+﻿#include "BankrollStore.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    [[noreturn]] void throwSystemError(const std::string &what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    std::uint32_t recordChecksum(const BankrollStore::Record &record, const std::span<const BankrollStore::Slot> slots) {
+        auto hash = 2166136261u;
+        const auto mix = [&hash](const std::span<const std::byte> bytes) {
+            for (const auto byte: bytes) {
+                hash = (hash ^ static_cast<std::uint8_t>(byte)) * 16777619u;
+            }
+        };
+        mix(std::as_bytes(std::span(&record.lsn, 1)));
+        mix(std::as_bytes(std::span(&record.entries, 1)));
+        mix(std::as_bytes(slots));
+        return hash;
+    }
+
+    std::size_t recordSize(const BankrollStore::Record &record) {
+        return sizeof(BankrollStore::Record) + record.entries * sizeof(BankrollStore::Slot);
+    }
+
+    void writeAll(const int fd, const std::span<const std::uint8_t> bytes, const std::string &path) {
+        std::size_t written = 0;
+        while (written < bytes.size()) {
+            const auto result = ::write(fd, bytes.data() + written, bytes.size() - written);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                throwSystemError("write " + path);
+            }
+            written += static_cast<std::size_t>(result);
+        }
+    }
+}
+
+BankrollStore::BankrollStore(const std::string &path, const std::uint64_t capacity)
+    : tablePath_(path + ".table"), walPath_(path + ".wal"), tableFd_(-1), walFd_(-1), mapping_(nullptr),
+      length_(0), header_(nullptr), slots_(nullptr), walBytes_(0), nextLsn_(1), durableLsn_(0), settlements_(0),
+      groupCommits_(0), rejected_(0), recoveredRecords_(0), stopping_(false) {
+    try {
+        tableFd_ = ::open(tablePath_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        walFd_ = ::open(walPath_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (tableFd_ < 0 || walFd_ < 0) {
+            throwSystemError("open " + path);
+        }
+        struct stat info{};
+        if (::fstat(tableFd_, &info) < 0) {
+            throwSystemError("fstat " + tablePath_);
+        }
+        if (info.st_size == 0) {
+            map(std::bit_ceil(std::max<std::uint64_t>(capacity, 64)));
+        } else {
+            length_ = static_cast<std::size_t>(info.st_size);
+            mapping_ = length_ >= sizeof(Header)
+                           ? ::mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, tableFd_, 0)
+                           : MAP_FAILED;
+            if (mapping_ == MAP_FAILED) {
+                mapping_ = nullptr;
+                throw std::runtime_error("cannot map bankroll table: " + tablePath_);
+            }
+            header_ = static_cast<Header *>(mapping_);
+            slots_ = reinterpret_cast<Slot *>(header_ + 1);
+            if (header_->magic != MAGIC || header_->version != VERSION || !std::has_single_bit(header_->capacity) ||
+                length_ != sizeof(Header) + header_->capacity * sizeof(Slot)) {
+                throw std::runtime_error("invalid bankroll table: " + tablePath_);
+            }
+        }
+        recover();
+    } catch (...) {
+        release();
+        throw;
+    }
+    committer_ = std::thread(&BankrollStore::commitLoop, this);
+}
+
+BankrollStore::~BankrollStore() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    pendingReady_.notify_one();
+    committer_.join();
+    if (!failure_) {
+        try {
+            truncateLog();
+        } catch (const std::exception &error) {
+            std::cerr << error.what() << std::endl;
+        }
+    }
+    release();
+}
+
+std::int64_t BankrollStore::balance(const std::uint64_t account) const {
+    std::lock_guard lock(mutex_);
+    return projected(account);
+}
+
+std::optional<std::uint64_t> BankrollStore::deposit(const std::uint64_t account, const std::int64_t amount) {
+    const Transfer transfer{account, amount};
+    std::unique_lock lock(mutex_);
+    const auto lsn = append(std::span(&transfer, 1), false);
+    lock.unlock();
+    pendingReady_.notify_one();
+    return lsn;
+}
+
+std::optional<std::uint64_t> BankrollStore::settle(const std::span<const Transfer> transfers) {
+    std::unique_lock lock(mutex_);
+    const auto lsn = append(transfers, true);
+    lock.unlock();
+    pendingReady_.notify_one();
+    return lsn;
+}
+
+std::optional<std::uint64_t> BankrollStore::buyIn(const std::uint64_t account, const std::int64_t stake,
+                                                  const std::int64_t grant) {
+    std::unique_lock lock(mutex_);
+    if (seated_.contains(account)) {
+        rejected_++;
+        return std::nullopt;
+    }
+    const auto escrow = escrowAccount(account);
+    const auto funded = known(account) ? 0 : grant;
+    const auto available = projected(account) + projected(escrow) + funded;
+    if (available < stake) {
+        rejected_++;
+        return std::nullopt;
+    }
+    const std::array transfers{
+        Transfer{account, available - stake - projected(account)},
+        Transfer{escrow, stake - projected(escrow)},
+        Transfer{HOUSE_ACCOUNT, -funded}
+    };
+    const auto lsn = append(std::span(transfers).first(funded > 0 ? 3 : 2), true);
+    if (lsn) {
+        seated_.insert(account);
+    }
+    lock.unlock();
+    pendingReady_.notify_one();
+    return lsn;
+}
+
+std::optional<std::uint64_t> BankrollStore::cashOut(const std::uint64_t account) {
+    std::unique_lock lock(mutex_);
+    if (failure_ || !seated_.erase(account)) {
+        return std::nullopt;
+    }
+    const auto escrow = escrowAccount(account);
+    const auto held = projected(escrow);
+    if (held == 0) {
+        return nextLsn_ - 1;
+    }
+    const std::array transfers{Transfer{escrow, -held}, Transfer{account, held}};
+    const auto lsn = append(transfers, true);
+    lock.unlock();
+    pendingReady_.notify_one();
+    return lsn;
+}
+
+void BankrollStore::waitDurable(const std::uint64_t lsn) {
+    std::unique_lock lock(mutex_);
+    durable_.wait(lock, [this, lsn] { return durableLsn_ >= lsn || failure_; });
+    if (durableLsn_ < lsn) {
+        std::rethrow_exception(failure_);
+    }
+}
+
+void BankrollStore::checkpoint() {
+    std::unique_lock lock(mutex_);
+    durable_.wait(lock, [this] { return durableLsn_ + 1 == nextLsn_ || failure_; });
+    if (failure_) {
+        std::rethrow_exception(failure_);
+    }
+    truncateLog();
+}
+
+std::uint64_t BankrollStore::getDurableLsn() const {
+    std::lock_guard lock(mutex_);
+    return durableLsn_;
+}
+
+std::uint64_t BankrollStore::getSettlements() const {
+    std::lock_guard lock(mutex_);
+    return settlements_;
+}
+
+std::uint64_t BankrollStore::getGroupCommits() const {
+    std::lock_guard lock(mutex_);
+    return groupCommits_;
+}
+
+std::uint64_t BankrollStore::getRejected() const {
+    std::lock_guard lock(mutex_);
+    return rejected_;
+}
+
+std::uint64_t BankrollStore::getRecoveredRecords() const { return recoveredRecords_; }
+
+std::size_t BankrollStore::size() const {
+    std::lock_guard lock(mutex_);
+    return header_->count;
+}
+
+std::uint64_t BankrollStore::accountId(const std::string_view name) {
+    auto hash = 14695981039346656037ull;
+    for (const auto c: name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash <= HOUSE_ACCOUNT ? hash + 2 : hash;
+}
+
+std::uint64_t BankrollStore::escrowAccount(const std::uint64_t account) {
+    const auto escrow = std::rotl(account, 32) ^ 0xE5C20E5C20E5C20Eull;
+    return escrow <= HOUSE_ACCOUNT ? escrow + 2 : escrow;
+}
+
+std::optional<std::uint64_t> BankrollStore::append(const std::span<const Transfer> transfers, const bool balanced) {
+    if (failure_) {
+        rejected_++;
+        return std::nullopt;
+    }
+    scratch_.clear();
+    std::int64_t total = 0;
+    for (const auto &[account, delta]: transfers) {
+        if (account == 0 || scratch_.size() >= MAX_TRANSFERS) {
+            rejected_++;
+            return std::nullopt;
+        }
+        total += delta;
+        auto entry = std::ranges::find(scratch_, account, &Slot::account);
+        if (entry == scratch_.end()) {
+            entry = scratch_.insert(entry, {account, projected(account)});
+        }
+        entry->balance += delta;
+    }
+    if (scratch_.empty() || (balanced && total != 0) || std::ranges::any_of(scratch_, [](const Slot &slot) {
+        return slot.balance < 0 && slot.account != HOUSE_ACCOUNT;
+    })) {
+        rejected_++;
+        return std::nullopt;
+    }
+
+    Record record{nextLsn_++, static_cast<std::uint32_t>(scratch_.size()), 0};
+    record.checksum = recordChecksum(record, scratch_);
+    const auto *header = reinterpret_cast<const std::uint8_t *>(&record);
+    const auto *entries = reinterpret_cast<const std::uint8_t *>(scratch_.data());
+    log_.insert(log_.end(), header, header + sizeof(Record));
+    log_.insert(log_.end(), entries, entries + scratch_.size() * sizeof(Slot));
+    for (const auto &[account, balance]: scratch_) {
+        pending_.insert_or_assign(account, Pending{balance, record.lsn});
+    }
+    settlements_++;
+    return record.lsn;
+}
+
+std::int64_t BankrollStore::projected(const std::uint64_t account) const {
+    if (const auto pending = pending_.find(account); pending != pending_.end()) {
+        return pending->second.balance;
+    }
+    const auto *slot = find(account);
+    return slot->account == account ? slot->balance : 0;
+}
+
+bool BankrollStore::known(const std::uint64_t account) const {
+    return pending_.contains(account) || find(account)->account == account;
+}
+
+void BankrollStore::commitLoop() {
+    std::vector<std::uint8_t> batch;
+    std::unique_lock lock(mutex_);
+    while (true) {
+        pendingReady_.wait(lock, [this] { return stopping_ || !log_.empty(); });
+        if (log_.empty()) {
+            return;
+        }
+        batch.swap(log_);
+        const auto lsn = nextLsn_ - 1;
+
+        try {
+            lock.unlock();
+            writeAll(walFd_, batch, walPath_);
+            if (::fdatasync(walFd_) < 0) {
+                throwSystemError("fdatasync " + walPath_);
+            }
+            lock.lock();
+
+            apply(batch);
+            walBytes_ += batch.size();
+            batch.clear();
+            durableLsn_ = lsn;
+            groupCommits_++;
+            durable_.notify_all();
+            if (walBytes_ >= WAL_CHECKPOINT_BYTES) {
+                truncateLog();
+            }
+        } catch (const std::exception &error) {
+            std::cerr << error.what() << std::endl;
+            if (!lock.owns_lock()) {
+                lock.lock();
+            }
+            failure_ = std::current_exception();
+            durable_.notify_all();
+            return;
+        }
+    }
+}
+
+void BankrollStore::apply(const std::span<const std::uint8_t> log) {
+    for (std::size_t offset = 0; offset < log.size();) {
+        Record record{};
+        std::memcpy(&record, log.data() + offset, sizeof(Record));
+        const auto *entries = log.data() + offset + sizeof(Record);
+        for (std::uint32_t i = 0; i < record.entries; i++) {
+            Slot entry{};
+            std::memcpy(&entry, entries + i * sizeof(Slot), sizeof(Slot));
+            store(entry.account, entry.balance);
+            if (const auto pending = pending_.find(entry.account);
+                pending != pending_.end() && pending->second.lsn <= record.lsn) {
+                pending_.erase(pending);
+            }
+        }
+        header_->appliedLsn = record.lsn;
+        offset += recordSize(record);
+    }
+}
+
+void BankrollStore::store(const std::uint64_t account, const std::int64_t balance) {
+    auto *slot = find(account);
+    if (slot->account != account) {
+        if ((header_->count + 1) * 4 > header_->capacity * 3) {
+            grow();
+            slot = find(account);
+        }
+        slot->account = account;
+        header_->count++;
+    }
+    slot->balance = balance;
+}
+
+BankrollStore::Slot *BankrollStore::find(const std::uint64_t account) const {
+    const auto mask = header_->capacity - 1;
+    auto hash = account * 0x9E3779B97F4A7C15ull;
+    for (auto index = (hash ^ hash >> 32) & mask;; index = (index + 1) & mask) {
+        if (slots_[index].account == account || slots_[index].account == 0) {
+            return &slots_[index];
+        }
+    }
+}
+
+void BankrollStore::map(const std::uint64_t capacity) {
+    if (mapping_) {
+        ::munmap(mapping_, length_);
+        mapping_ = nullptr;
+    }
+    length_ = sizeof(Header) + capacity * sizeof(Slot);
+    if (::ftruncate(tableFd_, static_cast<off_t>(length_)) < 0) {
+        throwSystemError("ftruncate " + tablePath_);
+    }
+    mapping_ = ::mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, tableFd_, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throwSystemError("mmap " + tablePath_);
+    }
+    header_ = static_cast<Header *>(mapping_);
+    slots_ = reinterpret_cast<Slot *>(header_ + 1);
+    *header_ = Header{MAGIC, VERSION, capacity, 0, 0};
+}
+
+void BankrollStore::grow() {
+    std::vector<Slot> live;
+    live.reserve(header_->count);
+    std::copy_if(slots_, slots_ + header_->capacity, std::back_inserter(live),
+                 [](const Slot &slot) { return slot.account != 0; });
+    const auto appliedLsn = header_->appliedLsn;
+    const auto capacity = header_->capacity * 2;
+
+    const auto temporary = tablePath_ + ".tmp";
+    const auto fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throwSystemError("open " + temporary);
+    }
+    ::close(tableFd_);
+    tableFd_ = fd;
+    map(capacity);
+    header_->appliedLsn = appliedLsn;
+    for (const auto &[account, balance]: live) {
+        store(account, balance);
+    }
+    if (::msync(mapping_, length_, MS_SYNC) < 0 || ::rename(temporary.c_str(), tablePath_.c_str()) < 0) {
+        throwSystemError("replace " + tablePath_);
+    }
+}
+
+void BankrollStore::recover() {
+    std::vector<std::uint8_t> log;
+    std::array<std::uint8_t, 1 << 16> chunk{};
+    while (true) {
+        const auto result = ::pread(walFd_, chunk.data(), chunk.size(), static_cast<off_t>(log.size()));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0) {
+            throwSystemError("read " + walPath_);
+        }
+        if (result == 0) {
+            break;
+        }
+        log.insert(log.end(), chunk.begin(), chunk.begin() + result);
+    }
+
+    for (std::size_t offset = 0; offset + sizeof(Record) <= log.size();) {
+        Record record{};
+        std::memcpy(&record, log.data() + offset, sizeof(Record));
+        if (record.entries == 0 || record.entries > MAX_TRANSFERS || offset + recordSize(record) > log.size()) {
+            break;
+        }
+        std::vector<Slot> entries(record.entries);
+        std::memcpy(entries.data(), log.data() + offset + sizeof(Record), record.entries * sizeof(Slot));
+        if (recordChecksum(record, entries) != record.checksum) {
+            break;
+        }
+        apply(std::span(log).subspan(offset, recordSize(record)));
+        recoveredRecords_++;
+        nextLsn_ = std::max(nextLsn_, record.lsn + 1);
+        offset += recordSize(record);
+    }
+    nextLsn_ = std::max(nextLsn_, header_->appliedLsn + 1);
+    durableLsn_ = nextLsn_ - 1;
+    truncateLog();
+}
+
+void BankrollStore::truncateLog() {
+    if (::msync(mapping_, length_, MS_SYNC) < 0 || ::ftruncate(walFd_, 0) < 0 || ::fsync(walFd_) < 0) {
+        throwSystemError("checkpoint " + walPath_);
+    }
+    walBytes_ = 0;
+}
+
+void BankrollStore::release() {
+    if (mapping_) {
+        ::munmap(mapping_, length_);
+        mapping_ = nullptr;
+    }
+    if (tableFd_ >= 0) {
+        ::close(tableFd_);
+        tableFd_ = -1;
+    }
+    if (walFd_ >= 0) {
+        ::close(walFd_);
+        walFd_ = -1;
+    }
+}
@@ -0,0 +1,136 @@
+﻿#include "Checkpoint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+Checkpoint::Writer::Writer(std::vector<std::uint8_t> &out) : out_(out) {
+}
+
+void Checkpoint::Writer::u8(const std::uint8_t value) const { out_.push_back(value); }
+
+void Checkpoint::Writer::u32(const std::uint32_t value) const {
+    for (auto shift = 0; shift < 32; shift += 8) {
+        out_.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+void Checkpoint::Writer::i32(const std::int32_t value) const { u32(static_cast<std::uint32_t>(value)); }
+
+void Checkpoint::Writer::text(const std::string_view value) const {
+    const auto length = std::min(value.size(), MAX_TEXT);
+    u32(static_cast<std::uint32_t>(length));
+    out_.insert(out_.end(), value.begin(), value.begin() + static_cast<std::ptrdiff_t>(length));
+}
+
+void Checkpoint::Writer::bytes(const std::span<const std::uint8_t> value) const {
+    u32(static_cast<std::uint32_t>(value.size()));
+    out_.insert(out_.end(), value.begin(), value.end());
+}
+
+Checkpoint::Reader::Reader(const std::span<const std::uint8_t> payload) : payload_(payload), pos_(0), ok_(true) {
+}
+
+std::uint8_t Checkpoint::Reader::u8() {
+    if (!require(1)) return 0;
+    return payload_[pos_++];
+}
+
+std::uint32_t Checkpoint::Reader::u32() {
+    if (!require(4)) return 0;
+    std::uint32_t value = 0;
+    for (auto shift = 0; shift < 32; shift += 8) {
+        value |= static_cast<std::uint32_t>(payload_[pos_++]) << shift;
+    }
+    return value;
+}
+
+std::int32_t Checkpoint::Reader::i32() { return static_cast<std::int32_t>(u32()); }
+
+std::string Checkpoint::Reader::text() {
+    const auto length = u32();
+    if (length > MAX_TEXT || !require(length)) {
+        ok_ = false;
+        return {};
+    }
+    std::string value(reinterpret_cast<const char *>(payload_.data() + pos_), length);
+    pos_ += length;
+    return value;
+}
+
+void Checkpoint::Reader::bytes(const std::span<std::uint8_t> value) {
+    if (u32() != value.size() || !require(value.size())) {
+        ok_ = false;
+        return;
+    }
+    std::copy_n(payload_.begin() + static_cast<std::ptrdiff_t>(pos_), value.size(), value.begin());
+    pos_ += value.size();
+}
+
+bool Checkpoint::Reader::ok() const { return ok_; }
+
+bool Checkpoint::Reader::complete() const { return ok_ && pos_ == payload_.size(); }
+
+bool Checkpoint::Reader::require(const std::size_t bytes) {
+    if (pos_ + bytes > payload_.size()) ok_ = false;
+    return ok_;
+}
+
+void Checkpoint::writeFile(const std::string &path, const std::span<const std::uint8_t> payload) {
+    std::vector<std::uint8_t> header;
+    header.reserve(HEADER_SIZE);
+    const Writer writer(header);
+    writer.u32(MAGIC);
+    writer.u32(VERSION);
+    writer.u32(static_cast<std::uint32_t>(payload.size()));
+    writer.u32(checksum(payload));
+
+    const auto temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+        out.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!out.flush()) {
+            throw std::runtime_error("failed to write checkpoint: " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("failed to replace checkpoint: " + path);
+    }
+}
+
+std::optional<std::vector<std::uint8_t> > Checkpoint::readFile(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return std::nullopt;
+    }
+    const std::vector<std::uint8_t> file{std::istreambuf_iterator(in), std::istreambuf_iterator<char>()};
+
+    const std::span<const std::uint8_t> bytes(file);
+    Reader header(bytes.first(std::min(bytes.size(), HEADER_SIZE)));
+    const auto magic = header.u32();
+    const auto version = header.u32();
+    const auto size = header.u32();
+    const auto expected = header.u32();
+    if (!header.complete() || magic != MAGIC) {
+        throw std::runtime_error("not a checkpoint: " + path);
+    }
+    if (version != VERSION) {
+        throw std::runtime_error("unsupported checkpoint version " + std::to_string(version) + ": " + path);
+    }
+    if (file.size() != HEADER_SIZE + size || checksum(bytes.subspan(HEADER_SIZE)) != expected) {
+        throw std::runtime_error("corrupt checkpoint: " + path);
+    }
+    return std::vector(file.begin() + HEADER_SIZE, file.end());
+}
+
+std::uint32_t Checkpoint::checksum(const std::span<const std::uint8_t> bytes) {
+    std::uint32_t hash = 2166136261u;
+    for (const auto byte: bytes) {
+        hash = (hash ^ byte) * 16777619u;
+    }
+    return hash;
+}
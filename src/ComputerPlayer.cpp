@@ -1,43 +1,147 @@
 ﻿#include "ComputerPlayer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <iostream>
 
+#include "Console.h"
+#include "HandAbstraction.h"
 #include "Player.h"
 
 ComputerPlayer::ComputerPlayer(const std::string &name, const int initialChips)
-    : Player(name, initialChips) {
+    : Player(name, initialChips), gen_(std::random_device{}()), plannedRaise_(0), opponents_(1) {
 }
 
+ComputerPlayer::~ComputerPlayer() { unlinkService(); }
+
 Player::Action ComputerPlayer::makeDecision(const int currentBet, const int chipsCommitted,
-                                            const std::vector<Card> &_) {
+                                            const std::vector<Card> &communityCards) {
     if (isFolded()) return Action::FOLD;
 
-    std::cout << name_ << " is thinking..." << std::endl;
+    Console::out() << name_ << " is thinking..." << '\n';
+
+    if (decisionService_) {
+        const auto result = decisionService_->decideNow(
+            makeServiceRequest(currentBet, chipsCommitted, communityCards, opponents_));
+        plannedRaise_ = result.raiseAmount;
+        return announce(result.action);
+    }
+
+    if (const auto strength = abstractionStrength(communityCards); strength >= 0) {
+        const auto result = DecisionService::chooseAction(
+            makeServiceRequest(currentBet, chipsCommitted, communityCards, opponents_), std::pow(strength, opponents_));
+        plannedRaise_ = result.raiseAmount;
+        return announce(result.action);
+    }
 
-    std::random_device rd_;
-    std::mt19937 gen(rd_());
+    plannedRaise_ = 0;
     std::uniform_int_distribution dist(1, 100);
-    const auto rand = dist(gen);
+    const auto rand = dist(gen_);
 
     if (currentBet > chipsCommitted) {
         if (rand % 100 < 70) {
-            std::cout << name_ << " calls." << std::endl;
+            Console::out() << name_ << " calls." << '\n';
             return Action::CALL;
         }
         fold();
-        std::cout << name_ << " folds." << std::endl;
+        Console::out() << name_ << " folds." << '\n';
         return Action::FOLD;
     }
     if (rand % 100 < 50) {
         return Action::RAISE;
     }
-    std::cout << name_ << " checks." << std::endl;
+    Console::out() << name_ << " checks." << '\n';
     return Action::CHECK;
 }
 
 int ComputerPlayer::getRaiseAmount(const int currentBet, int _) {
-    const auto raiseAmount = currentBet + currentBet / 2 + 10;
-    std::cout << name_ << " raises to " << raiseAmount << "." << std::endl;
+    const auto raiseAmount = plannedRaise_ > currentBet ? plannedRaise_ : currentBet + currentBet / 2 + 10;
+    Console::out() << name_ << " raises to " << raiseAmount << "." << '\n';
     return raiseAmount;
 }
+
+void ComputerPlayer::setDecisionService(std::shared_ptr<DecisionService> service) {
+    unlinkService();
+    decisionService_ = std::move(service);
+    if (decisionService_) {
+        serviceLink_ = std::make_shared<ServiceLink>();
+        serviceLink_->slot = &serviceSlot_;
+    }
+}
+
+void ComputerPlayer::setHandAbstraction(std::shared_ptr<const HandAbstraction> abstraction) {
+    abstraction_ = std::move(abstraction);
+}
+
+void ComputerPlayer::setSeed(const std::uint32_t seed) { gen_.seed(seed); }
+
+Task<Player::Decision> ComputerPlayer::decide(const DecisionView &view) {
+    opponents_ = std::max(1, view.opponents);
+    if (!decisionService_ || isFolded() || !view.scheduler) {
+        co_return co_await Player::decide(view);
+    }
+
+    Console::out() << name_ << " is thinking..." << '\n';
+
+    auto awaiter = serviceSlot_.wait(view.scheduler);
+    decisionService_->submit(makeServiceRequest(view.currentBet, view.chipsCommitted, view.communityCards,
+                                                opponents_),
+                             [link = serviceLink_](const DecisionService::Result &result) {
+                                 std::lock_guard lock(link->mutex);
+                                 if (link->slot) {
+                                     link->slot->fulfill({result.action, result.raiseAmount});
+                                 }
+                             });
+    auto decision = co_await awaiter;
+
+    plannedRaise_ = decision.raiseAmount;
+    announce(decision.action);
+    if (decision.action == Action::RAISE) {
+        decision.raiseAmount = getRaiseAmount(view.currentBet, view.chipsCommitted);
+    }
+    co_return decision;
+}
+
+DecisionService::Request ComputerPlayer::makeServiceRequest(const int currentBet, const int chipsCommitted,
+                                                            const std::vector<Card> &communityCards,
+                                                            const int opponents) const {
+    return {
+        HandEvaluator::toMask(holeCards_), HandEvaluator::toMask(communityCards), opponents,
+        currentBet, chipsCommitted, chips_.getChips()
+    };
+}
+
+void ComputerPlayer::unlinkService() {
+    if (serviceLink_) {
+        std::lock_guard lock(serviceLink_->mutex);
+        serviceLink_->slot = nullptr;
+    }
+}
+
+double ComputerPlayer::abstractionStrength([[maybe_unused]] const std::vector<Card> &communityCards) const {
+#ifdef POKER_HAND_ABSTRACTION
+    if (abstraction_) {
+        return abstraction_->strength(HandEvaluator::toMask(holeCards_), HandEvaluator::toMask(communityCards));
+    }
+#endif
+    return -1.0;
+}
+
+Player::Action ComputerPlayer::announce(const Action action) {
+    switch (action) {
+        case Action::FOLD:
+            fold();
+            Console::out() << name_ << " folds." << '\n';
+            break;
+        case Action::CALL:
+            Console::out() << name_ << " calls." << '\n';
+            break;
+        case Action::CHECK:
+            Console::out() << name_ << " checks." << '\n';
+            break;
+        case Action::RAISE:
+            break;
+    }
+    return action;
+}
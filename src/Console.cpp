@@ -0,0 +1,16 @@
+﻿#include "Console.h"
+
+#include <iostream>
+
+namespace {
+    thread_local bool quiet = false;
+    thread_local std::ostream discard(nullptr);
+}
+
+std::ostream &Console::out() {
+    return quiet ? discard : std::cout;
+}
+
+void Console::setQuiet(const bool isQuiet) { quiet = isQuiet; }
+
+bool Console::isQuiet() { return quiet; }
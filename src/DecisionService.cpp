@@ -0,0 +1,251 @@
+﻿#include "DecisionService.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <numeric>
+
+#include "HandIndexer.h"
+
+namespace {
+    constexpr auto DRAW_DEPTH = 5 + 2 * DecisionService::MAX_OPPONENTS + 7;
+    constexpr auto OMAHA_HOLE_CARDS = 4;
+    constexpr auto OMAHA_DRAW_DEPTH = 5 + OMAHA_HOLE_CARDS * DecisionService::MAX_OPPONENTS + OMAHA_HOLE_CARDS + 5;
+
+    bool isOmaha(const DecisionService::Request &request) {
+        return std::popcount(request.holeCards) == OMAHA_HOLE_CARDS;
+    }
+
+    int showdownScore(const HandEvaluator::CardMask holeCards, const HandEvaluator::CardMask board,
+                      const bool omaha) {
+        return omaha ? HandEvaluator::evaluateOmaha(holeCards, board) : HandEvaluator::evaluate(holeCards | board);
+    }
+}
+
+std::size_t DecisionService::CacheKeyHash::operator()(const CacheKey &key) const {
+    auto hash = key.hand * 0x9E3779B97F4A7C15ull;
+    hash ^= key.board + 0x632BE59BD9B4E019ull + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<std::uint64_t>(key.street) + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<std::uint64_t>(key.opponents) + (hash << 6) + (hash >> 2);
+    return static_cast<std::size_t>(hash);
+}
+
+DecisionService::DecisionService(const std::size_t maxBatchSize, const int samplesPerDecision,
+                                 const std::size_t cacheCapacity)
+    : maxBatchSize_(std::max<std::size_t>(1, maxBatchSize)), samplesPerDecision_(samplesPerDecision),
+      cacheCapacity_(cacheCapacity), rng_(std::random_device{}()), decisionsServed_(0), batchesProcessed_(0),
+      cacheHits_(0), stopping_(false), worker_(&DecisionService::workerLoop, this) {
+}
+
+DecisionService::~DecisionService() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    worker_.join();
+}
+
+std::future<DecisionService::Result> DecisionService::submit(const Request &request) {
+    Pending pending{request, {}, {}};
+    auto future = pending.promise.get_future();
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back(std::move(pending));
+    }
+    ready_.notify_one();
+    return future;
+}
+
+void DecisionService::submit(const Request &request, std::function<void(const Result &)> onReady) {
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back({request, {}, std::move(onReady)});
+    }
+    ready_.notify_one();
+}
+
+DecisionService::Result DecisionService::decideNow(const Request &request) const {
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    const Request *requests[] = {&request};
+    double equity[1]{};
+    computeEquities(requests, equity, samplesPerDecision_, rng);
+    return chooseAction(request, equity[0]);
+}
+
+std::uint64_t DecisionService::getDecisionsServed() const { return decisionsServed_.load(); }
+
+std::uint64_t DecisionService::getBatchesProcessed() const { return batchesProcessed_.load(); }
+
+std::uint64_t DecisionService::getCacheHits() const { return cacheHits_.load(); }
+
+void DecisionService::workerLoop() {
+    std::vector<Pending> batch;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            const auto take = static_cast<std::ptrdiff_t>(std::min(queue_.size(), maxBatchSize_));
+            batch.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.begin() + take));
+            queue_.erase(queue_.begin(), queue_.begin() + take);
+        }
+        processBatch(batch);
+        batch.clear();
+    }
+}
+
+void DecisionService::processBatch(std::vector<Pending> &batch) {
+    constexpr auto npos = static_cast<std::size_t>(-1);
+
+    std::vector<double> equities(batch.size(), 0.0);
+    std::vector<std::size_t> missSlot(batch.size(), npos);
+    std::vector<const Request *> misses;
+    std::vector<CacheKey> missKeys;
+    std::unordered_map<CacheKey, std::size_t, CacheKeyHash> batchSlots;
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        const auto &request = batch[i].request;
+        const auto key = cacheKey(request);
+        if (const auto cached = equityCache_.find(key); cached != equityCache_.end()) {
+            equities[i] = cached->second;
+            cacheHits_++;
+        } else if (const auto shared = batchSlots.find(key); shared != batchSlots.end()) {
+            missSlot[i] = shared->second;
+            cacheHits_++;
+        } else {
+            missSlot[i] = misses.size();
+            batchSlots.emplace(key, misses.size());
+            misses.push_back(&request);
+            missKeys.push_back(key);
+        }
+    }
+
+    std::vector<double> missEquities(misses.size(), 0.0);
+    computeEquities(misses, missEquities, samplesPerDecision_, rng_);
+
+    if (equityCache_.size() + misses.size() > cacheCapacity_) {
+        equityCache_.clear();
+    }
+    for (std::size_t m = 0; m < misses.size(); m++) {
+        equityCache_.emplace(missKeys[m], missEquities[m]);
+    }
+
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        if (missSlot[i] != npos) {
+            equities[i] = missEquities[missSlot[i]];
+        }
+        const auto result = chooseAction(batch[i].request, equities[i]);
+        if (batch[i].onReady) {
+            batch[i].onReady(result);
+        } else {
+            batch[i].promise.set_value(result);
+        }
+    }
+
+    decisionsServed_ += batch.size();
+    batchesProcessed_++;
+}
+
+DecisionService::CacheKey DecisionService::cacheKey(const Request &request) {
+    const auto opponents = std::clamp(request.opponents, 1, MAX_OPPONENTS);
+    if (const auto boardCards = std::popcount(request.communityCards);
+        std::popcount(request.holeCards) == 2 && (boardCards == 0 || boardCards >= 3)) {
+        const auto street = boardCards == 0 ? 0 : boardCards - 2;
+        const std::array rounds{request.holeCards, request.communityCards};
+        const auto &indexer = HandIndexer::forStreet(street);
+        return {indexer.index(std::span(rounds.data(), street == 0 ? 1 : 2)), 0, street, opponents};
+    }
+    return {request.holeCards, request.communityCards, -1, opponents};
+}
+
+void DecisionService::computeEquities(const std::span<const Request *const> requests, const std::span<double> equities,
+                                      const int samples, std::mt19937_64 &rng) {
+    if (requests.empty() || samples <= 0) {
+        return;
+    }
+
+    std::array<int, 52> deck{};
+    std::iota(deck.begin(), deck.end(), 0);
+    std::ranges::fill(equities, 0.0);
+    const auto depth = std::ranges::any_of(requests, [](const Request *request) { return isOmaha(*request); })
+                           ? OMAHA_DRAW_DEPTH
+                           : DRAW_DEPTH;
+
+    for (auto s = 0; s < samples; s++) {
+        for (auto i = 0; i < depth; i++) {
+            std::uniform_int_distribution pick(i, 51);
+            std::swap(deck[i], deck[pick(rng)]);
+        }
+
+        for (std::size_t r = 0; r < requests.size(); r++) {
+            const auto &request = *requests[r];
+            const auto dead = request.holeCards | request.communityCards;
+            auto next = 0;
+            const auto draw = [&] {
+                while (dead & HandEvaluator::cardBit(deck[next])) {
+                    next++;
+                }
+                return HandEvaluator::cardBit(deck[next++]);
+            };
+
+            auto board = request.communityCards;
+            for (auto count = std::popcount(board); count < 5; count++) {
+                board |= draw();
+            }
+
+            const auto omaha = isOmaha(request);
+            const auto heroScore = showdownScore(request.holeCards, board, omaha);
+            auto ties = 0;
+            auto beaten = false;
+            const auto opponents = std::clamp(request.opponents, 1, MAX_OPPONENTS);
+            for (auto o = 0; o < opponents && !beaten; o++) {
+                auto opponentCards = draw() | draw();
+                if (omaha) {
+                    opponentCards |= draw() | draw();
+                }
+                if (const auto score = showdownScore(opponentCards, board, omaha); score > heroScore) {
+                    beaten = true;
+                } else if (score == heroScore) {
+                    ties++;
+                }
+            }
+            if (!beaten) {
+                equities[r] += 1.0 / (ties + 1);
+            }
+        }
+    }
+
+    for (auto &equity: equities) {
+        equity /= samples;
+    }
+}
+
+DecisionService::Result DecisionService::chooseAction(const Request &request, const double equity) {
+    const auto opponents = std::clamp(request.opponents, 1, MAX_OPPONENTS);
+    const auto fairShare = 1.0 / (opponents + 1);
+    const auto callAmount = std::max(0, request.currentBet - request.chipsCommitted);
+    const auto maxTotal = request.chipsCommitted + request.chipCount;
+    const auto raiseTo = std::min(maxTotal, request.currentBet + std::max(10, static_cast<int>(
+                                                                              request.currentBet * equity * 2)));
+    const auto canRaise = raiseTo > request.currentBet;
+
+    if (callAmount > 0) {
+        const auto estimatedPot = request.currentBet * (opponents + 1);
+        const auto potOdds = static_cast<double>(callAmount) / (callAmount + estimatedPot);
+        if (canRaise && equity > fairShare * 1.6) {
+            return {Player::Action::RAISE, raiseTo, equity};
+        }
+        if (equity >= potOdds) {
+            return {Player::Action::CALL, 0, equity};
+        }
+        return {Player::Action::FOLD, 0, equity};
+    }
+
+    if (canRaise && equity > fairShare * 1.3) {
+        return {Player::Action::RAISE, raiseTo, equity};
+    }
+    return {Player::Action::CHECK, 0, equity};
+}
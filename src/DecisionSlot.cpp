@@ -0,0 +1,53 @@
+﻿#include "DecisionSlot.h"
+
+#include "TableScheduler.h"
+
+DecisionSlot::Awaiter::Awaiter(DecisionSlot &slot, TableScheduler *scheduler) : slot_(slot), scheduler_(scheduler) {
+}
+
+bool DecisionSlot::Awaiter::await_ready() const noexcept {
+    return slot_.state_.load(std::memory_order_acquire) == State::READY;
+}
+
+bool DecisionSlot::Awaiter::await_suspend(const std::coroutine_handle<> handle) noexcept {
+    slot_.waiter_ = handle;
+    slot_.scheduler_ = scheduler_;
+    auto expected = State::ARMED;
+    return slot_.state_.compare_exchange_strong(expected, State::SUSPENDED, std::memory_order_acq_rel);
+}
+
+Player::Decision DecisionSlot::Awaiter::await_resume() const noexcept {
+    slot_.state_.store(State::IDLE, std::memory_order_release);
+    return slot_.decision_;
+}
+
+DecisionSlot::DecisionSlot() : state_(State::IDLE), decision_{Player::Action::FOLD, 0}, claimed_(false),
+                               scheduler_(nullptr) {
+}
+
+DecisionSlot::Awaiter DecisionSlot::wait(TableScheduler *scheduler) {
+    claimed_.store(false, std::memory_order_relaxed);
+    state_.store(State::ARMED, std::memory_order_release);
+    return {*this, scheduler};
+}
+
+bool DecisionSlot::fulfill(const Player::Decision &decision) {
+    if (!isWaiting() || claimed_.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    decision_ = decision;
+    if (state_.exchange(State::READY, std::memory_order_acq_rel) == State::SUSPENDED) {
+        if (scheduler_) {
+            scheduler_->post(waiter_);
+        } else {
+            waiter_.resume();
+        }
+    }
+    return true;
+}
+
+bool DecisionSlot::isWaiting() const {
+    const auto state = state_.load(std::memory_order_acquire);
+    return state == State::ARMED || state == State::SUSPENDED;
+}
@@ -0,0 +1,230 @@
+﻿#include "ExploitativePlayer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#include "Console.h"
+#include "DecisionService.h"
+#include "HandAbstraction.h"
+
+namespace {
+    int streetOf(const std::vector<Card> &communityCards) {
+        return communityCards.size() < 3 ? 0 : static_cast<int>(communityCards.size()) - 2;
+    }
+}
+
+ExploitativePlayer::ExploitativePlayer(const std::string &name, const int initialChips,
+                                       const std::size_t modelCapacity, const int samples)
+    : Player(name, initialChips), models_(modelCapacity), gen_(std::random_device{}()), samples_(samples),
+      plannedRaise_(0) {
+    handOpponents_.reserve(MAX_TRACKED_OPPONENTS);
+    lastHandOpponents_.reserve(MAX_TRACKED_OPPONENTS);
+}
+
+Player::Action ExploitativePlayer::makeDecision(const int currentBet, const int chipsCommitted,
+                                                const std::vector<Card> &communityCards) {
+    if (isFolded()) return Action::FOLD;
+
+    Console::out() << name_ << " is thinking..." << '\n';
+
+    const auto street = streetOf(communityCards);
+    const auto equity = estimateEquity(communityCards, street);
+
+    auto opponents = 0;
+    for (const auto &opponent: handOpponents_) {
+        if (!opponent.folded) opponents++;
+    }
+    const DecisionService::Request request{
+        HandEvaluator::toMask(holeCards_), HandEvaluator::toMask(communityCards), std::max(1, opponents),
+        currentBet, chipsCommitted, chips_.getChips()
+    };
+    const auto [action, raiseAmount, _] = DecisionService::chooseAction(request, equity);
+    plannedRaise_ = raiseAmount;
+
+    switch (action) {
+        case Action::FOLD:
+            fold();
+            Console::out() << name_ << " folds." << '\n';
+            break;
+        case Action::CALL:
+            Console::out() << name_ << " calls." << '\n';
+            break;
+        case Action::CHECK:
+            Console::out() << name_ << " checks." << '\n';
+            break;
+        case Action::RAISE:
+            break;
+    }
+    return action;
+}
+
+int ExploitativePlayer::getRaiseAmount(const int currentBet, int) {
+    const auto raiseAmount = plannedRaise_ > currentBet ? plannedRaise_ : currentBet + currentBet / 2 + 10;
+    Console::out() << name_ << " raises to " << raiseAmount << "." << '\n';
+    return raiseAmount;
+}
+
+void ExploitativePlayer::observeAction(const std::string &playerName, const Action action, const int amount,
+                                       const int pot, const int street) {
+    if (playerName == name_) return;
+
+    models_.recordAction(playerName, action, amount, pot, street);
+
+    const auto id = OpponentModelStore::idOf(playerName);
+    auto opponent = std::ranges::find(handOpponents_, id, &HandOpponent::id);
+    if (opponent == handOpponents_.end()) {
+        if (handOpponents_.size() == MAX_TRACKED_OPPONENTS) return;
+        opponent = handOpponents_.insert(handOpponents_.end(), {id, false, false});
+    }
+    opponent->folded = opponent->folded || action == Action::FOLD;
+    opponent->raised = opponent->raised || action == Action::RAISE;
+}
+
+void ExploitativePlayer::observeShowdown(const std::string &playerName, const std::vector<Card> &holeCards,
+                                         const std::vector<Card> &communityCards) {
+    if (playerName == name_) return;
+
+    const auto score = HandEvaluator::evaluate(holeCards, communityCards);
+    models_.recordShowdown(playerName, HandEvaluator::categoryOf(score));
+}
+
+void ExploitativePlayer::clearHand() {
+    if (!handOpponents_.empty()) {
+        lastHandOpponents_ = handOpponents_;
+        handOpponents_.clear();
+    }
+    Player::clearHand();
+}
+
+const OpponentModelStore &ExploitativePlayer::getOpponentModels() const { return models_; }
+
+void ExploitativePlayer::setHandAbstraction(std::shared_ptr<const HandAbstraction> abstraction) {
+    abstraction_ = std::move(abstraction);
+}
+
+double ExploitativePlayer::estimateEquity(const std::vector<Card> &communityCards, const int street) {
+    std::array<HandOpponent, DecisionService::MAX_OPPONENTS> live{};
+    std::size_t liveCount = 0;
+    for (const auto &opponent: handOpponents_) {
+        if (!opponent.folded && liveCount < live.size()) live[liveCount++] = opponent;
+    }
+    for (const auto &opponent: lastHandOpponents_) {
+        if (liveCount < live.size() && std::ranges::find(handOpponents_, opponent.id, &HandOpponent::id) ==
+            handOpponents_.end()) {
+            live[liveCount++] = {opponent.id, false, false};
+        }
+    }
+    if (liveCount == 0) {
+        live[liveCount++] = {0, false, false};
+    }
+
+    const auto hero = HandEvaluator::toMask(holeCards_);
+    const auto knownBoard = HandEvaluator::toMask(communityCards);
+    const auto dead = hero | knownBoard;
+
+    std::array<int, 52> deck{};
+    auto deckSize = 0;
+    for (auto index = 0; index < 52; index++) {
+        if (!(dead & HandEvaluator::cardBit(index))) deck[deckSize++] = index;
+    }
+    const auto missingBoard = 5 - static_cast<int>(communityCards.size());
+    const auto draws = std::min(deckSize, missingBoard + 2 * static_cast<int>(liveCount));
+
+    auto weightedWins = 0.0;
+    auto totalWeight = 0.0;
+    for (auto s = 0; s < samples_; s++) {
+        for (auto i = 0; i < draws; i++) {
+            std::uniform_int_distribution pick(i, deckSize - 1);
+            std::swap(deck[i], deck[pick(gen_)]);
+        }
+
+        auto board = knownBoard;
+        for (auto i = 0; i < missingBoard; i++) {
+            board |= HandEvaluator::cardBit(deck[i]);
+        }
+        const auto heroScore = HandEvaluator::evaluate(hero | board);
+
+        auto weight = 1.0;
+        auto ties = 0;
+        auto beaten = false;
+        for (std::size_t o = 0; o < liveCount; o++) {
+            const auto first = deck[missingBoard + 2 * o];
+            const auto second = deck[missingBoard + 2 * o + 1];
+            weight *= rangeWeight(live[o], first, second, knownBoard, street);
+            const auto score = HandEvaluator::evaluate(HandEvaluator::cardBit(first) | HandEvaluator::cardBit(second) |
+                                                       board);
+            if (score > heroScore) beaten = true;
+            else if (score == heroScore) ties++;
+        }
+
+        totalWeight += weight;
+        if (!beaten) weightedWins += weight / (ties + 1);
+    }
+
+    return totalWeight > 0 ? weightedWins / totalWeight : 0.0;
+}
+
+double ExploitativePlayer::rangeWeight(const HandOpponent &opponent, const int firstCard, const int secondCard,
+                                       const HandEvaluator::CardMask board, const int street) const {
+    const auto *model = models_.find(opponent.id);
+    const auto strength = handStrength(firstCard, secondCard, board, street);
+
+    auto threshold = 1.0 - (model ? model->looseness(street) : 0.5);
+    if (opponent.raised) {
+        threshold += 0.15 + 0.2 * (1.0 - (model ? model->aggression(street) : 0.5));
+    }
+    if (model) {
+        threshold += (model->showdownStrength() - 0.25) * 0.2;
+    }
+
+    return 0.05 + 1.0 / (1.0 + std::exp(-(strength - threshold) * 10.0));
+}
+
+double ExploitativePlayer::handStrength(const int firstCard, const int secondCard,
+                                        const HandEvaluator::CardMask board, const int street) const {
+    const auto hand = HandEvaluator::cardBit(firstCard) | HandEvaluator::cardBit(secondCard);
+#ifdef POKER_HAND_ABSTRACTION
+    if (abstraction_) {
+        if (const auto strength = abstraction_->strength(hand, board); strength >= 0) {
+            return strength;
+        }
+    }
+#endif
+    const auto strength = preflopStrength(firstCard, secondCard);
+    if (street == 0) {
+        return strength;
+    }
+    const auto made = HandEvaluator::categoryOf(HandEvaluator::evaluate(hand | board));
+    return 0.4 * strength + 0.6 * std::min(1.0, static_cast<int>(made) / 4.0);
+}
+
+double ExploitativePlayer::preflopStrength(const int firstCard, const int secondCard) {
+    const auto firstRank = firstCard % 13 + 2;
+    const auto secondRank = secondCard % 13 + 2;
+    const auto high = std::max(firstRank, secondRank);
+    const auto low = std::min(firstRank, secondRank);
+
+    const auto points = [](const int rank) {
+        switch (rank) {
+            case 14: return 10.0;
+            case 13: return 8.0;
+            case 12: return 7.0;
+            case 11: return 6.0;
+            default: return rank / 2.0;
+        }
+    };
+
+    auto score = points(high);
+    if (high == low) {
+        score = std::max(5.0, score * 2);
+    } else {
+        if (firstCard / 13 == secondCard / 13) score += 2;
+        const auto gap = high - low - 1;
+        constexpr double gapPenalty[] = {0, 1, 2, 4, 5};
+        score -= gapPenalty[std::min(gap, 4)];
+        if (gap <= 1 && high < 12) score += 1;
+    }
+    return std::clamp((score + 1.0) / 21.0, 0.0, 1.0);
+}
@@ -0,0 +1,57 @@
+﻿#include "FramePool.h"
+
+#include <array>
+#include <new>
+#include <utility>
+
+namespace {
+    struct FreeFrame {
+        FreeFrame *next;
+    };
+
+    struct FrameCache {
+        std::array<FreeFrame *, FramePool::SIZE_CLASSES> heads{};
+        std::array<std::size_t, FramePool::SIZE_CLASSES> counts{};
+
+        ~FrameCache();
+    };
+
+    thread_local FrameCache cache;
+    thread_local bool cacheClosed = false;
+
+    FrameCache::~FrameCache() {
+        cacheClosed = true;
+        for (auto &head: heads) {
+            while (head) {
+                ::operator delete(std::exchange(head, head->next));
+            }
+        }
+    }
+
+    std::size_t sizeClass(const std::size_t size) {
+        return (size + FramePool::GRANULE - 1) / FramePool::GRANULE;
+    }
+}
+
+void *FramePool::allocate(const std::size_t size) {
+    const auto index = sizeClass(size);
+    if (index >= SIZE_CLASSES || cacheClosed) {
+        return ::operator new(size);
+    }
+    if (auto *frame = cache.heads[index]) {
+        cache.heads[index] = frame->next;
+        cache.counts[index]--;
+        return frame;
+    }
+    return ::operator new(index * GRANULE);
+}
+
+void FramePool::deallocate(void *frame, const std::size_t size) noexcept {
+    const auto index = sizeClass(size);
+    if (index >= SIZE_CLASSES || cacheClosed || cache.counts[index] >= MAX_CACHED) {
+        ::operator delete(frame);
+        return;
+    }
+    cache.heads[index] = new(frame) FreeFrame{cache.heads[index]};
+    cache.counts[index]++;
+}
@@ -0,0 +1,155 @@
+﻿#include "GameClient.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    [[noreturn]] void throwSystemError(const std::string &what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+}
+
+GameClient::GameClient(const int fd) : fd_(fd), consumed_(0) {
+}
+
+GameClient GameClient::connectTcp(const std::string &host, const std::uint16_t port) {
+    const auto fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throwSystemError("socket");
+    GameClient client(fd);
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        throw std::runtime_error("invalid address: " + host);
+    }
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) throwSystemError("connect");
+
+    constexpr auto noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return client;
+}
+
+GameClient GameClient::connectUnix(const std::string &path) {
+    const auto fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) throwSystemError("socket");
+    GameClient client(fd);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("unix socket path too long: " + path);
+    }
+    std::ranges::copy(path, address.sun_path);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) throwSystemError("connect");
+    return client;
+}
+
+GameClient::GameClient(GameClient &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)), in_(std::move(other.in_)), consumed_(other.consumed_),
+      out_(std::move(other.out_)) {
+}
+
+GameClient &GameClient::operator=(GameClient &&other) noexcept {
+    if (this != &other) {
+        if (fd_ >= 0) close(fd_);
+        fd_ = std::exchange(other.fd_, -1);
+        in_ = std::move(other.in_);
+        consumed_ = other.consumed_;
+        out_ = std::move(other.out_);
+    }
+    return *this;
+}
+
+GameClient::~GameClient() {
+    if (fd_ >= 0) close(fd_);
+}
+
+std::optional<Protocol::Frame> GameClient::receive() {
+    while (true) {
+        if (auto frame = poll()) {
+            return frame;
+        }
+        if (!fill()) {
+            return std::nullopt;
+        }
+    }
+}
+
+std::optional<Protocol::Frame> GameClient::poll() {
+    if (consumed_ > 0 && consumed_ * 2 >= in_.size()) {
+        in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(consumed_));
+        consumed_ = 0;
+    }
+    auto frame = Protocol::nextFrame(std::span(in_).subspan(consumed_));
+    if (frame) {
+        consumed_ += frame->size;
+    }
+    return frame;
+}
+
+bool GameClient::fill() {
+    std::array<std::uint8_t, 4096> chunk{};
+    while (true) {
+        const auto bytes = recv(fd_, chunk.data(), chunk.size(), 0);
+        if (bytes > 0) {
+            in_.insert(in_.end(), chunk.begin(), chunk.begin() + bytes);
+            return true;
+        }
+        if (bytes < 0 && errno == EINTR) continue;
+        if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd waiter{fd_, POLLIN, 0};
+            ::poll(&waiter, 1, -1);
+            continue;
+        }
+        return false;
+    }
+}
+
+bool GameClient::fillNonBlocking() {
+    std::array<std::uint8_t, 4096> chunk{};
+    while (true) {
+        const auto bytes = recv(fd_, chunk.data(), chunk.size(), MSG_DONTWAIT);
+        if (bytes > 0) {
+            in_.insert(in_.end(), chunk.begin(), chunk.begin() + bytes);
+            continue;
+        }
+        if (bytes < 0 && errno == EINTR) continue;
+        return bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+void GameClient::setNonBlocking() {
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+}
+
+int GameClient::getFd() const { return fd_; }
+
+void GameClient::writeAll() const {
+    std::size_t sent = 0;
+    while (sent < out_.size()) {
+        const auto bytes = ::send(fd_, out_.data() + sent, out_.size() - sent, MSG_NOSIGNAL);
+        if (bytes > 0) {
+            sent += static_cast<std::size_t>(bytes);
+        } else if (bytes < 0 && errno == EINTR) {
+        } else if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd waiter{fd_, POLLOUT, 0};
+            ::poll(&waiter, 1, -1);
+        } else {
+            throwSystemError("send");
+        }
+    }
+}
@@ -4,39 +4,37 @@
 #include <iostream>
 #include <memory>
 
+#include "Console.h"
 #include "Player.h"
 
-GameManager::GameManager(const int maxRounds) : gameRunning_(true), roundsPlayed_(0), maxRounds_(maxRounds) {
+GameManager::GameManager(const int maxRounds, const bool historyRecorded)
+    : gameRunning_(true), saveRequested_(false), historyRecorded_(historyRecorded), roundsPlayed_(0),
+      maxRounds_(maxRounds), leaderboard_(std::make_unique<Leaderboard>()) {
 }
 
 void GameManager::displayGameStatus(const std::vector<std::unique_ptr<Player> > &players) const {
-    std::cout << "\n" << std::string(50, '=') << std::endl;
-    std::cout << "                   游戏状态" << std::endl;
-    std::cout << std::string(50, '=') << std::endl;
-    std::cout << "已进行回合: " << roundsPlayed_ << " / " << maxRounds_ << std::endl;
-    std::cout << "存活玩家: " << players.size() << " 人" << std::endl;
-
-    std::vector<std::pair<std::string, int> > playerRankings;
-    for (const auto &player: players) {
-        playerRankings.emplace_back(player->getName(), player->getChipCount());
-    }
+    Console::out() << "\n" << std::string(50, '=') << '\n';
+    Console::out() << "                   游戏状态" << '\n';
+    Console::out() << std::string(50, '=') << '\n';
+    Console::out() << "已进行回合: " << roundsPlayed_ << " / " << maxRounds_ << '\n';
+    Console::out() << "存活玩家: " << players.size() << " 人" << '\n';
 
-    std::ranges::sort(playerRankings,
-                      [](const auto &a, const auto &b) {
-                          return a.second > b.second;
-                      });
+    const auto playerRankings = leaderboard_->top(STANDINGS_SHOWN);
 
-    std::cout << "\n玩家筹码排行:" << std::endl;
+    Console::out() << "\n玩家筹码排行:" << '\n';
     for (size_t i = 0; i < playerRankings.size(); i++) {
-        std::cout << i + 1 << ". " << playerRankings[i].first
-                << ": " << playerRankings[i].second << " 筹码" << std::endl;
+        Console::out() << i + 1 << ". " << playerRankings[i].name
+                << ": " << playerRankings[i].chips << " 筹码" << '\n';
+    }
+    if (leaderboard_->size() > playerRankings.size()) {
+        Console::out() << "... 共 " << leaderboard_->size() << " 人" << '\n';
     }
-    std::cout << std::string(50, '=') << std::endl;
+    Console::out() << std::string(50, '=') << '\n';
 }
 
 bool GameManager::askToContinue() {
     if (roundsPlayed_ >= maxRounds_) {
-        std::cout << "\n⚠️  已达到最大回合数 (" << maxRounds_ << ")，游戏结束！" << std::endl;
+        Console::out() << "\n⚠️  已达到最大回合数 (" << maxRounds_ << ")，游戏结束！" << '\n';
         return false;
     }
 
@@ -46,12 +44,12 @@ bool GameManager::askToContinue() {
 
     char choice;
     while (true) {
-        std::cout << "\n是否继续下一回合？" << std::endl;
-        std::cout << "1. 继续游戏" << std::endl;
-        std::cout << "2. 显示游戏状态" << std::endl;
-        std::cout << "3. 保存并退出" << std::endl;
-        std::cout << "4. 立即退出" << std::endl;
-        std::cout << "请选择 (1-4): ";
+        Console::out() << "\n是否继续下一回合？" << '\n';
+        Console::out() << "1. 继续游戏" << '\n';
+        Console::out() << "2. 显示游戏状态" << '\n';
+        Console::out() << "3. 保存并退出" << '\n';
+        Console::out() << "4. 立即退出" << '\n';
+        Console::out() << "请选择 (1-4): ";
 
         std::cin >> choice;
 
@@ -63,13 +61,14 @@ bool GameManager::askToContinue() {
                 return askToContinue();
             case '3':
                 saveGameHistory();
+                saveRequested_ = true;
                 gameRunning_ = false;
                 return false;
             case '4':
                 gameRunning_ = false;
                 return false;
             default:
-                std::cout << "无效选择，请重新输入！" << std::endl;
+                Console::out() << "无效选择，请重新输入！" << '\n';
         }
     }
 }
@@ -78,40 +77,49 @@ void GameManager::recordRoundResult(const std::string &result) {
     gameHistory_.push_back("回合 " + std::to_string(roundsPlayed_) + ": " + result);
 }
 
+void GameManager::recordRoundWinner(const std::string &name) {
+    if (historyRecorded_) {
+        recordRoundResult(name + " 获胜");
+    }
+}
+
+void GameManager::recordRoundSplit(const std::size_t winners) {
+    if (historyRecorded_) {
+        recordRoundResult("平局: " + std::to_string(winners) + " 人");
+    }
+}
+
+void GameManager::recordChips(const Player &player) {
+    leaderboard_->update(player.getName(), player.getChipCount());
+}
+
+void GameManager::recordElimination(const Player &player) {
+    leaderboard_->remove(player.getName());
+}
+
+const Leaderboard &GameManager::getLeaderboard() const { return *leaderboard_; }
+
 void GameManager::saveGameHistory() const {
-    std::cout << "\n💾 保存游戏历史..." << std::endl;
-    std::cout << "=== 游戏历史 ===" << std::endl;
+    Console::out() << "\n💾 保存游戏历史..." << '\n';
+    Console::out() << "=== 游戏历史 ===" << '\n';
     for (const auto &record: gameHistory_) {
-        std::cout << record << std::endl;
+        Console::out() << record << '\n';
     }
-    std::cout << "================" << std::endl;
+    Console::out() << "================" << '\n';
 }
 
-void GameManager::displayGameOver(const std::vector<std::unique_ptr<Player> > &players) const {
-    std::cout << "\n" << std::string(50, '=') << std::endl;
-    std::cout << "                   🎯 游戏结束 🎯" << std::endl;
-    std::cout << std::string(50, '=') << std::endl;
-    std::cout << "总回合数: " << roundsPlayed_ << std::endl;
-
-    if (!players.empty()) {
-        const auto winner = std::ranges::max_element(players,
-                                                     [](const auto &a, const auto &b) {
-                                                         return a->getChipCount() < b->getChipCount();
-                                                     });
-
-        std::cout << "🏆 最终获胜者: " << (*winner)->getName()
-                << " (" << (*winner)->getChipCount() << " 筹码)" << std::endl;
-
-        std::cout << "\n最终排名:" << std::endl;
-        std::vector<std::pair<std::string, int> > finalRankings;
-        for (const auto &player: players) {
-            finalRankings.emplace_back(player->getName(), player->getChipCount());
-        }
+void GameManager::displayGameOver(const std::vector<std::unique_ptr<Player> > &) const {
+    Console::out() << "\n" << std::string(50, '=') << '\n';
+    Console::out() << "                   🎯 游戏结束 🎯" << '\n';
+    Console::out() << std::string(50, '=') << '\n';
+    Console::out() << "总回合数: " << roundsPlayed_ << '\n';
 
-        std::ranges::sort(finalRankings,
-                          [](const auto &a, const auto &b) {
-                              return a.second > b.second;
-                          });
+    if (const auto finalRankings = leaderboard_->top(STANDINGS_SHOWN); !finalRankings.empty()) {
+        const auto &winner = finalRankings.front();
+        Console::out() << "🏆 最终获胜者: " << winner.name
+                << " (" << winner.chips << " 筹码)" << '\n';
+
+        Console::out() << "\n最终排名:" << '\n';
 
         for (size_t i = 0; i < finalRankings.size(); i++) {
             std::string medal;
@@ -120,12 +128,12 @@ void GameManager::displayGameOver(const std::vector<std::unique_ptr<Player> > &p
             else if (i == 2) medal = "🥉";
             else medal = std::to_string(i + 1) + ".";
 
-            std::cout << medal << " " << finalRankings[i].first
-                    << ": " << finalRankings[i].second << " 筹码" << std::endl;
+            Console::out() << medal << " " << finalRankings[i].name
+                    << ": " << finalRankings[i].chips << " 筹码" << '\n';
         }
     }
 
-    std::cout << std::string(50, '=') << std::endl;
+    Console::out() << std::string(50, '=') << '\n';
 }
 
 bool GameManager::shouldEndGame(const std::vector<std::unique_ptr<Player> > &players) const {
@@ -141,4 +149,28 @@ bool GameManager::shouldEndGame(const std::vector<std::unique_ptr<Player> > &pla
 }
 
 int GameManager::getRoundsPlayed() const { return roundsPlayed_; }
+int GameManager::getMaxRounds() const { return maxRounds_; }
+bool GameManager::isSaveRequested() const { return saveRequested_; }
 void GameManager::endGame() { gameRunning_ = false; }
+
+void GameManager::save(const Checkpoint::Writer &writer) const {
+    writer.i32(roundsPlayed_);
+    writer.i32(maxRounds_);
+    writer.u32(static_cast<std::uint32_t>(gameHistory_.size()));
+    for (const auto &record: gameHistory_) {
+        writer.text(record);
+    }
+}
+
+bool GameManager::restore(Checkpoint::Reader &reader) {
+    roundsPlayed_ = reader.i32();
+    maxRounds_ = reader.i32();
+    const auto records = reader.u32();
+    gameHistory_.clear();
+    for (std::uint32_t i = 0; i < records && reader.ok(); i++) {
+        gameHistory_.push_back(reader.text());
+    }
+    gameRunning_ = true;
+    saveRequested_ = false;
+    return reader.ok() && roundsPlayed_ >= 0;
+}
@@ -0,0 +1,1066 @@
+﻿#include "GameServer.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "BankrollStore.h"
+#include "ComputerPlayer.h"
+#include "Console.h"
+#include "DecisionService.h"
+#include "HandAbstraction.h"
+#include "HandEvaluator.h"
+#include "PokerTable.h"
+#include "RemotePlayer.h"
+#include "SpectatorFeed.h"
+#include "TableObserver.h"
+#include "TableScheduler.h"
+#include "TimerWheel.h"
+#include "Tracer.h"
+
+namespace {
+    constexpr std::size_t READ_CHUNK = 4096;
+    constexpr std::size_t SPECTATOR_IOVECS = 64;
+
+    [[noreturn]] void throwSystemError(const std::string &what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    void watch(const int epoll, const int fd, const std::uint32_t events, const int operation = EPOLL_CTL_ADD) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll, operation, fd, &event) < 0) {
+            throwSystemError("epoll_ctl");
+        }
+    }
+
+    void signalEvent(const int fd) {
+        constexpr std::uint64_t one = 1;
+        [[maybe_unused]] const auto written = write(fd, &one, sizeof(one));
+    }
+
+    void drainEvent(const int fd) {
+        std::uint64_t value;
+        [[maybe_unused]] const auto bytes = read(fd, &value, sizeof(value));
+    }
+
+    Player::Decision autoDecision(const Player::DecisionView &view) {
+        return {view.currentBet > view.chipsCommitted ? Player::Action::FOLD : Player::Action::CHECK, 0};
+    }
+}
+
+class GameServer::Worker {
+public:
+    explicit Worker(GameServer &server);
+
+    ~Worker();
+
+    Worker(const Worker &) = delete;
+
+    Worker &operator=(const Worker &) = delete;
+
+    void adopt(int fd, Protocol::Join join, std::vector<std::uint8_t> leftover);
+
+    void adoptSpectator(int fd, std::uint32_t tableKey);
+
+    void stop();
+
+private:
+    struct Table;
+
+    class Audience;
+
+    struct Spectator {
+        int fd = -1;
+        Audience *audience = nullptr;
+        SpectatorFeed::Cursor cursor;
+        bool writeBlocked = false;
+    };
+
+    struct Connection {
+        int fd = -1;
+        std::vector<std::uint8_t> in;
+        std::vector<std::uint8_t> out;
+        RemotePlayer *player = nullptr;
+        Table *table = nullptr;
+        std::uint32_t sequence = 0;
+        bool dirty = false;
+        bool writeBlocked = false;
+        TimerWheel::Timer deadline;
+        Player::Decision timeoutDecision{};
+        int timeBankMs = 0;
+        bool onTimeBank = false;
+        TimerWheel::Clock::time_point bankStarted;
+    };
+
+    struct Table {
+        std::uint64_t id = 0;
+        std::uint32_t key = 0;
+        PokerTable poker;
+        std::vector<Connection *> seats;
+        Audience *audience = nullptr;
+        std::vector<std::uint64_t> accounts;
+        int humans = 0;
+        bool finished = false;
+        bool settlementRejected = false;
+    };
+
+    struct Handoff {
+        int fd;
+        Protocol::Join join;
+        std::vector<std::uint8_t> leftover;
+        bool spectate;
+    };
+
+    GameServer &server_;
+    int epoll_;
+    int wakeEvent_;
+    TimerWheel timers_;
+    std::unordered_map<int, std::unique_ptr<Connection> > connections_;
+    std::unordered_map<std::uint64_t, std::unique_ptr<Table> > tables_;
+    std::unordered_map<std::uint32_t, Table *> filling_;
+    TableScheduler scheduler_;
+    std::vector<Connection *> dirty_;
+    std::unordered_map<std::uint32_t, std::unique_ptr<Audience> > audiences_;
+    std::unordered_map<int, std::unique_ptr<Spectator> > spectators_;
+    std::vector<Audience *> dirtyAudiences_;
+    std::vector<BankrollStore::Transfer> transfers_;
+    std::mutex handoffMutex_;
+    std::vector<Handoff> handoffs_;
+    std::uint64_t nextTableId_;
+    std::thread thread_;
+
+    void loop();
+
+    void drainHandoffs();
+
+    void seat(Connection &connection, const Protocol::Join &join);
+
+    void settle(Table &table, std::span<const PokerTable::Settlement> settlements);
+
+    void startTable(Table &table);
+
+    Task<> runTable(Table &table);
+
+    void updateSeats(Table &table, std::uint32_t handsPlayed);
+
+    void closeTable(Table &table);
+
+    void sendDecisionRequest(Connection &connection, const RemotePlayer &player, const Player::DecisionView &view);
+
+    void onDecisionTimeout(Connection &connection);
+
+    void onDecisionReceived(Connection &connection);
+
+    bool onReadable(Connection &connection);
+
+    bool handleFrames(Connection &connection);
+
+    void markDirty(Connection &connection);
+
+    bool flush(Connection &connection);
+
+    void flushDirty();
+
+    void closeConnection(int fd);
+
+    void detach(Connection &connection);
+
+    void reapTables();
+
+    int humansPerTable() const;
+
+    Audience &audienceFor(std::uint32_t tableKey);
+
+    void attachAudience(Table &table, Audience &audience);
+
+    void releaseAudience(Audience &audience);
+
+    void watchTable(std::uint32_t tableKey, int fd);
+
+    void markDirty(Audience &audience);
+
+    bool onSpectatorEvent(Spectator &spectator, std::uint32_t events);
+
+    bool flush(Spectator &spectator);
+
+    void flushAudiences();
+
+    void closeSpectator(int fd);
+};
+
+class GameServer::Worker::Audience final : public TableObserver {
+public:
+    Audience(Worker &worker, std::uint32_t key);
+
+    void onHandStarted(const std::vector<std::unique_ptr<Player> > &players, std::size_t button, int pot) override;
+
+    void onAction(const std::string &playerName, Player::Action action, int amount, int pot, int street) override;
+
+    void onStreet(int street, const std::vector<Card> &communityCards, int pot) override;
+
+    void onShowdown(const std::string &playerName, const std::vector<Card> &holeCards) override;
+
+    Worker &worker;
+    std::uint32_t key;
+    SpectatorFeed feed;
+    std::vector<Spectator *> spectators;
+    std::uint32_t handsStarted = 0;
+    Table *table = nullptr;
+    bool midHand = false;
+    bool dirty = false;
+
+private:
+    template<typename Message>
+    void publish(const Message &message, const bool keyframe) {
+        if (spectators.empty() || (midHand && !keyframe)) {
+            return;
+        }
+        midHand = false;
+        auto buffer = std::make_shared<std::vector<std::uint8_t> >();
+        Protocol::encode(*buffer, message);
+        feed.publish(std::move(buffer), keyframe);
+        worker.markDirty(*this);
+    }
+};
+
+GameServer::Worker::Audience::Audience(Worker &worker, const std::uint32_t key) : worker(worker), key(key) {
+}
+
+void GameServer::Worker::Audience::onHandStarted(const std::vector<std::unique_ptr<Player> > &players,
+                                                 const std::size_t button, const int pot) {
+    Protocol::HandStarted message{++handsStarted, static_cast<std::uint8_t>(button), pot, {}};
+    for (const auto &player: players) {
+        message.seats.push_back({player->getName(), player->getChipCount()});
+    }
+    publish(message, true);
+}
+
+void GameServer::Worker::Audience::onAction(const std::string &playerName, const Player::Action action,
+                                            const int amount, int, const int street) {
+    publish(Protocol::ActionNotice{playerName, action, amount, static_cast<std::uint8_t>(street)}, false);
+}
+
+void GameServer::Worker::Audience::onStreet(const int street, const std::vector<Card> &communityCards,
+                                            const int pot) {
+    Protocol::StreetDealt message{static_cast<std::uint8_t>(street), pot, 0, {}};
+    for (const auto &card: communityCards) {
+        if (message.boardCount == message.board.size()) break;
+        message.board[message.boardCount++] = static_cast<std::uint8_t>(HandEvaluator::cardIndex(card));
+    }
+    publish(message, false);
+}
+
+void GameServer::Worker::Audience::onShowdown(const std::string &playerName, const std::vector<Card> &holeCards) {
+    Protocol::Showdown message{playerName, 0, {}};
+    for (const auto &card: holeCards) {
+        if (message.holeCount == message.holeCards.size()) break;
+        message.holeCards[message.holeCount++] = static_cast<std::uint8_t>(HandEvaluator::cardIndex(card));
+    }
+    publish(message, false);
+}
+
+namespace {
+    thread_local const void *runningWorker = nullptr;
+}
+
+GameServer::Worker::Worker(GameServer &server)
+    : server_(server), epoll_(epoll_create1(EPOLL_CLOEXEC)), wakeEvent_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      nextTableId_(0) {
+    if (epoll_ < 0 || wakeEvent_ < 0) {
+        throwSystemError("worker setup");
+    }
+    watch(epoll_, wakeEvent_, EPOLLIN);
+    scheduler_.setNotifier([this] {
+        if (runningWorker != this) {
+            signalEvent(wakeEvent_);
+        }
+    });
+    thread_ = std::thread(&Worker::loop, this);
+}
+
+GameServer::Worker::~Worker() {
+    stop();
+    for (const auto &fd: connections_ | std::views::keys) {
+        close(fd);
+    }
+    for (const auto &fd: spectators_ | std::views::keys) {
+        close(fd);
+    }
+    for (const auto &handoff: handoffs_) {
+        close(handoff.fd);
+    }
+    close(wakeEvent_);
+    close(epoll_);
+}
+
+void GameServer::Worker::adopt(const int fd, Protocol::Join join, std::vector<std::uint8_t> leftover) {
+    {
+        std::lock_guard lock(handoffMutex_);
+        handoffs_.push_back({fd, std::move(join), std::move(leftover), false});
+    }
+    signalEvent(wakeEvent_);
+}
+
+void GameServer::Worker::adoptSpectator(const int fd, const std::uint32_t tableKey) {
+    {
+        std::lock_guard lock(handoffMutex_);
+        handoffs_.push_back({fd, {tableKey, {}}, {}, true});
+    }
+    signalEvent(wakeEvent_);
+}
+
+void GameServer::Worker::stop() {
+    if (thread_.joinable()) {
+        signalEvent(wakeEvent_);
+        thread_.join();
+    }
+}
+
+void GameServer::Worker::loop() {
+    Console::setQuiet(true);
+    runningWorker = this;
+    POKER_TRACE_THREAD("server worker");
+
+    std::array<epoll_event, 256> events{};
+    while (server_.running_.load(std::memory_order_acquire)) {
+        const auto timeout = timers_.nextTimeoutMs(TimerWheel::Clock::now());
+        const auto count = epoll_wait(epoll_, events.data(), static_cast<int>(events.size()), timeout);
+        if (count < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (auto i = 0; i < count; i++) {
+            const auto fd = events[i].data.fd;
+            if (fd == wakeEvent_) {
+                drainEvent(fd);
+                drainHandoffs();
+                continue;
+            }
+
+            const auto found = connections_.find(fd);
+            if (found == connections_.end()) {
+                if (const auto spectator = spectators_.find(fd);
+                    spectator != spectators_.end() && !onSpectatorEvent(*spectator->second, events[i].events)) {
+                    closeSpectator(fd);
+                }
+                continue;
+            }
+            auto &connection = *found->second;
+            if (events[i].events & EPOLLOUT && !flush(connection)) {
+                closeConnection(fd);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR) && !onReadable(connection)) {
+                closeConnection(fd);
+            }
+        }
+
+        timers_.advance(TimerWheel::Clock::now());
+        while (scheduler_.runOnce(false)) {
+        }
+        reapTables();
+        flushDirty();
+        flushAudiences();
+    }
+}
+
+void GameServer::Worker::drainHandoffs() {
+    std::vector<Handoff> handoffs;
+    {
+        std::lock_guard lock(handoffMutex_);
+        handoffs.swap(handoffs_);
+    }
+
+    for (auto &[fd, join, leftover, spectate]: handoffs) {
+        if (spectate) {
+            watchTable(join.tableKey, fd);
+            continue;
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->in = std::move(leftover);
+        auto &ref = *connection;
+        connections_.emplace(fd, std::move(connection));
+        watch(epoll_, fd, EPOLLIN);
+        seat(ref, join);
+        if (!handleFrames(ref)) {
+            closeConnection(fd);
+        }
+    }
+}
+
+int GameServer::Worker::humansPerTable() const {
+    return std::max(1, server_.config_.seatsPerTable - server_.config_.botsPerTable);
+}
+
+void GameServer::Worker::seat(Connection &connection, const Protocol::Join &join) {
+    const auto name = join.name.empty() ? std::string("Player") : join.name;
+    const auto account = BankrollStore::accountId(name);
+    if (server_.bankroll_ && !server_.bankroll_->buyIn(account, server_.config_.initialChips,
+                                                       server_.config_.initialChips)) {
+        Protocol::encode(connection.out, Protocol::TableClosed{0});
+        markDirty(connection);
+        return;
+    }
+
+    auto &table = filling_[join.tableKey];
+    if (!table) {
+        auto created = std::make_unique<Table>();
+        created->id = nextTableId_++;
+        created->key = join.tableKey;
+        created->poker.setHistoryRecorded(false);
+        if (auto &audience = audienceFor(join.tableKey); !audience.table) {
+            attachAudience(*created, audience);
+        }
+        if (server_.bankroll_) {
+            created->poker.setSettlementHandler(
+                [this, owner = created.get()](const std::span<const PokerTable::Settlement> settlements) {
+                    settle(*owner, settlements);
+                });
+        }
+        table = created.get();
+        tables_.emplace(created->id, std::move(created));
+    }
+
+    if (server_.bankroll_) {
+        table->accounts.push_back(account);
+    }
+    auto remote = std::make_unique<RemotePlayer>(name, server_.config_.initialChips);
+    remote->setDecisionRequestHandler([this, &connection](RemotePlayer &player, const Player::DecisionView &view) {
+        sendDecisionRequest(connection, player, view);
+    });
+    remote->setActionObserver([this, &connection](const std::string &name, const Player::Action action,
+                                                  const int amount, const int street) {
+        Protocol::encode(connection.out, Protocol::ActionNotice{
+                             name, action, amount, static_cast<std::uint8_t>(street)
+                         });
+        markDirty(connection);
+    });
+
+    connection.player = remote.get();
+    connection.table = table;
+    connection.timeBankMs = server_.config_.timeBankMs;
+    connection.deadline.setCallback([this, &connection] { onDecisionTimeout(connection); });
+    table->poker.addPlayer(std::move(remote));
+    table->seats.push_back(&connection);
+
+    Protocol::encode(connection.out, Protocol::Joined{
+                         join.tableKey, static_cast<std::uint8_t>(table->poker.getPlayers().size() - 1)
+                     });
+    markDirty(connection);
+
+    if (++table->humans >= humansPerTable()) {
+        filling_.erase(join.tableKey);
+        startTable(*table);
+    }
+}
+
+void GameServer::Worker::settle(Table &table, const std::span<const PokerTable::Settlement> settlements) {
+    transfers_.clear();
+    for (const auto &[player, delta]: settlements) {
+        if (delta != 0) {
+            transfers_.push_back({
+                player->isHuman()
+                    ? BankrollStore::escrowAccount(BankrollStore::accountId(player->getName()))
+                    : BankrollStore::HOUSE_ACCOUNT,
+                delta
+            });
+        }
+    }
+    if (!transfers_.empty() && !server_.bankroll_->settle(transfers_)) {
+        table.settlementRejected = true;
+        server_.settlementsRejected_++;
+    }
+}
+
+void GameServer::Worker::startTable(Table &table) {
+    for (auto bot = 0; bot < server_.config_.botsPerTable; bot++) {
+        auto player = std::make_unique<ComputerPlayer>("Bot " + std::to_string(bot + 1), server_.config_.initialChips);
+        player->setDecisionService(server_.decisionService_);
+        player->setHandAbstraction(server_.abstraction_);
+        table.poker.addPlayer(std::move(player));
+    }
+    server_.tablesOpened_++;
+    scheduler_.spawn(runTable(table));
+}
+
+Task<> GameServer::Worker::runTable(Table &table) {
+    for (auto hand = 0; hand < server_.config_.handsPerTable && table.poker.getPlayers().size() > 1 &&
+                        !table.settlementRejected; hand++) {
+        co_await table.poker.playHandsAsync(1);
+        server_.handsPlayed_++;
+        updateSeats(table, static_cast<std::uint32_t>(hand + 1));
+    }
+    closeTable(table);
+}
+
+void GameServer::Worker::updateSeats(Table &table, const std::uint32_t handsPlayed) {
+    const auto &players = table.poker.getPlayers();
+    for (auto it = table.seats.begin(); it != table.seats.end();) {
+        auto &connection = **it;
+        const auto seated = std::ranges::any_of(players, [&connection](const std::unique_ptr<Player> &player) {
+            return player.get() == connection.player;
+        });
+        if (seated) {
+            Protocol::encode(connection.out, Protocol::ChipUpdate{connection.player->getChipCount(), handsPlayed});
+            ++it;
+        } else {
+            Protocol::encode(connection.out, Protocol::TableClosed{0});
+            connection.player = nullptr;
+            connection.table = nullptr;
+            it = table.seats.erase(it);
+        }
+        markDirty(connection);
+    }
+}
+
+void GameServer::Worker::closeTable(Table &table) {
+    for (auto *connection: table.seats) {
+        Protocol::encode(connection->out, Protocol::TableClosed{connection->player->getChipCount()});
+        connection->player = nullptr;
+        connection->table = nullptr;
+        markDirty(*connection);
+    }
+    table.seats.clear();
+    if (server_.bankroll_) {
+        for (const auto account: table.accounts) {
+            server_.bankroll_->cashOut(account);
+        }
+        table.accounts.clear();
+    }
+    table.finished = true;
+    table.poker.setObserver(nullptr);
+    if (auto *audience = std::exchange(table.audience, nullptr)) {
+        audience->table = nullptr;
+        for (const auto &other: tables_ | std::views::values) {
+            if (!other->finished && !other->audience && other->key == table.key) {
+                attachAudience(*other, *audience);
+                break;
+            }
+        }
+        releaseAudience(*audience);
+    }
+}
+
+void GameServer::Worker::sendDecisionRequest(Connection &connection, const RemotePlayer &player,
+                                             const Player::DecisionView &view) {
+    Protocol::DecisionRequest request{};
+    request.sequence = ++connection.sequence;
+    request.currentBet = view.currentBet;
+    request.chipsCommitted = view.chipsCommitted;
+    request.pot = view.pot;
+    request.chipCount = player.getChipCount();
+    request.street = static_cast<std::uint8_t>(view.street);
+    request.opponents = static_cast<std::uint8_t>(view.opponents);
+    for (const auto &card: player.getHoleCards()) {
+        if (request.holeCount == request.holeCards.size()) break;
+        request.holeCards[request.holeCount++] = static_cast<std::uint8_t>(HandEvaluator::cardIndex(card));
+    }
+    for (const auto &card: view.communityCards) {
+        if (request.boardCount == request.board.size()) break;
+        request.board[request.boardCount++] = static_cast<std::uint8_t>(HandEvaluator::cardIndex(card));
+    }
+
+    if (server_.config_.decisionTimeoutMs > 0) {
+        request.timeLimitMs = static_cast<std::uint32_t>(server_.config_.decisionTimeoutMs);
+        request.timeBankMs = static_cast<std::uint32_t>(connection.timeBankMs);
+        connection.timeoutDecision = autoDecision(view);
+        connection.onTimeBank = false;
+        timers_.schedule(connection.deadline, std::chrono::milliseconds(server_.config_.decisionTimeoutMs));
+    }
+
+    Protocol::encode(connection.out, request);
+    markDirty(connection);
+}
+
+void GameServer::Worker::onDecisionTimeout(Connection &connection) {
+    if (!connection.player || !connection.player->isAwaitingDecision()) {
+        return;
+    }
+    if (!connection.onTimeBank && connection.timeBankMs > 0) {
+        connection.onTimeBank = true;
+        connection.bankStarted = TimerWheel::Clock::now();
+        timers_.schedule(connection.deadline, std::chrono::milliseconds(connection.timeBankMs));
+        return;
+    }
+    if (connection.onTimeBank) {
+        connection.timeBankMs = 0;
+        connection.onTimeBank = false;
+    }
+    server_.decisionTimeouts_++;
+    connection.player->deliver(connection.timeoutDecision);
+}
+
+void GameServer::Worker::onDecisionReceived(Connection &connection) {
+    if (connection.onTimeBank) {
+        const auto used = std::chrono::duration_cast<std::chrono::milliseconds>(
+            TimerWheel::Clock::now() - connection.bankStarted);
+        connection.timeBankMs = std::max(0, connection.timeBankMs - static_cast<int>(used.count()));
+        connection.onTimeBank = false;
+    }
+    timers_.cancel(connection.deadline);
+}
+
+bool GameServer::Worker::onReadable(Connection &connection) {
+    POKER_TRACE_SCOPE("recv", connection.fd);
+    std::array<std::uint8_t, READ_CHUNK> chunk{};
+    while (true) {
+        const auto bytes = recv(connection.fd, chunk.data(), chunk.size(), 0);
+        if (bytes > 0) {
+            connection.in.insert(connection.in.end(), chunk.begin(), chunk.begin() + bytes);
+            continue;
+        }
+        if (bytes == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+    return handleFrames(connection);
+}
+
+bool GameServer::Worker::handleFrames(Connection &connection) {
+    std::size_t offset = 0;
+    while (const auto frame = Protocol::nextFrame(std::span(connection.in).subspan(offset))) {
+        offset += frame->size;
+        if (Protocol::Action action{}; frame->type == Protocol::MessageType::ACTION &&
+                                       Protocol::decode(frame->payload, action) &&
+                                       action.sequence == connection.sequence) {
+            server_.actionsReceived_++;
+            if (connection.player && connection.player->deliver({action.action, action.raiseAmount})) {
+                onDecisionReceived(connection);
+            }
+        }
+    }
+    connection.in.erase(connection.in.begin(), connection.in.begin() + static_cast<std::ptrdiff_t>(offset));
+    return connection.in.size() <= Protocol::HEADER_SIZE + Protocol::MAX_PAYLOAD;
+}
+
+void GameServer::Worker::markDirty(Connection &connection) {
+    if (!connection.dirty) {
+        connection.dirty = true;
+        dirty_.push_back(&connection);
+    }
+}
+
+bool GameServer::Worker::flush(Connection &connection) {
+    POKER_TRACE_SCOPE("send", connection.fd);
+    std::size_t sent = 0;
+    while (sent < connection.out.size()) {
+        const auto bytes = send(connection.fd, connection.out.data() + sent, connection.out.size() - sent,
+                                MSG_NOSIGNAL);
+        if (bytes > 0) {
+            sent += static_cast<std::size_t>(bytes);
+        } else if (bytes < 0 && errno == EINTR) {
+        } else if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    connection.out.erase(connection.out.begin(), connection.out.begin() + static_cast<std::ptrdiff_t>(sent));
+
+    if (const auto blocked = !connection.out.empty(); blocked != connection.writeBlocked) {
+        connection.writeBlocked = blocked;
+        watch(epoll_, connection.fd, blocked ? EPOLLIN | EPOLLOUT : EPOLLIN, EPOLL_CTL_MOD);
+    }
+    return true;
+}
+
+void GameServer::Worker::flushDirty() {
+    std::vector<int> failed;
+    for (auto *connection: dirty_) {
+        connection->dirty = false;
+        if (!flush(*connection)) {
+            failed.push_back(connection->fd);
+        }
+    }
+    dirty_.clear();
+    for (const auto fd: failed) {
+        closeConnection(fd);
+    }
+}
+
+void GameServer::Worker::closeConnection(const int fd) {
+    const auto found = connections_.find(fd);
+    if (found == connections_.end()) {
+        return;
+    }
+    auto &connection = *found->second;
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    detach(connection);
+    std::erase(dirty_, &connection);
+    connections_.erase(found);
+}
+
+void GameServer::Worker::detach(Connection &connection) {
+    if (connection.deadline.isArmed()) {
+        onDecisionReceived(connection);
+    }
+    if (auto *player = connection.player) {
+        player->setActionObserver(nullptr);
+        player->setDecisionRequestHandler([](RemotePlayer &self, const Player::DecisionView &view) {
+            self.deliver(autoDecision(view));
+        });
+        if (player->isAwaitingDecision()) {
+            player->deliver({Player::Action::FOLD, 0});
+        }
+        connection.player = nullptr;
+    }
+    if (connection.table) {
+        std::erase(connection.table->seats, &connection);
+        connection.table = nullptr;
+    }
+}
+
+void GameServer::Worker::reapTables() {
+    std::erase_if(tables_, [](const auto &entry) { return entry.second->finished; });
+}
+
+GameServer::Worker::Audience &GameServer::Worker::audienceFor(const std::uint32_t tableKey) {
+    auto &audience = audiences_[tableKey];
+    if (!audience) {
+        audience = std::make_unique<Audience>(*this, tableKey);
+    }
+    return *audience;
+}
+
+void GameServer::Worker::attachAudience(Table &table, Audience &audience) {
+    table.audience = &audience;
+    audience.table = &table;
+    audience.midHand = true;
+    table.poker.setObserver(&audience);
+}
+
+void GameServer::Worker::releaseAudience(Audience &audience) {
+    if (!audience.table && audience.spectators.empty()) {
+        std::erase(dirtyAudiences_, &audience);
+        audiences_.erase(audience.key);
+    }
+}
+
+void GameServer::Worker::watchTable(const std::uint32_t tableKey, const int fd) {
+    auto &audience = audienceFor(tableKey);
+    auto spectator = std::make_unique<Spectator>();
+    spectator->fd = fd;
+    spectator->audience = &audience;
+    spectator->cursor = audience.feed.subscribe();
+    audience.spectators.push_back(spectator.get());
+    spectators_.emplace(fd, std::move(spectator));
+    watch(epoll_, fd, EPOLLIN);
+    server_.spectators_++;
+    markDirty(audience);
+}
+
+void GameServer::Worker::markDirty(Audience &audience) {
+    if (!audience.dirty) {
+        audience.dirty = true;
+        dirtyAudiences_.push_back(&audience);
+    }
+}
+
+bool GameServer::Worker::onSpectatorEvent(Spectator &spectator, const std::uint32_t events) {
+    if (events & EPOLLOUT && !flush(spectator)) {
+        return false;
+    }
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        std::array<std::uint8_t, READ_CHUNK> chunk{};
+        while (true) {
+            const auto bytes = recv(spectator.fd, chunk.data(), chunk.size(), 0);
+            if (bytes > 0 || (bytes < 0 && errno == EINTR)) continue;
+            return bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    return true;
+}
+
+bool GameServer::Worker::flush(Spectator &spectator) {
+    POKER_TRACE_SCOPE("send", spectator.fd);
+    const auto &feed = spectator.audience->feed;
+    std::array<std::span<const std::uint8_t>, SPECTATOR_IOVECS> pending;
+    std::array<iovec, SPECTATOR_IOVECS> vectors{};
+    const auto droppedBefore = spectator.cursor.dropped;
+    auto blocked = false;
+    while (!blocked) {
+        const auto count = feed.gather(spectator.cursor, pending);
+        if (count == 0) {
+            break;
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            vectors[i] = {const_cast<std::uint8_t *>(pending[i].data()), pending[i].size()};
+        }
+        msghdr message{};
+        message.msg_iov = vectors.data();
+        message.msg_iovlen = count;
+        const auto bytes = sendmsg(spectator.fd, &message, MSG_NOSIGNAL);
+        if (bytes > 0) {
+            feed.consume(spectator.cursor, static_cast<std::size_t>(bytes));
+        } else if (bytes < 0 && errno == EINTR) {
+        } else if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            blocked = true;
+        } else {
+            return false;
+        }
+    }
+    server_.spectatorEventsDropped_ += spectator.cursor.dropped - droppedBefore;
+
+    if (blocked != spectator.writeBlocked) {
+        spectator.writeBlocked = blocked;
+        watch(epoll_, spectator.fd, blocked ? EPOLLIN | EPOLLOUT : EPOLLIN, EPOLL_CTL_MOD);
+    }
+    return true;
+}
+
+void GameServer::Worker::flushAudiences() {
+    std::vector<int> failed;
+    for (auto *audience: dirtyAudiences_) {
+        audience->dirty = false;
+        for (auto *spectator: audience->spectators) {
+            if (!spectator->writeBlocked && !flush(*spectator)) {
+                failed.push_back(spectator->fd);
+            }
+        }
+    }
+    dirtyAudiences_.clear();
+    for (const auto fd: failed) {
+        closeSpectator(fd);
+    }
+}
+
+void GameServer::Worker::closeSpectator(const int fd) {
+    const auto found = spectators_.find(fd);
+    if (found == spectators_.end()) {
+        return;
+    }
+    auto &audience = *found->second->audience;
+    epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    std::erase(audience.spectators, found->second.get());
+    spectators_.erase(found);
+    server_.spectators_--;
+    releaseAudience(audience);
+}
+
+GameServer::GameServer(Config config)
+    : config_(std::move(config)), tcpListener_(-1), unixListener_(-1), acceptEpoll_(-1), stopEvent_(-1),
+      boundPort_(0), running_(false), tablesOpened_(0), handsPlayed_(0), actionsReceived_(0),
+      connectionsAccepted_(0), decisionTimeouts_(0), spectators_(0), spectatorEventsDropped_(0),
+      settlementsRejected_(0) {
+}
+
+GameServer::~GameServer() {
+    stop();
+}
+
+void GameServer::start() {
+    if (running_) {
+        return;
+    }
+
+    if (!config_.bankrollPath.empty() && !bankroll_) {
+        bankroll_ = std::make_unique<BankrollStore>(config_.bankrollPath);
+    }
+    if (config_.decisionService && !decisionService_) {
+        decisionService_ = std::make_shared<DecisionService>();
+    }
+    if (!config_.abstractionPath.empty() && !abstraction_) {
+        abstraction_ = std::make_shared<const HandAbstraction>(config_.abstractionPath);
+    }
+
+    acceptEpoll_ = epoll_create1(EPOLL_CLOEXEC);
+    stopEvent_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (acceptEpoll_ < 0 || stopEvent_ < 0) {
+        throwSystemError("acceptor setup");
+    }
+    watch(acceptEpoll_, stopEvent_, EPOLLIN);
+
+    if (config_.enableTcp) {
+        tcpListener_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (tcpListener_ < 0) throwSystemError("socket");
+        constexpr auto reuse = 1;
+        setsockopt(tcpListener_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(config_.tcpPort);
+        if (inet_pton(AF_INET, config_.bindAddress.c_str(), &address.sin_addr) != 1) {
+            throw std::runtime_error("invalid bind address: " + config_.bindAddress);
+        }
+        if (bind(tcpListener_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) throwSystemError("bind");
+        if (listen(tcpListener_, SOMAXCONN) < 0) throwSystemError("listen");
+
+        socklen_t length = sizeof(address);
+        getsockname(tcpListener_, reinterpret_cast<sockaddr *>(&address), &length);
+        boundPort_ = ntohs(address.sin_port);
+        watch(acceptEpoll_, tcpListener_, EPOLLIN);
+    }
+
+    if (!config_.unixPath.empty()) {
+        unixListener_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (unixListener_ < 0) throwSystemError("socket");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (config_.unixPath.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("unix socket path too long: " + config_.unixPath);
+        }
+        std::ranges::copy(config_.unixPath, address.sun_path);
+        unlink(config_.unixPath.c_str());
+        if (bind(unixListener_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) throwSystemError("bind");
+        if (listen(unixListener_, SOMAXCONN) < 0) throwSystemError("listen");
+        watch(acceptEpoll_, unixListener_, EPOLLIN);
+    }
+
+    running_ = true;
+    for (auto i = 0; i < std::max(1, config_.workers); i++) {
+        workers_.push_back(std::make_unique<Worker>(*this));
+    }
+    acceptor_ = std::thread(&GameServer::acceptLoop, this);
+}
+
+void GameServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    signalEvent(stopEvent_);
+    acceptor_.join();
+    workers_.clear();
+
+    for (const auto &fd: pending_ | std::views::keys) {
+        close(fd);
+    }
+    pending_.clear();
+    for (const auto fd: {tcpListener_, unixListener_, acceptEpoll_, stopEvent_}) {
+        if (fd >= 0) close(fd);
+    }
+    if (unixListener_ >= 0) {
+        unlink(config_.unixPath.c_str());
+    }
+    tcpListener_ = unixListener_ = acceptEpoll_ = stopEvent_ = -1;
+}
+
+std::uint16_t GameServer::getTcpPort() const { return boundPort_; }
+
+std::uint64_t GameServer::getTablesOpened() const { return tablesOpened_.load(); }
+
+std::uint64_t GameServer::getHandsPlayed() const { return handsPlayed_.load(); }
+
+std::uint64_t GameServer::getActionsReceived() const { return actionsReceived_.load(); }
+
+std::uint64_t GameServer::getConnectionsAccepted() const { return connectionsAccepted_.load(); }
+
+std::uint64_t GameServer::getDecisionTimeouts() const { return decisionTimeouts_.load(); }
+
+std::uint64_t GameServer::getSpectators() const { return spectators_.load(); }
+
+std::uint64_t GameServer::getSpectatorEventsDropped() const { return spectatorEventsDropped_.load(); }
+
+std::uint64_t GameServer::getSettlements() const { return bankroll_ ? bankroll_->getSettlements() : 0; }
+
+std::uint64_t GameServer::getSettlementsRejected() const { return settlementsRejected_.load(); }
+
+void GameServer::acceptLoop() {
+    std::array<epoll_event, 64> events{};
+    while (running_.load(std::memory_order_acquire)) {
+        const auto count = epoll_wait(acceptEpoll_, events.data(), static_cast<int>(events.size()), -1);
+        if (count < 0 && errno != EINTR) {
+            break;
+        }
+        for (auto i = 0; i < count; i++) {
+            if (const auto fd = events[i].data.fd; fd == stopEvent_) {
+                return;
+            } else if (fd == tcpListener_ || fd == unixListener_) {
+                acceptFrom(fd);
+            } else {
+                readJoin(fd);
+            }
+        }
+    }
+}
+
+void GameServer::acceptFrom(const int listener) {
+    while (true) {
+        const auto fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return;
+        }
+        if (listener == tcpListener_) {
+            constexpr auto noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        connectionsAccepted_++;
+        pending_[fd];
+        watch(acceptEpoll_, fd, EPOLLIN);
+    }
+}
+
+void GameServer::readJoin(const int fd) {
+    auto &buffer = pending_[fd].buffer;
+    std::array<std::uint8_t, READ_CHUNK> chunk{};
+    while (true) {
+        const auto bytes = recv(fd, chunk.data(), chunk.size(), 0);
+        if (bytes > 0) {
+            buffer.insert(buffer.end(), chunk.begin(), chunk.begin() + bytes);
+            continue;
+        }
+        if (bytes < 0 && errno == EINTR) continue;
+        if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        dropPending(fd);
+        return;
+    }
+
+    const auto frame = Protocol::nextFrame(buffer);
+    if (!frame) {
+        if (buffer.size() > Protocol::HEADER_SIZE + Protocol::MAX_PAYLOAD) dropPending(fd);
+        return;
+    }
+
+    if (Protocol::Spectate spectate{}; frame->type == Protocol::MessageType::SPECTATE &&
+                                       Protocol::decode(frame->payload, spectate)) {
+        epoll_ctl(acceptEpoll_, EPOLL_CTL_DEL, fd, nullptr);
+        pending_.erase(fd);
+        workers_[spectate.tableKey % workers_.size()]->adoptSpectator(fd, spectate.tableKey);
+        return;
+    }
+
+    Protocol::Join join;
+    if (frame->type != Protocol::MessageType::JOIN || !Protocol::decode(frame->payload, join)) {
+        dropPending(fd);
+        return;
+    }
+
+    epoll_ctl(acceptEpoll_, EPOLL_CTL_DEL, fd, nullptr);
+    std::vector leftover(buffer.begin() + static_cast<std::ptrdiff_t>(frame->size), buffer.end());
+    pending_.erase(fd);
+    workers_[join.tableKey % workers_.size()]->adopt(fd, std::move(join), std::move(leftover));
+}
+
+void GameServer::dropPending(const int fd) {
+    epoll_ctl(acceptEpoll_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    pending_.erase(fd);
+}
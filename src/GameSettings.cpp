@@ -2,7 +2,8 @@
 
 #include <iostream>
 
-GameSettings::GameSettings() : initialChips_(1000), maxRounds_(50), difficulty_(1) {
+GameSettings::GameSettings() : initialChips_(1000), maxRounds_(50), difficulty_(1),
+                               variant_(Variant::TEXAS_HOLDEM), historyRecorded_(true) {
 }
 
 void GameSettings::displaySettings() const {
@@ -10,6 +11,7 @@ void GameSettings::displaySettings() const {
     std::cout << "初始筹码: " << initialChips_ << std::endl;
     std::cout << "最大回合: " << maxRounds_ << std::endl;
     std::cout << "难度等级: " << difficulty_ << std::endl;
+    std::cout << "游戏类型: " << variantName(variant_) << std::endl;
     std::cout << "================" << std::endl;
 }
 
@@ -25,6 +27,11 @@ void GameSettings::configureSettings() {
     std::cout << "难度等级 (1-简单, 2-中等, 3-困难) (" << difficulty_ << "): ";
     std::cin >> difficulty_;
 
+    auto variant = variant_ == Variant::POT_LIMIT_OMAHA ? 2 : 1;
+    std::cout << "游戏类型 (1-德州扑克, 2-底池限注奥马哈) (" << variant << "): ";
+    std::cin >> variant;
+    variant_ = variant == 2 ? Variant::POT_LIMIT_OMAHA : Variant::TEXAS_HOLDEM;
+
     std::cout << "设置已更新！" << std::endl;
     displaySettings();
 }
@@ -34,3 +41,37 @@ int GameSettings::getInitialChips() const { return initialChips_; }
 int GameSettings::getMaxRounds() const { return maxRounds_; }
 
 int GameSettings::getDifficulty() const { return difficulty_; }
+
+GameSettings::Variant GameSettings::getVariant() const { return variant_; }
+
+void GameSettings::setVariant(const Variant variant) { variant_ = variant; }
+
+bool GameSettings::isHistoryRecorded() const { return historyRecorded_; }
+
+void GameSettings::setHistoryRecorded(const bool recorded) { historyRecorded_ = recorded; }
+
+int GameSettings::getHoleCardCount() const { return variant_ == Variant::POT_LIMIT_OMAHA ? 4 : 2; }
+
+void GameSettings::save(const Checkpoint::Writer &writer) const {
+    writer.i32(initialChips_);
+    writer.i32(maxRounds_);
+    writer.i32(difficulty_);
+    writer.u8(static_cast<std::uint8_t>(variant_));
+}
+
+bool GameSettings::restore(Checkpoint::Reader &reader) {
+    initialChips_ = reader.i32();
+    maxRounds_ = reader.i32();
+    difficulty_ = reader.i32();
+    const auto variant = reader.u8();
+    variant_ = variant == 1 ? Variant::POT_LIMIT_OMAHA : Variant::TEXAS_HOLDEM;
+    return reader.ok() && variant <= 1;
+}
+
+const char *GameSettings::variantName(const Variant variant) {
+    switch (variant) {
+        case Variant::TEXAS_HOLDEM: return "德州扑克";
+        case Variant::POT_LIMIT_OMAHA: return "底池限注奥马哈";
+    }
+    return "";
+}
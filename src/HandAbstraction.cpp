@@ -0,0 +1,462 @@
+﻿#include "HandAbstraction.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "HandEvaluator.h"
+
+namespace {
+    constexpr std::uint64_t CHUNK = 4096;
+    constexpr std::size_t EQUITY_LEVELS = 1 << 16;
+    constexpr std::size_t SEED_SAMPLE = 1 << 16;
+
+    [[noreturn]] void throwSystemError(const std::string &what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    double secondsSince(const std::chrono::steady_clock::time_point started) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    template<typename Body>
+    void parallelFor(const std::uint64_t count, const int threads, Body body) {
+        std::atomic<std::uint64_t> next = 0;
+        const auto run = [&](const int worker) {
+            for (auto begin = next.fetch_add(CHUNK); begin < count; begin = next.fetch_add(CHUNK)) {
+                body(begin, std::min(count, begin + CHUNK), worker);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (auto worker = 1; worker < threads; worker++) {
+            pool.emplace_back(run, worker);
+        }
+        run(0);
+        for (auto &thread: pool) {
+            thread.join();
+        }
+    }
+
+    HandEvaluator::CardMask drawCard(const HandEvaluator::CardMask dead, std::mt19937_64 &rng) {
+        while (true) {
+            if (const auto card = HandEvaluator::cardBit(static_cast<int>(rng() % 52)); !(dead & card)) {
+                return card;
+            }
+        }
+    }
+
+    double showdownEquity(const HandEvaluator::CardMask holeCards, const HandEvaluator::CardMask board,
+                          const int opponents, std::mt19937_64 &rng) {
+        const auto dead = holeCards | board;
+        const auto heroScore = HandEvaluator::evaluate(holeCards | board);
+        auto won = 0.0;
+        for (auto o = 0; o < opponents; o++) {
+            const auto first = drawCard(dead, rng);
+            const auto opponentCards = first | drawCard(dead | first, rng);
+            if (const auto score = HandEvaluator::evaluate(opponentCards | board); score < heroScore) {
+                won += 1.0;
+            } else if (score == heroScore) {
+                won += 0.5;
+            }
+        }
+        return won / opponents;
+    }
+
+    std::uint64_t chunkSeed(const std::uint64_t seed, const std::uint64_t begin) {
+        return seed ^ (begin + 1) * 0x9E3779B97F4A7C15ull;
+    }
+
+    std::vector<std::uint8_t> histogramFeatures(const HandAbstraction::BuildConfig &config,
+                                                const HandIndexer &indexer, const std::uint64_t count) {
+        const auto bins = static_cast<std::size_t>(config.bins);
+        std::vector<std::uint8_t> features(count * bins);
+        parallelFor(count, config.threads, [&](const std::uint64_t begin, const std::uint64_t end, int) {
+            std::mt19937_64 rng(chunkSeed(config.seed, begin));
+            std::array<HandEvaluator::CardMask, HandIndexer::MAX_ROUNDS> rounds{};
+            for (auto hand = begin; hand < end; hand++) {
+                indexer.unindex(indexer.getRounds() - 1, hand, rounds);
+                const auto holeCards = rounds[0];
+                const auto board = indexer.getRounds() > 1 ? rounds[1] : 0;
+                const auto histogram = features.data() + hand * bins;
+                const auto addSample = [&](const double equity) {
+                    histogram[std::min(bins - 1, static_cast<std::size_t>(equity * static_cast<double>(bins)))]++;
+                };
+
+                if (config.street == 2) {
+                    for (auto card = 0; card < 52; card++) {
+                        if (const auto river = HandEvaluator::cardBit(card); !((holeCards | board) & river)) {
+                            addSample(showdownEquity(holeCards, board | river, config.opponents, rng));
+                        }
+                    }
+                    continue;
+                }
+                for (auto rollout = 0; rollout < config.rollouts; rollout++) {
+                    auto runout = board;
+                    for (auto cards = std::popcount(board); cards < 5; cards++) {
+                        runout |= drawCard(holeCards | runout, rng);
+                    }
+                    addSample(showdownEquity(holeCards, runout, config.opponents, rng));
+                }
+            }
+        });
+        return features;
+    }
+
+    std::vector<std::uint16_t> clusterHistograms(const HandAbstraction::BuildConfig &config,
+                                                 const std::vector<std::uint8_t> &features, const std::uint64_t count,
+                                                 int &iterations) {
+        const auto bins = static_cast<std::size_t>(config.bins);
+        const auto k = static_cast<std::size_t>(config.buckets);
+        const auto meanBin = [&](const std::uint64_t hand) {
+            auto total = 0.0;
+            for (std::size_t bin = 0; bin < bins; bin++) {
+                total += static_cast<double>(bin * features[hand * bins + bin]);
+            }
+            return total;
+        };
+
+        std::vector<std::uint64_t> seeds;
+        const auto stride = std::max<std::uint64_t>(1, count / SEED_SAMPLE);
+        for (std::uint64_t hand = 0; hand < count; hand += stride) {
+            seeds.push_back(hand);
+        }
+        std::ranges::sort(seeds, {}, meanBin);
+        std::vector<float> centroids(k * bins);
+        for (std::size_t c = 0; c < k; c++) {
+            const auto hand = seeds[(2 * c + 1) * seeds.size() / (2 * k)];
+            std::copy_n(features.begin() + static_cast<std::ptrdiff_t>(hand * bins), bins,
+                        centroids.begin() + static_cast<std::ptrdiff_t>(c * bins));
+        }
+
+        std::vector<std::uint16_t> assignment(count, static_cast<std::uint16_t>(k));
+        const auto threads = static_cast<std::size_t>(config.threads);
+        std::vector<std::vector<double> > sums(threads, std::vector<double>(k * bins));
+        std::vector<std::vector<std::uint64_t> > sizes(threads, std::vector<std::uint64_t>(k));
+        for (iterations = 0; iterations < config.iterations;) {
+            iterations++;
+            for (std::size_t t = 0; t < threads; t++) {
+                std::ranges::fill(sums[t], 0.0);
+                std::ranges::fill(sizes[t], 0);
+            }
+            std::atomic<std::uint64_t> changed = 0;
+            parallelFor(count, config.threads, [&](const std::uint64_t begin, const std::uint64_t end,
+                                                   const int worker) {
+                auto &sum = sums[worker];
+                auto &size = sizes[worker];
+                std::uint64_t moved = 0;
+                for (auto hand = begin; hand < end; hand++) {
+                    const auto histogram = features.data() + hand * bins;
+                    auto best = 0.0f;
+                    std::size_t nearest = 0;
+                    for (std::size_t c = 0; c < k; c++) {
+                        const auto centroid = centroids.data() + c * bins;
+                        auto distance = 0.0f;
+                        for (std::size_t bin = 0; bin < bins; bin++) {
+                            const auto delta = static_cast<float>(histogram[bin]) - centroid[bin];
+                            distance += delta * delta;
+                        }
+                        if (c == 0 || distance < best) {
+                            best = distance;
+                            nearest = c;
+                        }
+                    }
+                    if (assignment[hand] != nearest) {
+                        assignment[hand] = static_cast<std::uint16_t>(nearest);
+                        moved++;
+                    }
+                    size[nearest]++;
+                    for (std::size_t bin = 0; bin < bins; bin++) {
+                        sum[nearest * bins + bin] += histogram[bin];
+                    }
+                }
+                changed += moved;
+            });
+
+            for (std::size_t c = 0; c < k; c++) {
+                std::uint64_t members = 0;
+                for (std::size_t t = 0; t < threads; t++) {
+                    members += sizes[t][c];
+                }
+                if (members == 0) {
+                    continue;
+                }
+                for (std::size_t bin = 0; bin < bins; bin++) {
+                    auto total = 0.0;
+                    for (std::size_t t = 0; t < threads; t++) {
+                        total += sums[t][c * bins + bin];
+                    }
+                    centroids[c * bins + bin] = static_cast<float>(total / static_cast<double>(members));
+                }
+            }
+            if (changed.load() * 1000 <= count) {
+                break;
+            }
+        }
+
+        std::vector<std::size_t> order(k);
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::ranges::sort(order, {}, [&](const std::size_t c) {
+            auto total = 0.0;
+            for (std::size_t bin = 0; bin < bins; bin++) {
+                total += static_cast<double>(bin) * centroids[c * bins + bin];
+            }
+            return total;
+        });
+        std::vector<std::uint16_t> relabel(k);
+        for (std::size_t rank = 0; rank < k; rank++) {
+            relabel[order[rank]] = static_cast<std::uint16_t>(rank);
+        }
+        parallelFor(count, config.threads, [&](const std::uint64_t begin, const std::uint64_t end, int) {
+            for (auto hand = begin; hand < end; hand++) {
+                assignment[hand] = relabel[assignment[hand]];
+            }
+        });
+        return assignment;
+    }
+
+    std::vector<std::uint16_t> riverEquities(const HandAbstraction::BuildConfig &config,
+                                             const HandIndexer &indexer, const std::uint64_t count) {
+        std::vector<std::uint16_t> equities(count);
+        const auto samples = std::max(1, config.rollouts * config.opponents);
+        parallelFor(count, config.threads, [&](const std::uint64_t begin, const std::uint64_t end, int) {
+            std::mt19937_64 rng(chunkSeed(config.seed, begin));
+            std::array<HandEvaluator::CardMask, HandIndexer::MAX_ROUNDS> rounds{};
+            for (auto hand = begin; hand < end; hand++) {
+                indexer.unindex(indexer.getRounds() - 1, hand, rounds);
+                const auto equity = showdownEquity(rounds[0], rounds[1], samples, rng);
+                equities[hand] = static_cast<std::uint16_t>(equity * (EQUITY_LEVELS - 1) + 0.5);
+            }
+        });
+        return equities;
+    }
+
+    void clusterEquities(const HandAbstraction::BuildConfig &config, std::vector<std::uint16_t> &equities,
+                         int &iterations) {
+        std::vector<std::uint64_t> weights(EQUITY_LEVELS);
+        for (const auto equity: equities) {
+            weights[equity]++;
+        }
+
+        const auto k = static_cast<std::size_t>(config.buckets);
+        std::vector<double> centroids(k);
+        std::uint64_t seen = 0;
+        for (std::size_t level = 0, c = 0; level < EQUITY_LEVELS && c < k; level++) {
+            seen += weights[level];
+            while (c < k && seen * 2 * k >= (2 * c + 1) * equities.size()) {
+                centroids[c++] = static_cast<double>(level);
+            }
+        }
+
+        std::vector<std::uint16_t> bucketOf(EQUITY_LEVELS);
+        for (iterations = 0; iterations < config.iterations;) {
+            iterations++;
+            std::vector<double> sums(k);
+            std::vector<std::uint64_t> sizes(k);
+            auto moved = false;
+            std::size_t nearest = 0;
+            for (std::size_t level = 0; level < EQUITY_LEVELS; level++) {
+                const auto value = static_cast<double>(level);
+                while (nearest + 1 < k &&
+                       std::abs(centroids[nearest + 1] - value) <= std::abs(centroids[nearest] - value)) {
+                    nearest++;
+                }
+                moved |= bucketOf[level] != nearest;
+                bucketOf[level] = static_cast<std::uint16_t>(nearest);
+                sums[nearest] += value * static_cast<double>(weights[level]);
+                sizes[nearest] += weights[level];
+            }
+            for (std::size_t c = 0; c < k; c++) {
+                if (sizes[c] > 0) {
+                    centroids[c] = sums[c] / static_cast<double>(sizes[c]);
+                }
+            }
+            if (!moved && iterations > 1) {
+                break;
+            }
+        }
+
+        parallelFor(equities.size(), config.threads, [&](const std::uint64_t begin, const std::uint64_t end, int) {
+            for (auto hand = begin; hand < end; hand++) {
+                equities[hand] = bucketOf[equities[hand]];
+            }
+        });
+    }
+
+    void writeBuckets(const std::string &path, const int street, const int buckets,
+                      const std::vector<std::uint16_t> &assignment) {
+        const BucketMap::Header header{
+            BucketMap::MAGIC, BucketMap::VERSION, static_cast<std::uint32_t>(street),
+            static_cast<std::uint32_t>(buckets), assignment.size()
+        };
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(assignment.data()),
+                  static_cast<std::streamsize>(assignment.size() * sizeof(std::uint16_t)));
+        if (!out.flush()) {
+            throw std::runtime_error("failed to write bucket map: " + path);
+        }
+    }
+}
+
+BucketMap::BucketMap(const std::string &path) : mapping_(nullptr), length_(0), header_(nullptr), buckets_(nullptr) {
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throwSystemError("open " + path);
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) < 0) {
+        ::close(fd);
+        throwSystemError("fstat " + path);
+    }
+    length_ = static_cast<std::size_t>(info.st_size);
+    mapping_ = length_ >= sizeof(Header) ? ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw std::runtime_error("cannot map bucket file: " + path);
+    }
+
+    header_ = static_cast<const Header *>(mapping_);
+    buckets_ = reinterpret_cast<const std::uint16_t *>(static_cast<const char *>(mapping_) + sizeof(Header));
+    if (header_->magic != MAGIC || header_->version != VERSION || header_->street > 3 ||
+        length_ != sizeof(Header) + header_->count * sizeof(std::uint16_t) ||
+        header_->count != HandIndexer::forStreet(static_cast<int>(header_->street)).getSize(
+            header_->street == 0 ? 0 : 1)) {
+        release();
+        throw std::runtime_error("invalid bucket file: " + path);
+    }
+    ::madvise(mapping_, length_, MADV_RANDOM);
+}
+
+BucketMap::~BucketMap() {
+    release();
+}
+
+BucketMap::BucketMap(BucketMap &&other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)), length_(std::exchange(other.length_, 0)),
+      header_(std::exchange(other.header_, nullptr)), buckets_(std::exchange(other.buckets_, nullptr)) {
+}
+
+BucketMap &BucketMap::operator=(BucketMap &&other) noexcept {
+    if (this != &other) {
+        release();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        length_ = std::exchange(other.length_, 0);
+        header_ = std::exchange(other.header_, nullptr);
+        buckets_ = std::exchange(other.buckets_, nullptr);
+    }
+    return *this;
+}
+
+int BucketMap::getStreet() const { return static_cast<int>(header_->street); }
+
+int BucketMap::getBuckets() const { return static_cast<int>(header_->buckets); }
+
+std::uint64_t BucketMap::size() const { return header_->count; }
+
+int BucketMap::bucket(const HandIndexer::Index index) const { return buckets_[index]; }
+
+int BucketMap::bucket(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards) const {
+    return buckets_[HandIndexer::forStreet(getStreet()).index(holeCards, communityCards)];
+}
+
+void BucketMap::release() {
+    if (mapping_) {
+        ::munmap(mapping_, length_);
+        mapping_ = nullptr;
+    }
+}
+
+HandAbstraction::HandAbstraction(const std::string &directory) {
+    for (auto street = 0; street < 4; street++) {
+        if (const auto path = std::filesystem::path(directory) / fileName(street); std::filesystem::exists(path)) {
+            maps_[street].emplace(path.string());
+        }
+    }
+}
+
+int HandAbstraction::bucket(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards) const {
+    const auto street = streetOf(communityCards.size());
+    if (holeCards.size() != 2 || street < 0 || !maps_[street]) {
+        return -1;
+    }
+    return maps_[street]->bucket(holeCards, communityCards);
+}
+
+double HandAbstraction::strength(const HandEvaluator::CardMask holeCards,
+                                 const HandEvaluator::CardMask communityCards) const {
+    const auto street = streetOf(static_cast<std::size_t>(std::popcount(communityCards)));
+    if (std::popcount(holeCards) != 2 || street < 0 || !maps_[street]) {
+        return -1.0;
+    }
+    const auto &map = *maps_[street];
+    const std::array rounds{holeCards, communityCards};
+    const auto index = HandIndexer::forStreet(street).index(std::span(rounds).first(street == 0 ? 1 : 2));
+    return map.getBuckets() > 1 ? static_cast<double>(map.bucket(index)) / (map.getBuckets() - 1) : 0.5;
+}
+
+bool HandAbstraction::hasStreet(const int street) const {
+    return street >= 0 && street < 4 && maps_[street].has_value();
+}
+
+HandAbstraction::BuildStats HandAbstraction::build(const BuildConfig &config, const std::string &path) {
+    if (config.street < 0 || config.street > 3 || config.buckets < 1 || config.buckets > 65535 ||
+        config.bins < 1 || config.threads < 1 || config.rollouts < 1 || config.rollouts > 255 ||
+        config.opponents < 1) {
+        throw std::invalid_argument("invalid abstraction build configuration");
+    }
+
+    const auto &indexer = HandIndexer::forStreet(config.street);
+    const auto count = indexer.getSize(indexer.getRounds() - 1);
+    BuildStats stats{count, 0, 0.0, 0.0};
+
+    auto started = std::chrono::steady_clock::now();
+    if (config.street == 3) {
+        auto buckets = riverEquities(config, indexer, count);
+        stats.featureSeconds = secondsSince(started);
+        started = std::chrono::steady_clock::now();
+        clusterEquities(config, buckets, stats.iterations);
+        stats.clusterSeconds = secondsSince(started);
+        writeBuckets(path, config.street, config.buckets, buckets);
+        return stats;
+    }
+
+    const auto features = histogramFeatures(config, indexer, count);
+    stats.featureSeconds = secondsSince(started);
+    started = std::chrono::steady_clock::now();
+    const auto buckets = clusterHistograms(config, features, count, stats.iterations);
+    stats.clusterSeconds = secondsSince(started);
+    writeBuckets(path, config.street, config.buckets, buckets);
+    return stats;
+}
+
+std::string HandAbstraction::fileName(const int street) {
+    static constexpr std::array names{"preflop.bkt", "flop.bkt", "turn.bkt", "river.bkt"};
+    return names[std::clamp(street, 0, 3)];
+}
+
+int HandAbstraction::streetOf(const std::size_t communityCards) {
+    switch (communityCards) {
+        case 0: return 0;
+        case 3: return 1;
+        case 4: return 2;
+        case 5: return 3;
+        default: return -1;
+    }
+}
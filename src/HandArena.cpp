@@ -0,0 +1,55 @@
+﻿#include "HandArena.h"
+
+#include <algorithm>
+#include <bit>
+#include <new>
+
+HandArena::HandArena(const std::size_t capacity)
+    : buffer_(std::make_unique<std::byte[]>(capacity)), capacity_(capacity), used_(0), highWater_(0),
+      overflowBytes_(0) {
+    overflow_.reserve(16);
+}
+
+HandArena::~HandArena() {
+    reset();
+}
+
+void HandArena::reset() {
+    for (const auto &[block, alignment]: overflow_) {
+        ::operator delete(block, std::align_val_t(alignment));
+    }
+    overflow_.clear();
+
+    if (overflowBytes_ > 0) {
+        capacity_ = std::bit_ceil(capacity_ + overflowBytes_);
+        buffer_ = std::make_unique<std::byte[]>(capacity_);
+        overflowBytes_ = 0;
+    }
+    used_ = 0;
+}
+
+std::size_t HandArena::getCapacity() const { return capacity_; }
+
+std::size_t HandArena::getHighWater() const { return highWater_; }
+
+void *HandArena::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+    const auto offset = (used_ + alignment - 1) & ~(alignment - 1);
+    if (offset + bytes <= capacity_) {
+        used_ = offset + bytes;
+        highWater_ = std::max(highWater_, used_);
+        return buffer_.get() + offset;
+    }
+
+    auto *block = ::operator new(bytes, std::align_val_t(alignment));
+    overflow_.push_back({block, alignment});
+    overflowBytes_ += bytes;
+    highWater_ = std::max(highWater_, capacity_ + overflowBytes_);
+    return block;
+}
+
+void HandArena::do_deallocate(void *, std::size_t, std::size_t) {
+}
+
+bool HandArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,293 @@
+﻿#include "HandEvaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace {
+    constexpr int highestBit(const std::uint32_t bits) {
+        return std::bit_width(bits) - 1;
+    }
+
+    constexpr std::uint32_t keepHighest(std::uint32_t bits, const int count) {
+        while (std::popcount(bits) > count) {
+            bits &= bits - 1;
+        }
+        return bits;
+    }
+
+    constexpr int packRanks(std::uint32_t bits) {
+        auto packed = 0;
+        while (bits) {
+            const auto top = highestBit(bits);
+            packed = packed << 4 | (top + 2);
+            bits &= ~(1u << top);
+        }
+        return packed;
+    }
+
+    constexpr int straightHigh(const std::uint32_t ranks) {
+        if (const auto run = ranks & ranks << 1 & ranks << 2 & ranks << 3 & ranks << 4; run) {
+            return highestBit(run);
+        }
+        if ((ranks & 0x100F) == 0x100F) {
+            return 3;
+        }
+        return -1;
+    }
+
+    constexpr int makeScore(const HandEvaluator::Category category, const int kickers) {
+        return static_cast<int>(category) << HandEvaluator::CATEGORY_SHIFT | kickers;
+    }
+
+    struct FiveCardTables {
+        std::array<int, HandEvaluator::RANK_BITS + 1> distinct{};
+        std::array<int, HandEvaluator::RANK_BITS + 1> packed{};
+    };
+
+    constexpr auto fiveCardTables = [] {
+        FiveCardTables tables;
+        for (std::uint32_t ranks = 0; ranks <= HandEvaluator::RANK_BITS; ranks++) {
+            if (std::popcount(ranks) > 5) {
+                continue;
+            }
+            tables.packed[ranks] = packRanks(ranks);
+            if (std::popcount(ranks) == 5) {
+                const auto high = straightHigh(ranks);
+                tables.distinct[ranks] = high >= 0
+                                             ? makeScore(HandEvaluator::Category::STRAIGHT, high + 2)
+                                             : makeScore(HandEvaluator::Category::HIGH_CARD, packRanks(ranks));
+            }
+        }
+        return tables;
+    }();
+
+    constexpr int FLUSH_UPGRADE = (static_cast<int>(HandEvaluator::Category::FLUSH) -
+                                   static_cast<int>(HandEvaluator::Category::HIGH_CARD)) << HandEvaluator::CATEGORY_SHIFT;
+    constexpr int STRAIGHT_FLUSH_UPGRADE = (static_cast<int>(HandEvaluator::Category::STRAIGHT_FLUSH) -
+                                            static_cast<int>(HandEvaluator::Category::STRAIGHT)) <<
+                                           HandEvaluator::CATEGORY_SHIFT;
+
+    struct RankGroups {
+        std::uint32_t ranks;
+        std::uint32_t pairs;
+        std::uint32_t trips;
+        std::uint32_t quads;
+        bool flush;
+    };
+
+    RankGroups groupRanks(const HandEvaluator::CardMask cards) {
+        const auto hearts = static_cast<std::uint32_t>(cards) & HandEvaluator::RANK_BITS;
+        const auto diamonds = static_cast<std::uint32_t>(cards >> HandEvaluator::SUIT_STRIDE) & HandEvaluator::RANK_BITS;
+        const auto clubs = static_cast<std::uint32_t>(cards >> 2 * HandEvaluator::SUIT_STRIDE) & HandEvaluator::RANK_BITS;
+        const auto spades = static_cast<std::uint32_t>(cards >> 3 * HandEvaluator::SUIT_STRIDE) & HandEvaluator::RANK_BITS;
+        const auto ranks = hearts | diamonds | clubs | spades;
+        return {
+            ranks,
+            (hearts & diamonds) | (hearts & clubs) | (hearts & spades) |
+            (diamonds & clubs) | (diamonds & spades) | (clubs & spades),
+            (hearts & diamonds & clubs) | (hearts & diamonds & spades) |
+            (hearts & clubs & spades) | (diamonds & clubs & spades),
+            hearts & diamonds & clubs & spades,
+            hearts == ranks || diamonds == ranks || clubs == ranks || spades == ranks
+        };
+    }
+
+    int scoreFive(const RankGroups &groups) {
+        const auto &[distinct, packed] = fiveCardTables;
+        const auto [ranks, pairs, trips, quads, flush] = groups;
+        switch (std::popcount(ranks)) {
+            case 5: {
+                const auto score = distinct[ranks];
+                if (!flush) {
+                    return score;
+                }
+                return score + (HandEvaluator::categoryOf(score) == HandEvaluator::Category::STRAIGHT
+                                    ? STRAIGHT_FLUSH_UPGRADE
+                                    : FLUSH_UPGRADE);
+            }
+            case 4:
+                return makeScore(HandEvaluator::Category::ONE_PAIR, packed[pairs] << 12 | packed[ranks & ~pairs]);
+            case 3:
+                if (trips) {
+                    return makeScore(HandEvaluator::Category::THREE_OF_A_KIND,
+                                     packed[trips] << 8 | packed[ranks & ~trips]);
+                }
+                return makeScore(HandEvaluator::Category::TWO_PAIR, packed[pairs] << 4 | packed[ranks & ~pairs]);
+            default:
+                if (quads) {
+                    return makeScore(HandEvaluator::Category::FOUR_OF_A_KIND,
+                                     packed[quads] << 4 | packed[ranks & ~quads]);
+                }
+                return makeScore(HandEvaluator::Category::FULL_HOUSE, packed[trips] << 4 | packed[ranks & ~trips]);
+        }
+    }
+
+    template<std::size_t Capacity>
+    std::size_t splitCards(HandEvaluator::CardMask cards, std::array<HandEvaluator::CardMask, Capacity> &bits) {
+        std::size_t count = 0;
+        while (cards && count < Capacity) {
+            bits[count++] = cards & -cards;
+            cards &= cards - 1;
+        }
+        return count;
+    }
+}
+
+int HandEvaluator::cardIndex(const Card &card) {
+    return static_cast<int>(card.getSuit()) * 13 + static_cast<int>(card.getRank()) - 2;
+}
+
+Card HandEvaluator::cardFromIndex(const int index) {
+    return {static_cast<Card::Suit>(index / 13), static_cast<Card::Rank>(index % 13 + 2)};
+}
+
+HandEvaluator::CardMask HandEvaluator::cardBit(const Card &card) {
+    return CardMask{1} << (static_cast<int>(card.getSuit()) * SUIT_STRIDE + static_cast<int>(card.getRank()) - 2);
+}
+
+HandEvaluator::CardMask HandEvaluator::cardBit(const int index) {
+    return CardMask{1} << (index / 13 * SUIT_STRIDE + index % 13);
+}
+
+HandEvaluator::CardMask HandEvaluator::toMask(const std::vector<Card> &cards) {
+    CardMask mask = 0;
+    for (const auto &card: cards) {
+        mask |= cardBit(card);
+    }
+    return mask;
+}
+
+int HandEvaluator::evaluate(const CardMask cards) {
+    const auto clubs = static_cast<std::uint32_t>(cards >> 2 * SUIT_STRIDE) & RANK_BITS;
+    const auto diamonds = static_cast<std::uint32_t>(cards >> SUIT_STRIDE) & RANK_BITS;
+    const auto hearts = static_cast<std::uint32_t>(cards) & RANK_BITS;
+    const auto spades = static_cast<std::uint32_t>(cards >> 3 * SUIT_STRIDE) & RANK_BITS;
+
+    auto flushRanks = 0u;
+    for (const auto suitRanks: {hearts, diamonds, clubs, spades}) {
+        if (std::popcount(suitRanks) >= 5) {
+            flushRanks = suitRanks;
+            break;
+        }
+    }
+
+    if (flushRanks) {
+        if (const auto high = straightHigh(flushRanks); high >= 0) {
+            return makeScore(Category::STRAIGHT_FLUSH, high + 2);
+        }
+    }
+
+    const auto ranks = hearts | diamonds | clubs | spades;
+    const auto quads = hearts & diamonds & clubs & spades;
+    const auto atLeastThree = (hearts & diamonds & clubs) | (hearts & diamonds & spades) |
+                              (hearts & clubs & spades) | (diamonds & clubs & spades);
+    const auto atLeastTwo = (hearts & diamonds) | (hearts & clubs) | (hearts & spades) |
+                            (diamonds & clubs) | (diamonds & spades) | (clubs & spades);
+
+    if (quads) {
+        const auto quad = 1u << highestBit(quads);
+        return makeScore(Category::FOUR_OF_A_KIND, packRanks(quad) << 4 | packRanks(keepHighest(ranks & ~quad, 1)));
+    }
+
+    if (atLeastThree) {
+        const auto trip = 1u << highestBit(atLeastThree);
+        if (const auto pairs = atLeastTwo & ~trip; pairs) {
+            return makeScore(Category::FULL_HOUSE, packRanks(trip) << 4 | packRanks(keepHighest(pairs, 1)));
+        }
+    }
+
+    if (flushRanks) {
+        return makeScore(Category::FLUSH, packRanks(keepHighest(flushRanks, 5)));
+    }
+
+    if (const auto high = straightHigh(ranks); high >= 0) {
+        return makeScore(Category::STRAIGHT, high + 2);
+    }
+
+    if (atLeastThree) {
+        const auto trip = 1u << highestBit(atLeastThree);
+        return makeScore(Category::THREE_OF_A_KIND, packRanks(trip) << 8 | packRanks(keepHighest(ranks & ~trip, 2)));
+    }
+
+    if (std::popcount(atLeastTwo) >= 2) {
+        const auto topPairs = keepHighest(atLeastTwo, 2);
+        return makeScore(Category::TWO_PAIR, packRanks(topPairs) << 4 | packRanks(keepHighest(ranks & ~topPairs, 1)));
+    }
+
+    if (atLeastTwo) {
+        return makeScore(Category::ONE_PAIR, packRanks(atLeastTwo) << 12 | packRanks(keepHighest(ranks & ~atLeastTwo, 3)));
+    }
+
+    return makeScore(Category::HIGH_CARD, packRanks(keepHighest(ranks, 5)));
+}
+
+int HandEvaluator::evaluate(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards) {
+    return evaluate(toMask(holeCards) | toMask(communityCards));
+}
+
+int HandEvaluator::evaluateFive(const CardMask cards) {
+    return scoreFive(groupRanks(cards));
+}
+
+void HandEvaluator::evaluateFiveBatch(const std::span<const CardMask> hands, const std::span<int> scores) {
+    constexpr std::size_t CHUNK = 64;
+    std::array<RankGroups, CHUNK> groups;
+    for (std::size_t base = 0; base < hands.size(); base += CHUNK) {
+        const auto count = std::min(CHUNK, hands.size() - base);
+        for (std::size_t i = 0; i < count; i++) {
+            groups[i] = groupRanks(hands[base + i]);
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            scores[base + i] = scoreFive(groups[i]);
+        }
+    }
+}
+
+int HandEvaluator::evaluateOmaha(const CardMask holeCards, const CardMask board) {
+    std::array<CardMask, 4> hole{};
+    std::array<CardMask, 5> community{};
+    const auto holeCount = splitCards(holeCards, hole);
+    const auto boardCount = splitCards(board, community);
+
+    std::array<CardMask, MAX_OMAHA_COMBINATIONS> hands;
+    std::size_t count = 0;
+    for (std::size_t a = 0; a < holeCount; a++) {
+        for (auto b = a + 1; b < holeCount; b++) {
+            const auto pair = hole[a] | hole[b];
+            for (std::size_t x = 0; x < boardCount; x++) {
+                for (auto y = x + 1; y < boardCount; y++) {
+                    for (auto z = y + 1; z < boardCount; z++) {
+                        hands[count++] = pair | community[x] | community[y] | community[z];
+                    }
+                }
+            }
+        }
+    }
+    if (count == 0) {
+        return -1;
+    }
+
+    std::array<int, MAX_OMAHA_COMBINATIONS> scores;
+    evaluateFiveBatch(std::span(hands.data(), count), std::span(scores.data(), count));
+    return *std::max_element(scores.begin(), scores.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+HandEvaluator::Category HandEvaluator::categoryOf(const int score) {
+    return static_cast<Category>(score >> CATEGORY_SHIFT);
+}
+
+const char *HandEvaluator::categoryName(const Category category) {
+    switch (category) {
+        case Category::HIGH_CARD: return "High Card";
+        case Category::ONE_PAIR: return "One Pair";
+        case Category::TWO_PAIR: return "Two Pair";
+        case Category::THREE_OF_A_KIND: return "Three of a Kind";
+        case Category::STRAIGHT: return "Straight";
+        case Category::FLUSH: return "Flush";
+        case Category::FULL_HOUSE: return "Full House";
+        case Category::FOUR_OF_A_KIND: return "Four of a Kind";
+        case Category::STRAIGHT_FLUSH: return "Straight Flush";
+    }
+    return "";
+}
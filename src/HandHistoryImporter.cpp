@@ -0,0 +1,433 @@
+﻿#include "HandHistoryImporter.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Card.h"
+
+namespace {
+    [[noreturn]] void throwSystemError(const std::string &what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &path) : data_(nullptr), size_(0) {
+            const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throwSystemError("open " + path);
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) < 0) {
+                ::close(fd);
+                throwSystemError("stat " + path);
+            }
+            size_ = static_cast<std::size_t>(info.st_size);
+            if (size_ > 0) {
+                auto *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    ::close(fd);
+                    throwSystemError("mmap " + path);
+                }
+                ::madvise(mapping, size_, MADV_SEQUENTIAL | MADV_WILLNEED);
+                data_ = static_cast<const char *>(mapping);
+            }
+            ::close(fd);
+        }
+
+        ~MappedFile() {
+            if (data_) {
+                ::munmap(const_cast<char *>(data_), size_);
+            }
+        }
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        std::string_view text() const { return {data_, size_}; }
+
+    private:
+        const char *data_;
+        std::size_t size_;
+    };
+
+    struct Chunk {
+        std::string_view text;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::string_view trim(std::string_view text) {
+        constexpr std::string_view bom = "\xEF\xBB\xBF";
+        constexpr std::string_view blank = " \t\r\n";
+        const auto first = text.find_first_not_of(blank);
+        if (first == std::string_view::npos) return {};
+        text = text.substr(first, text.find_last_not_of(blank) - first + 1);
+        if (text.starts_with(bom)) {
+            text = trim(text.substr(bom.size()));
+        }
+        return text;
+    }
+
+    bool isDigit(const char c) { return c >= '0' && c <= '9'; }
+
+    bool readAmount(const std::string_view text, std::size_t &pos, int &amount) {
+        while (pos < text.size() && (text[pos] == '$' || static_cast<unsigned char>(text[pos]) >= 0x80)) {
+            pos++;
+        }
+        if (pos >= text.size() || !isDigit(text[pos])) return false;
+
+        long long whole = 0;
+        for (; pos < text.size() && (isDigit(text[pos]) || text[pos] == ','); pos++) {
+            if (text[pos] != ',') whole = whole * 10 + (text[pos] - '0');
+        }
+        auto cents = 0;
+        if (pos + 1 < text.size() && text[pos] == '.' && isDigit(text[pos + 1])) {
+            pos++;
+            for (auto digits = 0; digits < 2; digits++) {
+                cents *= 10;
+                if (pos < text.size() && isDigit(text[pos])) cents += text[pos++] - '0';
+            }
+            while (pos < text.size() && isDigit(text[pos])) pos++;
+        }
+        amount = static_cast<int>(std::min<long long>(whole * 100 + cents, INT32_MAX));
+        return true;
+    }
+
+    bool readAmount(const std::string_view text, int &amount) {
+        std::size_t pos = 0;
+        return readAmount(text, pos, amount);
+    }
+
+    int rankOf(const char c) {
+        if (c >= '2' && c <= '9') return c - '0';
+        switch (c) {
+            case 'T': return 10;
+            case 'J': return 11;
+            case 'Q': return 12;
+            case 'K': return 13;
+            case 'A': return 14;
+            default: return 0;
+        }
+    }
+
+    int suitOf(const char c) {
+        switch (c) {
+            case 'h': return static_cast<int>(Card::Suit::HEARTS);
+            case 'd': return static_cast<int>(Card::Suit::DIAMONDS);
+            case 'c': return static_cast<int>(Card::Suit::CLUBS);
+            case 's': return static_cast<int>(Card::Suit::SPADES);
+            default: return -1;
+        }
+    }
+
+    HandEvaluator::CardMask readCards(const std::string_view text) {
+        HandEvaluator::CardMask cards = 0;
+        auto inside = false;
+        for (std::size_t pos = 0; pos < text.size(); pos++) {
+            if (text[pos] == '[') inside = true;
+            else if (text[pos] == ']') inside = false;
+            else if (inside && pos + 1 < text.size()) {
+                const auto rank = rankOf(text[pos]);
+                const auto suit = suitOf(text[pos + 1]);
+                if (rank != 0 && suit >= 0) {
+                    cards |= HandEvaluator::cardBit(Card(static_cast<Card::Suit>(suit), static_cast<Card::Rank>(rank)));
+                    pos++;
+                }
+            }
+        }
+        return cards;
+    }
+
+    int seatByName(const std::vector<HandHistoryImporter::Seat> &seats, const std::string_view text,
+                   const std::string_view separator) {
+        for (std::size_t i = 0; i < seats.size(); i++) {
+            const auto &name = seats[i].name;
+            if (text.starts_with(name) && text.substr(name.size()).starts_with(separator)) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void importChunk(const Chunk &chunk, HandHistoryImporter::Hand &hand, HandHistoryImporter::Stats &stats,
+                     const HandHistoryImporter::HandHandler &onHand, const int thread) {
+        const auto text = chunk.text;
+        auto first = chunk.begin == 0;
+        auto start = first ? 0 : HandHistoryImporter::findDelimiter(text, chunk.begin - 1);
+        while (first || (start != std::string_view::npos && start + 1 < chunk.end)) {
+            const auto next = HandHistoryImporter::findDelimiter(text, first ? 0 : start + 1);
+            const auto block = trim(text.substr(start, next == std::string_view::npos ? next : next - start));
+            if (!block.empty()) {
+                if (HandHistoryImporter::parse(block, hand)) {
+                    stats.hands++;
+                    stats.actions += hand.actions.size();
+                    onHand(hand, thread);
+                } else {
+                    stats.skipped++;
+                }
+            }
+            if (next == std::string_view::npos) break;
+            start = next;
+            first = false;
+        }
+    }
+}
+
+void HandHistoryImporter::Hand::clear() {
+    id = 0;
+    smallBlind = 0;
+    bigBlind = 0;
+    button = 0;
+    board = 0;
+    seats.clear();
+    actions.clear();
+}
+
+int HandHistoryImporter::Hand::seatIndex(const int number) const {
+    const auto seat = std::ranges::find(seats, number, &Seat::number);
+    return seat == seats.end() ? -1 : static_cast<int>(seat - seats.begin());
+}
+
+HandHistoryImporter::Stats HandHistoryImporter::import(const std::vector<std::string> &paths, const int threads,
+                                                       const HandHandler &onHand) {
+    const auto started = std::chrono::steady_clock::now();
+    Stats total{};
+
+    std::deque<MappedFile> files;
+    std::vector<Chunk> chunks;
+    for (const auto &path: paths) {
+        const auto text = files.emplace_back(path).text();
+        for (std::size_t begin = 0; begin < text.size(); begin += CHUNK_BYTES) {
+            chunks.push_back({text, begin, std::min<std::size_t>(begin + CHUNK_BYTES, text.size())});
+        }
+        total.files++;
+        total.bytes += text.size();
+    }
+
+    const auto workerCount = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(1, chunks.size()));
+    std::vector<Stats> stats(workerCount);
+    std::atomic<std::size_t> nextChunk{0};
+    std::vector<std::thread> workers;
+    for (std::size_t worker = 0; worker < workerCount; worker++) {
+        workers.emplace_back([&, worker] {
+            Hand hand{};
+            for (auto i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+                importChunk(chunks[i], hand, stats[worker], onHand, static_cast<int>(worker));
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    for (const auto &worker: stats) {
+        total.hands += worker.hands;
+        total.skipped += worker.skipped;
+        total.actions += worker.actions;
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return total;
+}
+
+bool HandHistoryImporter::parse(std::string_view text, Hand &hand) {
+    hand.clear();
+
+    auto nextLine = [&text] {
+        const auto end = text.find('\n');
+        auto line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        if (line.ends_with('\r')) line.remove_suffix(1);
+        return line;
+    };
+
+    const auto header = nextLine();
+    if (!header.starts_with("PokerStars ") || header.find("Hold'em") == std::string_view::npos) return false;
+    const auto hash = header.find('#');
+    if (hash == std::string_view::npos) return false;
+    for (auto pos = hash + 1; pos < header.size() && isDigit(header[pos]); pos++) {
+        hand.id = hand.id * 10 + (header[pos] - '0');
+    }
+    for (auto open = header.find('('); open != std::string_view::npos; open = header.find('(', open + 1)) {
+        auto pos = open + 1;
+        if (readAmount(header, pos, hand.smallBlind) && pos < header.size() && header[pos] == '/' &&
+            readAmount(header, ++pos, hand.bigBlind)) {
+            break;
+        }
+    }
+
+    const auto table = nextLine();
+    if (const auto button = table.find("Seat #"); button != std::string_view::npos) {
+        for (auto pos = button + 6; pos < table.size() && isDigit(table[pos]); pos++) {
+            hand.button = hand.button * 10 + (table[pos] - '0');
+        }
+    }
+
+    std::array<int, MAX_SEATS> streetCommitted{};
+    auto street = -1;
+    auto summary = false;
+    auto pot = 0;
+    while (!text.empty()) {
+        const auto line = nextLine();
+
+        if (line.starts_with("*** ")) {
+            const auto marker = line.substr(4);
+            if (marker.starts_with("HOLE CARDS")) street = 0;
+            else if (marker.starts_with("FLOP")) street = 1;
+            else if (marker.starts_with("TURN")) street = 2;
+            else if (marker.starts_with("RIVER")) street = 3;
+            else if (marker.starts_with("SUMMARY")) summary = true;
+            else continue;
+            if (street > 0 && !summary) {
+                hand.board |= readCards(line);
+                streetCommitted.fill(0);
+            }
+            continue;
+        }
+
+        if (line.starts_with("Seat ") && (street < 0 || summary)) {
+            const auto colon = line.find(": ");
+            if (colon == std::string_view::npos) continue;
+            auto number = 0;
+            for (auto pos = std::size_t{5}; pos < colon && isDigit(line[pos]); pos++) {
+                number = number * 10 + (line[pos] - '0');
+            }
+            if (summary) {
+                if (const auto index = hand.seatIndex(number); index >= 0 && line.find(" [") != std::string_view::npos) {
+                    hand.seats[index].holeCards = readCards(line);
+                }
+                continue;
+            }
+            const auto chips = line.find(" in chips");
+            const auto open = line.rfind(" (", chips);
+            if (chips == std::string_view::npos || open == std::string_view::npos || open <= colon) continue;
+            if (hand.seats.size() == MAX_SEATS) return false;
+            auto &seat = hand.seats.emplace_back();
+            seat = {line.substr(colon + 2, open - colon - 2), number, 0, 0, 0, 0};
+            auto pos = open + 2;
+            readAmount(line, pos, seat.chips);
+            continue;
+        }
+        if (summary) continue;
+
+        if (line.starts_with("Dealt to ")) {
+            const auto rest = line.substr(9);
+            if (const auto index = seatByName(hand.seats, rest, " ["); index >= 0) {
+                hand.seats[index].holeCards = readCards(rest.substr(hand.seats[index].name.size()));
+            }
+            continue;
+        }
+
+        if (line.starts_with("Uncalled bet (")) {
+            auto pos = std::size_t{14};
+            auto amount = 0;
+            const auto returned = line.find(") returned to ");
+            if (returned == std::string_view::npos || !readAmount(line, pos, amount)) continue;
+            if (const auto index = seatByName(hand.seats, line.substr(returned + 14), ""); index >= 0) {
+                hand.seats[index].committed -= amount;
+                streetCommitted[index] -= amount;
+                pot -= amount;
+            }
+            continue;
+        }
+
+        auto index = seatByName(hand.seats, line, ": ");
+        if (index < 0) {
+            if (const auto collector = seatByName(hand.seats, line, " collected "); collector >= 0) {
+                auto amount = 0;
+                if (readAmount(line.substr(hand.seats[collector].name.size() + 11), amount)) {
+                    hand.seats[collector].collected += amount;
+                }
+            }
+            continue;
+        }
+
+        auto &seat = hand.seats[index];
+        const auto verb = line.substr(seat.name.size() + 2);
+        auto amount = 0;
+        Player::Action action;
+        if (verb.starts_with("posts ")) {
+            if (const auto space = verb.rfind(' '); readAmount(verb.substr(space + 1), amount)) {
+                const auto live = verb.starts_with("posts the ante") ? 0
+                                  : verb.starts_with("posts small & big") ? std::min(amount, hand.bigBlind)
+                                  : amount;
+                seat.committed += amount;
+                streetCommitted[index] += live;
+                pot += amount;
+            }
+            continue;
+        }
+        if (verb.starts_with("shows ")) {
+            seat.holeCards = readCards(verb);
+            continue;
+        }
+        if (verb.starts_with("folds")) {
+            action = Player::Action::FOLD;
+        } else if (verb.starts_with("checks")) {
+            action = Player::Action::CHECK;
+        } else if (verb.starts_with("calls ")) {
+            action = Player::Action::CALL;
+            readAmount(verb.substr(6), amount);
+        } else if (verb.starts_with("bets ")) {
+            action = Player::Action::RAISE;
+            readAmount(verb.substr(5), amount);
+        } else if (verb.starts_with("raises ")) {
+            action = Player::Action::RAISE;
+            const auto to = verb.find(" to ");
+            if (to == std::string_view::npos || !readAmount(verb.substr(to + 4), amount)) continue;
+            amount -= streetCommitted[index];
+        } else {
+            continue;
+        }
+
+        hand.actions.push_back({index, action, amount, pot, std::max(street, 0), verb.ends_with("all-in")});
+        seat.committed += amount;
+        streetCommitted[index] += amount;
+        pot += amount;
+    }
+    return hand.seats.size() >= 2;
+}
+
+std::size_t HandHistoryImporter::findDelimiter(const std::string_view text, std::size_t from) {
+    const auto *data = text.data();
+    const auto size = text.size();
+#if defined(__SSE2__)
+    const auto newline = _mm_set1_epi8('\n');
+    const auto carriage = _mm_set1_epi8('\r');
+    for (; from + 18 <= size; from += 16) {
+        const auto here = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + from));
+        const auto next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + from + 1));
+        const auto after = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + from + 2));
+        const auto blank = _mm_or_si128(_mm_cmpeq_epi8(next, newline),
+                                        _mm_and_si128(_mm_cmpeq_epi8(next, carriage), _mm_cmpeq_epi8(after, newline)));
+        if (const auto mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(here, newline), blank)); mask != 0) {
+            return from + std::countr_zero(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+    for (; from + 1 < size; from++) {
+        if (data[from] == '\n' && (data[from + 1] == '\n' ||
+                                   (data[from + 1] == '\r' && from + 2 < size && data[from + 2] == '\n'))) {
+            return from;
+        }
+    }
+    return std::string_view::npos;
+}
@@ -0,0 +1,390 @@
+﻿#include "HandIndexer.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    constexpr int ROUND_SHIFT = 4;
+    constexpr std::uint32_t ROUND_MASK = 0xF;
+    constexpr std::uint32_t RANK_SETS = 1u << HandIndexer::RANKS;
+    constexpr std::size_t MAX_RANK_SET_INDEX = 1716;
+
+    constexpr HandIndexer::Index choose(const HandIndexer::Index n, const int k) {
+        if (static_cast<HandIndexer::Index>(k) > n) {
+            return 0;
+        }
+        HandIndexer::Index result = 1;
+        for (auto i = 1; i <= k; i++) {
+            result = result * (n - k + i) / i;
+        }
+        return result;
+    }
+
+    struct RankTables {
+        std::array<std::array<std::uint16_t, HandIndexer::RANKS + 1>, HandIndexer::RANKS + 1> choose{};
+        std::array<std::uint16_t, RANK_SETS> setToIndex{};
+        std::array<std::array<std::uint16_t, MAX_RANK_SET_INDEX>, HandIndexer::RANKS + 1> indexToSet{};
+    };
+
+    constexpr auto rankTables = [] {
+        RankTables tables;
+        for (auto n = 0; n <= HandIndexer::RANKS; n++) {
+            for (auto k = 0; k <= n; k++) {
+                tables.choose[n][k] = static_cast<std::uint16_t>(choose(n, k));
+            }
+        }
+        for (std::uint32_t set = 0; set < RANK_SETS; set++) {
+            HandIndexer::Index index = 0;
+            auto nth = 1;
+            for (auto bits = set; bits; bits &= bits - 1, nth++) {
+                index += choose(static_cast<HandIndexer::Index>(std::countr_zero(bits)), nth);
+            }
+            tables.setToIndex[set] = static_cast<std::uint16_t>(index);
+            tables.indexToSet[std::popcount(set)][index] = static_cast<std::uint16_t>(set);
+        }
+        return tables;
+    }();
+
+    int nthUnset(const std::uint32_t used, int n) {
+        for (auto rank = 0; rank < HandIndexer::RANKS; rank++) {
+            if (!(used & 1u << rank) && n-- == 0) {
+                return rank;
+            }
+        }
+        return -1;
+    }
+
+    HandIndexer::Index groupCount(const HandIndexer::Index size, const int suits) {
+        return choose(size + suits - 1, suits);
+    }
+}
+
+HandIndexer::HandIndexer(std::vector<int> cardsPerRound) {
+    auto start = 0;
+    for (const auto cards: cardsPerRound) {
+        rounds_.push_back({cards, start, 0, {}, {}, {}, {}, {}, {}});
+        start += cards;
+    }
+    if (rounds_.empty() || rounds_.size() > MAX_ROUNDS || start > SUITS * RANKS) {
+        throw std::invalid_argument("hand indexer needs 1 to 8 rounds of at most 52 cards");
+    }
+
+    std::array<int, SUITS> used{};
+    Configuration counts{};
+    auto collect = [this](const int round, const Configuration &configuration) {
+        rounds_[round].configurations.push_back(configuration);
+    };
+    enumerate(0, rounds_[0].cards, 0, used, counts, true, (1u << SUITS) - 2, collect);
+
+    for (auto round = 0; round < getRounds(); round++) {
+        auto &state = rounds_[round];
+        std::ranges::sort(state.configurations, std::greater());
+        for (const auto &configuration: state.configurations) {
+            tabulateConfiguration(round, configuration);
+        }
+        Index offset = 0;
+        for (auto &count: state.offsets) {
+            offset += std::exchange(count, offset);
+        }
+        state.size = offset;
+
+        std::size_t permutations = 1;
+        for (auto r = 0; r <= round; r++) {
+            for (auto suit = 0; suit < SUITS - 1; suit++) {
+                permutations *= static_cast<std::size_t>(rounds_[r].cards + 1);
+            }
+        }
+        state.permutationToConfiguration.resize(permutations);
+        state.permutationToSuits.resize(permutations);
+    }
+
+    auto tabulate = [this](const int round, const Configuration &permutation) {
+        tabulatePermutation(round, permutation);
+    };
+    enumerate(0, rounds_[0].cards, 0, used, counts, false, 0, tabulate);
+}
+
+const HandIndexer &HandIndexer::forStreet(const int street) {
+    static const std::array<HandIndexer, 4> indexers{
+        HandIndexer({2}), HandIndexer({2, 3}), HandIndexer({2, 4}), HandIndexer({2, 5})
+    };
+    return indexers[std::clamp(street, 0, 3)];
+}
+
+const HandIndexer &HandIndexer::flops() {
+    static const HandIndexer indexer({3});
+    return indexer;
+}
+
+int HandIndexer::getRounds() const { return static_cast<int>(rounds_.size()); }
+
+int HandIndexer::getCardsThrough(const int round) const { return rounds_[round].start + rounds_[round].cards; }
+
+HandIndexer::Index HandIndexer::getSize(const int round) const { return rounds_[round].size; }
+
+HandIndexer::Index HandIndexer::index(const std::span<const Card> holeCards,
+                                      const std::span<const Card> communityCards) const {
+    std::array<HandEvaluator::CardMask, MAX_ROUNDS> masks{};
+    auto round = 0;
+    auto position = 0;
+    const auto add = [&](const Card &card) {
+        if (round == getRounds()) {
+            throw std::invalid_argument("too many cards for hand indexer");
+        }
+        masks[round] |= HandEvaluator::cardBit(card);
+        if (++position == getCardsThrough(round)) {
+            round++;
+        }
+    };
+    std::ranges::for_each(holeCards, add);
+    std::ranges::for_each(communityCards, add);
+    if (round == 0 || position != getCardsThrough(round - 1)) {
+        throw std::invalid_argument("card count does not end a round: " + std::to_string(position));
+    }
+    return index(std::span<const HandEvaluator::CardMask>(masks.data(), round));
+}
+
+HandIndexer::Index HandIndexer::index(const std::span<const HandEvaluator::CardMask> rounds) const {
+    if (rounds.empty() || rounds.size() > rounds_.size()) {
+        throw std::invalid_argument("hand indexer round out of range");
+    }
+
+    std::array<std::uint32_t, SUITS> usedRanks{};
+    std::array<Index, SUITS> suitIndex{};
+    std::array<Index, SUITS> suitMultiplier{1, 1, 1, 1};
+    std::size_t permutation = 0;
+    std::size_t permutationMultiplier = 1;
+    for (std::size_t r = 0; r < rounds.size(); r++) {
+        const auto &state = rounds_[r];
+        if (std::popcount(rounds[r]) != state.cards) {
+            throw std::invalid_argument("wrong number of cards in round " + std::to_string(r));
+        }
+
+        auto remaining = state.cards;
+        for (auto suit = 0; suit < SUITS; suit++) {
+            const auto ranks = static_cast<std::uint32_t>(rounds[r] >> suit * HandEvaluator::SUIT_STRIDE) &
+                               HandEvaluator::RANK_BITS;
+            std::uint32_t shifted = 0;
+            for (auto bits = ranks; bits; bits &= bits - 1) {
+                const auto bit = bits & -bits;
+                shifted |= bit >> std::popcount((bit - 1) & usedRanks[suit]);
+            }
+
+            const auto size = std::popcount(ranks);
+            suitIndex[suit] += suitMultiplier[suit] * rankTables.setToIndex[shifted];
+            suitMultiplier[suit] *= rankTables.choose[RANKS - std::popcount(usedRanks[suit])][size];
+            usedRanks[suit] |= ranks;
+            if (suit < SUITS - 1) {
+                permutation += permutationMultiplier * static_cast<std::size_t>(size);
+                permutationMultiplier *= static_cast<std::size_t>(remaining + 1);
+                remaining -= size;
+            }
+        }
+    }
+
+    const auto &state = rounds_[rounds.size() - 1];
+    const auto configuration = state.permutationToConfiguration[permutation];
+    const auto &suits = state.permutationToSuits[permutation];
+    const auto equal = state.equalSuits[configuration];
+    std::array<Index, SUITS> canonicalIndex{};
+    for (auto i = 0; i < SUITS; i++) {
+        canonicalIndex[i] = suitIndex[suits[i]];
+    }
+
+    auto result = state.offsets[configuration];
+    Index scale = 1;
+    for (auto i = 0; i < SUITS;) {
+        auto j = i + 1;
+        while (j < SUITS && equal & 1u << j) {
+            j++;
+        }
+        for (auto k = i + 1; k < j; k++) {
+            for (auto m = k; m > i && canonicalIndex[m - 1] > canonicalIndex[m]; m--) {
+                std::swap(canonicalIndex[m - 1], canonicalIndex[m]);
+            }
+        }
+        Index part = 0;
+        for (auto k = i; k < j; k++) {
+            part += choose(canonicalIndex[k] + (k - i), k - i + 1);
+        }
+        result += scale * part;
+        scale *= groupCount(state.suitSizes[configuration][i], j - i);
+        i = j;
+    }
+    return result;
+}
+
+void HandIndexer::unindex(const int round, Index index, const std::span<HandEvaluator::CardMask> rounds) const {
+    if (round < 0 || round >= getRounds() || index >= rounds_[round].size ||
+        rounds.size() <= static_cast<std::size_t>(round)) {
+        throw std::invalid_argument("hand index out of range");
+    }
+    const auto &state = rounds_[round];
+    const auto configuration = static_cast<std::size_t>(
+        std::ranges::upper_bound(state.offsets, index) - state.offsets.begin() - 1);
+    index -= state.offsets[configuration];
+    const auto &counts = state.configurations[configuration];
+    const auto &suitSizes = state.suitSizes[configuration];
+
+    std::array<Index, SUITS> suitIndex{};
+    for (auto i = 0; i < SUITS;) {
+        auto j = i + 1;
+        while (j < SUITS && counts[j] == counts[i]) {
+            j++;
+        }
+        const auto groupSize = groupCount(suitSizes[i], j - i);
+        auto groupIndex = index % groupSize;
+        index /= groupSize;
+        for (; i < j - 1; i++) {
+            const auto terms = j - i;
+            Index low = 0;
+            auto high = suitSizes[i];
+            while (low + 1 < high) {
+                if (const auto mid = (low + high) / 2; choose(mid + terms - 1, terms) <= groupIndex) {
+                    low = mid;
+                } else {
+                    high = mid;
+                }
+            }
+            suitIndex[i] = low;
+            groupIndex -= choose(low + terms - 1, terms);
+        }
+        suitIndex[i++] = groupIndex;
+    }
+
+    std::fill(rounds.begin(), rounds.begin() + round + 1, 0);
+    for (auto suit = 0; suit < SUITS; suit++) {
+        std::uint32_t used = 0;
+        for (auto r = 0; r <= round; r++) {
+            const auto n = static_cast<int>(nibble(counts[suit], r));
+            const auto roundSize = choose(RANKS - std::popcount(used), n);
+            const auto roundIndex = suitIndex[suit] % roundSize;
+            suitIndex[suit] /= roundSize;
+            std::uint32_t rankSet = 0;
+            for (auto shifted = static_cast<std::uint32_t>(rankTables.indexToSet[n][roundIndex]); shifted;
+                 shifted &= shifted - 1) {
+                rankSet |= 1u << nthUnset(used, std::countr_zero(shifted));
+            }
+            rounds[r] |= static_cast<HandEvaluator::CardMask>(rankSet) << suit * HandEvaluator::SUIT_STRIDE;
+            used |= rankSet;
+        }
+    }
+}
+
+std::vector<Card> HandIndexer::unindex(const int round, const Index index) const {
+    std::array<HandEvaluator::CardMask, MAX_ROUNDS> rounds{};
+    unindex(round, index, rounds);
+
+    std::vector<Card> cards;
+    cards.reserve(static_cast<std::size_t>(getCardsThrough(round)));
+    for (auto r = 0; r <= round; r++) {
+        for (auto mask = rounds[r]; mask; mask &= mask - 1) {
+            const auto bit = std::countr_zero(mask);
+            cards.emplace_back(static_cast<Card::Suit>(bit / HandEvaluator::SUIT_STRIDE),
+                               static_cast<Card::Rank>(bit % HandEvaluator::SUIT_STRIDE + 2));
+        }
+    }
+    return cards;
+}
+
+template<typename Observe>
+void HandIndexer::enumerate(const int round, const int remaining, const int suit, std::array<int, SUITS> &used,
+                            Configuration &counts, const bool canonical, const std::uint32_t equal,
+                            Observe &observe) const {
+    if (suit == SUITS) {
+        observe(round, counts);
+        if (round + 1 < getRounds()) {
+            enumerate(round + 1, rounds_[round + 1].cards, 0, used, counts, canonical, equal, observe);
+        }
+        return;
+    }
+
+    const auto shift = ROUND_SHIFT * (getRounds() - round - 1);
+    const auto low = suit == SUITS - 1 ? remaining : 0;
+    auto high = std::min(RANKS - used[suit], remaining);
+    auto previous = RANKS + 1;
+    const auto wasEqual = canonical && (equal & 1u << suit);
+    if (wasEqual) {
+        previous = static_cast<int>(counts[suit - 1] >> shift & ROUND_MASK);
+        high = std::min(high, previous);
+    }
+
+    const auto oldCount = counts[suit];
+    const auto oldUsed = used[suit];
+    for (auto n = low; n <= high; n++) {
+        counts[suit] = oldCount | static_cast<std::uint32_t>(n) << shift;
+        used[suit] = oldUsed + n;
+        const auto nextEqual = (equal & ~(1u << suit)) | static_cast<std::uint32_t>(wasEqual && n == previous) << suit;
+        enumerate(round, remaining - n, suit + 1, used, counts, canonical, nextEqual, observe);
+    }
+    counts[suit] = oldCount;
+    used[suit] = oldUsed;
+}
+
+void HandIndexer::tabulateConfiguration(const int round, const Configuration &configuration) {
+    auto &state = rounds_[round];
+    std::array<Index, SUITS> sizes{};
+    std::uint32_t equal = 0;
+    Index count = 1;
+    for (auto i = 0; i < SUITS;) {
+        Index size = 1;
+        auto remaining = RANKS;
+        for (auto r = 0; r <= round; r++) {
+            const auto n = static_cast<int>(nibble(configuration[i], r));
+            size *= choose(remaining, n);
+            remaining -= n;
+        }
+
+        auto j = i + 1;
+        while (j < SUITS && configuration[j] == configuration[i]) {
+            equal |= 1u << j++;
+        }
+        std::fill(sizes.begin() + i, sizes.begin() + j, size);
+        count *= groupCount(size, j - i);
+        i = j;
+    }
+    state.suitSizes.push_back(sizes);
+    state.equalSuits.push_back(equal);
+    state.offsets.push_back(count);
+}
+
+void HandIndexer::tabulatePermutation(const int round, const Configuration &counts) {
+    auto &state = rounds_[round];
+    const auto permutation = permutationIndex(counts, round);
+
+    std::array<std::uint8_t, SUITS> suits{};
+    std::iota(suits.begin(), suits.end(), std::uint8_t{0});
+    std::ranges::stable_sort(suits, std::greater(), [&counts](const std::uint8_t suit) { return counts[suit]; });
+
+    Configuration sorted{};
+    for (auto i = 0; i < SUITS; i++) {
+        sorted[i] = counts[suits[i]];
+    }
+    const auto found = std::ranges::lower_bound(state.configurations, sorted, std::greater());
+    state.permutationToConfiguration[permutation] =
+            static_cast<std::uint32_t>(found - state.configurations.begin());
+    state.permutationToSuits[permutation] = suits;
+}
+
+std::size_t HandIndexer::permutationIndex(const Configuration &counts, const int round) const {
+    std::size_t index = 0;
+    std::size_t multiplier = 1;
+    for (auto r = 0; r <= round; r++) {
+        auto remaining = rounds_[r].cards;
+        for (auto suit = 0; suit < SUITS - 1; suit++) {
+            const auto size = static_cast<int>(nibble(counts[suit], r));
+            index += multiplier * static_cast<std::size_t>(size);
+            multiplier *= static_cast<std::size_t>(remaining + 1);
+            remaining -= size;
+        }
+    }
+    return index;
+}
+
+std::uint32_t HandIndexer::nibble(const std::uint32_t configuration, const int round) const {
+    return configuration >> ROUND_SHIFT * (getRounds() - round - 1) & ROUND_MASK;
+}
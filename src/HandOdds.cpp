@@ -0,0 +1,124 @@
+﻿#include "HandOdds.h"
+
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr int OMAHA_SAMPLE_DIVISOR = 4;
+
+    constexpr HandEvaluator::CardMask DECK = [] {
+        HandEvaluator::CardMask deck = 0;
+        for (auto suit = 0; suit < 4; suit++) {
+            deck |= static_cast<HandEvaluator::CardMask>(HandEvaluator::RANK_BITS) << suit * HandEvaluator::SUIT_STRIDE;
+        }
+        return deck;
+    }();
+
+    int score(const HandEvaluator::CardMask holeCards, const HandEvaluator::CardMask board, const bool omaha) {
+        return omaha ? HandEvaluator::evaluateOmaha(holeCards, board) : HandEvaluator::evaluate(holeCards | board);
+    }
+
+    std::vector<HandEvaluator::CardMask> cardsOf(HandEvaluator::CardMask mask) {
+        std::vector<HandEvaluator::CardMask> cards;
+        cards.reserve(static_cast<std::size_t>(std::popcount(mask)));
+        for (; mask; mask &= mask - 1) {
+            cards.push_back(mask & -mask);
+        }
+        return cards;
+    }
+
+    HandEvaluator::CardMask drawCard(const HandEvaluator::CardMask dead, std::mt19937_64 &rng) {
+        while (true) {
+            if (const auto card = HandEvaluator::cardBit(static_cast<int>(rng() % 52)); !(dead & card)) {
+                return card;
+            }
+        }
+    }
+
+    double enumerateRiver(const HandEvaluator::CardMask holeCards, const HandEvaluator::CardMask board,
+                          const std::vector<HandEvaluator::CardMask> &unseen, std::uint64_t &showdowns) {
+        const auto heroScore = HandEvaluator::evaluate(holeCards | board);
+        auto won = 0.0;
+        for (std::size_t a = 0; a < unseen.size(); a++) {
+            if (board & unseen[a]) continue;
+            for (auto b = a + 1; b < unseen.size(); b++) {
+                if (board & unseen[b]) continue;
+                if (const auto opponent = HandEvaluator::evaluate(unseen[a] | unseen[b] | board);
+                    opponent < heroScore) {
+                    won += 1.0;
+                } else if (opponent == heroScore) {
+                    won += 0.5;
+                }
+                showdowns++;
+            }
+        }
+        return won;
+    }
+}
+
+HandOdds::Report HandOdds::analyze(const HandEvaluator::CardMask holeCards, const HandEvaluator::CardMask board,
+                                   const int samples) {
+    const auto boardCards = std::popcount(board);
+    const auto holeCount = std::popcount(holeCards);
+    const auto omaha = holeCount == 4;
+    Report report{};
+    report.category = HandEvaluator::categoryOf(boardCards >= 3
+                                                    ? score(holeCards, board, omaha)
+                                                    : HandEvaluator::evaluate(holeCards));
+
+    const auto unseen = cardsOf(DECK & ~(holeCards | board));
+    if (boardCards == 3 || boardCards == 4) {
+        for (const auto card: unseen) {
+            const auto improved = HandEvaluator::categoryOf(score(holeCards, board | card, omaha));
+            const auto boardOnly = HandEvaluator::categoryOf(HandEvaluator::evaluate(board | card));
+            if (improved > report.category && (omaha || improved > boardOnly)) {
+                report.outs[static_cast<int>(improved)]++;
+                report.totalOuts++;
+            }
+        }
+    }
+
+    if (!omaha && boardCards >= 4) {
+        auto won = 0.0;
+        if (boardCards == 5) {
+            won = enumerateRiver(holeCards, board, unseen, report.showdowns);
+        } else {
+            for (const auto river: unseen) {
+                won += enumerateRiver(holeCards, board | river, unseen, report.showdowns);
+            }
+        }
+        report.equity = won / static_cast<double>(report.showdowns);
+        report.exact = true;
+        return report;
+    }
+
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    const auto known = holeCards | board;
+    const auto trials = omaha ? samples / OMAHA_SAMPLE_DIVISOR : samples;
+    auto won = 0.0;
+    for (auto s = 0; s < trials; s++) {
+        auto runout = board;
+        for (auto cards = boardCards; cards < 5; cards++) {
+            runout |= drawCard(known | runout, rng);
+        }
+        HandEvaluator::CardMask opponent = 0;
+        for (auto cards = 0; cards < holeCount; cards++) {
+            opponent |= drawCard(known | runout | opponent, rng);
+        }
+        if (const auto hero = score(holeCards, runout, omaha), villain = score(opponent, runout, omaha);
+            hero > villain) {
+            won += 1.0;
+        } else if (hero == villain) {
+            won += 0.5;
+        }
+    }
+    report.showdowns = static_cast<std::uint64_t>(std::max(0, trials));
+    report.equity = trials > 0 ? won / trials : 0.0;
+    return report;
+}
+
+double HandOdds::potOdds(const int toCall, const int pot) {
+    return toCall > 0 ? static_cast<double>(toCall) / (pot + toCall) : 0.0;
+}
@@ -0,0 +1,216 @@
+﻿#include "Instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+    constexpr auto SUB_BITS = 5;
+    constexpr std::uint64_t SUB_BUCKETS = 1 << SUB_BITS;
+    constexpr auto MAX_BITS = 44;
+    constexpr auto BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    std::size_t bucketOf(std::uint64_t value) {
+        value = std::min(value, (std::uint64_t{1} << MAX_BITS) - 1);
+        if (value < SUB_BUCKETS) {
+            return value;
+        }
+        const auto shift = std::bit_width(value) - 1 - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+    }
+
+    std::uint64_t bucketCeiling(const std::size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        const auto shift = bucket / SUB_BUCKETS - 1;
+        return ((SUB_BUCKETS + bucket % SUB_BUCKETS + 1) << shift) - 1;
+    }
+
+    void bump(std::atomic<std::uint64_t> &value, const std::uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    struct Histogram {
+        std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+        std::atomic<std::uint64_t> max{};
+    };
+
+    struct Recorder {
+        std::array<Histogram, Instrumentation::PHASES> phases;
+        std::array<std::atomic<std::uint64_t>, Instrumentation::COUNTERS> counters{};
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Recorder> > recorders;
+        std::vector<Recorder *> idle;
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    class Lease {
+    public:
+        Lease() : registry_(registry()) {
+            std::lock_guard lock(registry_.mutex);
+            if (registry_.idle.empty()) {
+                recorder_ = registry_.recorders.emplace_back(std::make_unique<Recorder>()).get();
+            } else {
+                recorder_ = registry_.idle.back();
+                registry_.idle.pop_back();
+            }
+        }
+
+        Lease(const Lease &) = delete;
+
+        Lease &operator=(const Lease &) = delete;
+
+        ~Lease() {
+            std::lock_guard lock(registry_.mutex);
+            registry_.idle.push_back(recorder_);
+        }
+
+        Recorder &recorder() const { return *recorder_; }
+
+    private:
+        Registry &registry_;
+        Recorder *recorder_;
+    };
+
+    Recorder &localRecorder() {
+        thread_local Lease lease;
+        return lease.recorder();
+    }
+
+    double nanosecondsPerTick() {
+        static const auto ratio = [] {
+            const auto wallStarted = std::chrono::steady_clock::now();
+            const auto ticksStarted = Instrumentation::ticks();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            const auto elapsedTicks = Instrumentation::ticks() - ticksStarted;
+            const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                                          wallStarted).count();
+            return elapsedTicks == 0 ? 1.0 : elapsed / static_cast<double>(elapsedTicks);
+        }();
+        return ratio;
+    }
+}
+
+void Instrumentation::record(const Phase phase, const std::uint64_t elapsedTicks, const std::uint64_t weight) {
+    auto &histogram = localRecorder().phases[static_cast<std::size_t>(phase)];
+    bump(histogram.buckets[bucketOf(elapsedTicks)], weight);
+    if (elapsedTicks > histogram.max.load(std::memory_order_relaxed)) {
+        histogram.max.store(elapsedTicks, std::memory_order_relaxed);
+    }
+}
+
+void Instrumentation::count(const Counter counter, const std::uint64_t amount) {
+    bump(localRecorder().counters[static_cast<std::size_t>(counter)], amount);
+}
+
+std::vector<Instrumentation::Summary> Instrumentation::summarize() {
+    const auto scale = nanosecondsPerTick();
+    std::vector<std::uint64_t> merged(BUCKETS);
+    std::vector<Summary> summaries;
+    auto &shared = registry();
+    std::lock_guard lock(shared.mutex);
+    for (auto p = 0; p < PHASES; p++) {
+        std::ranges::fill(merged, 0);
+        std::uint64_t count = 0;
+        std::uint64_t max = 0;
+        for (const auto &recorder: shared.recorders) {
+            const auto &histogram = recorder->phases[p];
+            for (std::size_t b = 0; b < BUCKETS; b++) {
+                const auto value = histogram.buckets[b].load(std::memory_order_relaxed);
+                merged[b] += value;
+                count += value;
+            }
+            max = std::max(max, histogram.max.load(std::memory_order_relaxed));
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        const auto percentile = [&merged, count, max, scale](const double quantile) {
+            const auto target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(
+                                                            std::ceil(quantile * static_cast<double>(count))));
+            std::uint64_t seen = 0;
+            for (std::size_t b = 0; b < BUCKETS; b++) {
+                seen += merged[b];
+                if (seen >= target) {
+                    return static_cast<double>(std::min(bucketCeiling(b), max)) * scale;
+                }
+            }
+            return 0.0;
+        };
+        summaries.push_back({
+            static_cast<Phase>(p), count, percentile(0.5), percentile(0.99), percentile(0.999),
+            static_cast<double>(max) * scale
+        });
+    }
+    return summaries;
+}
+
+std::array<std::uint64_t, Instrumentation::COUNTERS> Instrumentation::counters() {
+    std::array<std::uint64_t, COUNTERS> totals{};
+    auto &shared = registry();
+    std::lock_guard lock(shared.mutex);
+    for (const auto &recorder: shared.recorders) {
+        for (auto c = 0; c < COUNTERS; c++) {
+            totals[c] += recorder->counters[c].load(std::memory_order_relaxed);
+        }
+    }
+    return totals;
+}
+
+void Instrumentation::reset() {
+    auto &shared = registry();
+    std::lock_guard lock(shared.mutex);
+    for (const auto &recorder: shared.recorders) {
+        for (auto &histogram: recorder->phases) {
+            for (auto &bucket: histogram.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            histogram.max.store(0, std::memory_order_relaxed);
+        }
+        for (auto &counter: recorder->counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+Instrumentation::Phase Instrumentation::streetPhase(const int street) {
+    return static_cast<Phase>(static_cast<int>(Phase::PREFLOP) + std::clamp(street, 0, 3));
+}
+
+const char *Instrumentation::phaseName(const Phase phase) {
+    switch (phase) {
+        case Phase::HAND: return "hand";
+        case Phase::SHUFFLE: return "shuffle";
+        case Phase::DEAL: return "deal";
+        case Phase::PREFLOP: return "preflop";
+        case Phase::FLOP: return "flop";
+        case Phase::TURN: return "turn";
+        case Phase::RIVER: return "river";
+        case Phase::SHOWDOWN: return "showdown";
+        case Phase::DECISION: return "decision";
+    }
+    return "";
+}
+
+const char *Instrumentation::counterName(const Counter counter) {
+    switch (counter) {
+        case Counter::FOLDS: return "folds";
+        case Counter::CHECKS: return "checks";
+        case Counter::CALLS: return "calls";
+        case Counter::RAISES: return "raises";
+    }
+    return "";
+}
@@ -0,0 +1,160 @@
+﻿#include "Leaderboard.h"
+
+#include <algorithm>
+#include <mutex>
+
+Leaderboard::Leaderboard() : rng_(std::random_device{}()), root_(NIL) {
+}
+
+void Leaderboard::update(const std::string &name, const int chips) {
+    std::unique_lock lock(mutex_);
+    auto [found, inserted] = index_.try_emplace(name, NIL);
+    if (!inserted) {
+        if (nodes_[found->second].chips == chips) {
+            return;
+        }
+        root_ = erase(root_, found->second);
+    } else if (!freeNodes_.empty()) {
+        found->second = freeNodes_.back();
+        freeNodes_.pop_back();
+        nodes_[found->second].name = name;
+    } else {
+        found->second = static_cast<int>(nodes_.size());
+        nodes_.push_back({name, 0, 0, NIL, NIL, 1});
+    }
+
+    auto &node = nodes_[found->second];
+    node.chips = chips;
+    node.priority = rng_();
+    node.left = NIL;
+    node.right = NIL;
+    node.size = 1;
+    root_ = insert(root_, found->second);
+}
+
+bool Leaderboard::remove(const std::string &name) {
+    std::unique_lock lock(mutex_);
+    const auto found = index_.find(name);
+    if (found == index_.end()) {
+        return false;
+    }
+    root_ = erase(root_, found->second);
+    freeNodes_.push_back(found->second);
+    index_.erase(found);
+    return true;
+}
+
+std::optional<std::size_t> Leaderboard::rankOf(const std::string &name) const {
+    std::shared_lock lock(mutex_);
+    const auto found = index_.find(name);
+    if (found == index_.end()) {
+        return std::nullopt;
+    }
+
+    const auto target = found->second;
+    std::size_t rank = 0;
+    auto node = root_;
+    while (node != target) {
+        if (precedes(node, target)) {
+            rank += sizeOf(nodes_[node].left) + 1;
+            node = nodes_[node].right;
+        } else {
+            node = nodes_[node].left;
+        }
+    }
+    return rank + sizeOf(nodes_[target].left) + 1;
+}
+
+std::vector<Leaderboard::Entry> Leaderboard::top(const std::size_t count) const {
+    std::shared_lock lock(mutex_);
+    std::vector<Entry> entries;
+    entries.reserve(std::min<std::size_t>(count, index_.size()));
+
+    std::vector<int> path;
+    auto node = root_;
+    while (entries.size() < count && (node != NIL || !path.empty())) {
+        while (node != NIL) {
+            path.push_back(node);
+            node = nodes_[node].left;
+        }
+        node = path.back();
+        path.pop_back();
+        entries.push_back({nodes_[node].name, nodes_[node].chips});
+        node = nodes_[node].right;
+    }
+    return entries;
+}
+
+std::size_t Leaderboard::size() const {
+    std::shared_lock lock(mutex_);
+    return index_.size();
+}
+
+void Leaderboard::clear() {
+    std::unique_lock lock(mutex_);
+    nodes_.clear();
+    freeNodes_.clear();
+    index_.clear();
+    root_ = NIL;
+}
+
+bool Leaderboard::precedes(const int a, const int b) const {
+    const auto &x = nodes_[a];
+    const auto &y = nodes_[b];
+    return x.chips != y.chips ? x.chips > y.chips : x.name < y.name;
+}
+
+std::uint32_t Leaderboard::sizeOf(const int node) const {
+    return node == NIL ? 0 : nodes_[node].size;
+}
+
+void Leaderboard::pull(const int node) {
+    nodes_[node].size = sizeOf(nodes_[node].left) + sizeOf(nodes_[node].right) + 1;
+}
+
+int Leaderboard::merge(const int left, const int right) {
+    if (left == NIL) return right;
+    if (right == NIL) return left;
+    if (nodes_[left].priority > nodes_[right].priority) {
+        nodes_[left].right = merge(nodes_[left].right, right);
+        pull(left);
+        return left;
+    }
+    nodes_[right].left = merge(left, nodes_[right].left);
+    pull(right);
+    return right;
+}
+
+std::pair<int, int> Leaderboard::split(const int tree, const int key) {
+    if (tree == NIL) {
+        return {NIL, NIL};
+    }
+    if (precedes(tree, key)) {
+        const auto [left, right] = split(nodes_[tree].right, key);
+        nodes_[tree].right = left;
+        pull(tree);
+        return {tree, right};
+    }
+    const auto [left, right] = split(nodes_[tree].left, key);
+    nodes_[tree].left = right;
+    pull(tree);
+    return {left, tree};
+}
+
+int Leaderboard::insert(const int tree, const int node) {
+    const auto [left, right] = split(tree, node);
+    return merge(merge(left, node), right);
+}
+
+int Leaderboard::erase(const int tree, const int node) {
+    if (tree == node) {
+        return merge(nodes_[tree].left, nodes_[tree].right);
+    }
+    if (precedes(tree, node)) {
+        nodes_[tree].right = erase(nodes_[tree].right, node);
+    } else {
+        nodes_[tree].left = erase(nodes_[tree].left, node);
+    }
+    pull(tree);
+    return tree;
+}
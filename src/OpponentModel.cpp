@@ -0,0 +1,160 @@
+﻿#include "OpponentModel.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <numeric>
+
+namespace {
+    int sizeBucket(const int amount, const int pot) {
+        if (amount <= 0) return 0;
+        if (amount * 2 <= pot) return 1;
+        if (amount <= pot) return 2;
+        return 3;
+    }
+
+    template<std::size_t N>
+    int overflowShift(const std::array<std::uint16_t, N> &counts, const std::array<std::uint16_t, N> &extra,
+                      int shift) {
+        for (std::size_t i = 0; i < N; i++) {
+            while (((counts[i] + extra[i]) >> shift) > UINT16_MAX) {
+                shift++;
+            }
+        }
+        return shift;
+    }
+
+    template<std::size_t N>
+    void addCounts(std::array<std::uint16_t, N> &counts, const std::array<std::uint16_t, N> &extra,
+                   const int shift) {
+        for (std::size_t i = 0; i < N; i++) {
+            counts[i] = static_cast<std::uint16_t>((counts[i] + extra[i]) >> shift);
+        }
+    }
+}
+
+int OpponentModelStore::Model::actionCount(const int street, const Player::Action action) const {
+    const auto &buckets = actions[street][static_cast<int>(action)];
+    return std::accumulate(buckets.begin(), buckets.end(), 0);
+}
+
+double OpponentModelStore::Model::looseness(const int street) const {
+    const auto folds = actionCount(street, Player::Action::FOLD);
+    const auto continues = actionCount(street, Player::Action::CALL) + actionCount(street, Player::Action::RAISE);
+    return (continues + 1.0) / (continues + folds + 2.0);
+}
+
+double OpponentModelStore::Model::aggression(const int street) const {
+    const auto raises = actionCount(street, Player::Action::RAISE);
+    const auto calls = actionCount(street, Player::Action::CALL);
+    return (raises + 1.0) / (raises + calls + 2.0);
+}
+
+double OpponentModelStore::Model::showdownStrength() const {
+    constexpr auto priorCount = 3;
+    constexpr auto priorCategory = static_cast<int>(HandEvaluator::Category::TWO_PAIR);
+    auto weighted = priorCount * priorCategory;
+    auto total = priorCount;
+    for (auto c = 0; c < CATEGORIES; c++) {
+        weighted += c * showdowns[c];
+        total += showdowns[c];
+    }
+    return static_cast<double>(weighted) / (total * (CATEGORIES - 1));
+}
+
+OpponentModelStore::OpponentModelStore(const std::size_t capacity)
+    : slots_(std::bit_ceil(std::max(capacity, PROBE_LIMIT))), mask_(slots_.size() - 1), used_(0), clock_(0) {
+}
+
+std::uint64_t OpponentModelStore::idOf(const std::string_view playerName) {
+    return std::hash<std::string_view>{}(playerName) | 1;
+}
+
+OpponentModelStore::Model &OpponentModelStore::modelFor(const std::string_view playerName) {
+    return slotFor(idOf(playerName));
+}
+
+OpponentModelStore::Model &OpponentModelStore::slotFor(const std::uint64_t id) {
+    Model *empty = nullptr;
+    Model *oldest = nullptr;
+
+    for (std::size_t probe = 0; probe < PROBE_LIMIT; probe++) {
+        auto &slot = slots_[(id + probe) & mask_];
+        if (slot.id == id) {
+            slot.lastUpdate = ++clock_;
+            return slot;
+        }
+        if (slot.id == 0) {
+            if (!empty) empty = &slot;
+        } else if (!oldest || slot.lastUpdate < oldest->lastUpdate) {
+            oldest = &slot;
+        }
+    }
+
+    auto &slot = empty ? *empty : *oldest;
+    if (empty) used_++;
+    slot = Model{};
+    slot.id = id;
+    slot.lastUpdate = ++clock_;
+    return slot;
+}
+
+const OpponentModelStore::Model *OpponentModelStore::find(const std::string_view playerName) const {
+    return find(idOf(playerName));
+}
+
+const OpponentModelStore::Model *OpponentModelStore::find(const std::uint64_t id) const {
+    for (std::size_t probe = 0; probe < PROBE_LIMIT; probe++) {
+        if (const auto &slot = slots_[(id + probe) & mask_]; slot.id == id) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void OpponentModelStore::recordAction(const std::string_view playerName, const Player::Action action, const int amount,
+                                      const int pot, const int street) {
+    auto &streetCounts = modelFor(playerName).actions[std::clamp(street, 0, STREETS - 1)];
+    auto &counter = streetCounts[static_cast<int>(action)][sizeBucket(amount, pot)];
+    if (counter == UINT16_MAX) {
+        for (auto &buckets: streetCounts) {
+            for (auto &count: buckets) {
+                count /= 2;
+            }
+        }
+    }
+    counter++;
+}
+
+void OpponentModelStore::recordShowdown(const std::string_view playerName, const HandEvaluator::Category category) {
+    auto &showdowns = modelFor(playerName).showdowns;
+    if (showdowns[static_cast<int>(category)] == UINT16_MAX) {
+        for (auto &count: showdowns) {
+            count /= 2;
+        }
+    }
+    showdowns[static_cast<int>(category)]++;
+}
+
+void OpponentModelStore::merge(const OpponentModelStore &other) {
+    for (const auto &source: other.slots_) {
+        if (source.id == 0) continue;
+        auto &target = slotFor(source.id);
+        for (auto street = 0; street < STREETS; street++) {
+            auto shift = 0;
+            for (auto action = 0; action < ACTIONS; action++) {
+                shift = overflowShift(target.actions[street][action], source.actions[street][action], shift);
+            }
+            for (auto action = 0; action < ACTIONS; action++) {
+                addCounts(target.actions[street][action], source.actions[street][action], shift);
+            }
+        }
+        addCounts(target.showdowns, source.showdowns, overflowShift(target.showdowns, source.showdowns, 0));
+    }
+}
+
+std::size_t OpponentModelStore::size() const { return used_; }
+
+std::size_t OpponentModelStore::capacity() const { return slots_.size(); }
+
+std::size_t OpponentModelStore::memoryFootprint() const { return slots_.size() * sizeof(Model); }
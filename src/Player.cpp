@@ -2,6 +2,19 @@
 
 Player::Player(std::string name, const int initialChips)
     : name_(std::move(name)), chips_(initialChips), folded_(false) {
+    holeCards_.reserve(4);
+}
+
+Task<Player::Decision> Player::decide(const DecisionView &view) {
+    const auto action = makeDecision(view.currentBet, view.chipsCommitted, view.communityCards);
+    const auto raiseAmount = action == Action::RAISE ? getRaiseAmount(view.currentBet, view.chipsCommitted) : 0;
+    co_return Decision{action, raiseAmount};
+}
+
+void Player::observeAction(const std::string &, Action, int, int, int) {
+}
+
+void Player::observeShowdown(const std::string &, const std::vector<Card> &, const std::vector<Card> &) {
 }
 
 void Player::receiveCard(const Card card) {
@@ -33,4 +46,6 @@ int Player::getChipCount() const { return chips_.getChips(); }
 
 const std::vector<Card> &Player::getHoleCards() const { return holeCards_; }
 
+bool Player::isHuman() const { return false; }
+
 bool Player::isAllIn() const { return getChipCount() == 0; }
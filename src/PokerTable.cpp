@@ -1,31 +1,47 @@
 ﻿#include "PokerTable.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
 #include <memory>
 #include <random>
 #include <ranges>
+#include <sstream>
 
+#include "Checkpoint.h"
+#include "Console.h"
+#include "GameVariant.h"
+#include "HandEvaluator.h"
+#include "Instrumentation.h"
 #include "Player.h"
+#include "TableScheduler.h"
+#include "Tracer.h"
 
-PokerTable::PokerTable() : pot_(0), gameManager_(50) {
+PokerTable::PokerTable()
+    : rng_(std::random_device{}()), pot_(0), smallBlind_(0), bigBlind_(0), ante_(0), button_(0), gameManager_(50),
+      observer_(nullptr), restored_(false) {
+    communityCards_.reserve(5);
     initializeDeck();
 }
 
 void PokerTable::addPlayer(std::unique_ptr<Player> player) {
+    gameManager_.recordChips(*player);
     players_.push_back(std::move(player));
+    contributed_.reserve(players_.size());
 }
 
 void PokerTable::startGame() {
-    showWelcomeScreen();
+    if (!restored_) {
+        showWelcomeScreen();
+    }
 
-    std::cout << "=== 德州扑克游戏开始 ===" << std::endl;
+    Console::out() << "=== 德州扑克游戏开始 ===" << '\n';
 
     while (players_.size() > 1 && !gameManager_.shouldEndGame(players_)) {
         playHand();
 
-        std::erase_if(players_,
-                      [](const std::unique_ptr<Player> &p) {
-                          return p->getChipCount() <= 0;
-                      });
+        removeBustedPlayers();
 
         gameManager_.displayGameStatus(players_);
 
@@ -36,23 +52,195 @@ void PokerTable::startGame() {
 
     gameManager_.displayGameOver(players_);
     gameManager_.saveGameHistory();
+
+    if (checkpointPath_.empty()) {
+        return;
+    }
+    if (gameManager_.isSaveRequested()) {
+        Checkpoint::writeFile(checkpointPath_, saveCheckpoint());
+        Console::out() << "💾 存档已写入: " << checkpointPath_ << '\n';
+    } else {
+        std::remove(checkpointPath_.c_str());
+    }
+}
+
+Task<> PokerTable::playHandsAsync(const int maxHands) {
+    for (auto hand = 0; hand < maxHands && players_.size() > 1; hand++) {
+        recordStacks();
+        co_await playHandAsync();
+        settleHand();
+        removeBustedPlayers();
+    }
+}
+
+void PokerTable::setBlinds(const int smallBlind, const int bigBlind, const int ante) {
+    smallBlind_ = smallBlind;
+    bigBlind_ = bigBlind;
+    ante_ = ante;
+}
+
+void PokerTable::setVariant(const GameSettings::Variant variant) {
+    gameSettings_.setVariant(variant);
+}
+
+void PokerTable::setHistoryRecorded(const bool recorded) {
+    gameSettings_.setHistoryRecorded(recorded);
+    gameManager_ = GameManager(gameSettings_.getMaxRounds(), recorded);
+    for (const auto &player: players_) {
+        gameManager_.recordChips(*player);
+    }
+}
+
+void PokerTable::setSeed(const std::uint32_t seed) { rng_.seed(seed); }
+
+std::unique_ptr<Player> PokerTable::takePlayer(const std::size_t seat) {
+    auto player = std::move(players_[seat]);
+    players_.erase(players_.begin() + static_cast<std::ptrdiff_t>(seat));
+    if (seat < button_ && button_ > 0) {
+        button_--;
+    }
+    return player;
+}
+
+std::vector<std::unique_ptr<Player> > PokerTable::takeBustedPlayers() {
+    std::vector<std::unique_ptr<Player> > busted;
+    for (auto seat = players_.size(); seat-- > 0;) {
+        if (players_[seat]->getChipCount() <= 0) {
+            busted.push_back(takePlayer(seat));
+        }
+    }
+    return busted;
+}
+
+const std::vector<std::unique_ptr<Player> > &PokerTable::getPlayers() const {
+    return players_;
+}
+
+void PokerTable::setSettlementHandler(SettlementHandler handler) { onSettlement_ = std::move(handler); }
+
+void PokerTable::setObserver(TableObserver *observer) { observer_ = observer; }
+
+void PokerTable::setCheckpointPath(std::string path) { checkpointPath_ = std::move(path); }
+
+std::vector<std::uint8_t> PokerTable::saveCheckpoint() const {
+    std::ostringstream rngState;
+    rngState << rng_;
+
+    std::vector<std::uint8_t> payload;
+    payload.reserve(rngState.view().size() + 1024);
+    const Checkpoint::Writer writer(payload);
+    gameSettings_.save(writer);
+    gameManager_.save(writer);
+    writer.i32(smallBlind_);
+    writer.i32(bigBlind_);
+    writer.i32(ante_);
+    writer.u32(static_cast<std::uint32_t>(button_));
+    writer.text(rngState.view());
+    writer.u32(static_cast<std::uint32_t>(players_.size()));
+    for (const auto &player: players_) {
+        writer.text(player->getName());
+        writer.i32(player->getChipCount());
+        writer.u8(player->isHuman() ? 1 : 0);
+    }
+    return payload;
+}
+
+bool PokerTable::restoreCheckpoint(const std::span<const std::uint8_t> payload, const PlayerFactory &factory) {
+    Checkpoint::Reader reader(payload);
+    auto settings = gameSettings_;
+    GameManager manager(settings.getMaxRounds(), settings.isHistoryRecorded());
+    if (!settings.restore(reader) || !manager.restore(reader)) {
+        return false;
+    }
+    const auto smallBlind = reader.i32();
+    const auto bigBlind = reader.i32();
+    const auto ante = reader.i32();
+    const auto button = reader.u32();
+    auto rng = rng_;
+    std::istringstream rngState(reader.text());
+    if (!(rngState >> rng)) {
+        return false;
+    }
+
+    const auto seats = reader.u32();
+    std::vector<std::unique_ptr<Player> > players;
+    for (std::uint32_t seat = 0; seat < seats && reader.ok(); seat++) {
+        auto name = reader.text();
+        const auto chips = reader.i32();
+        const auto human = reader.u8() != 0;
+        if (reader.ok() && chips > 0) {
+            players.push_back(factory(name, chips, human));
+        }
+    }
+    if (!reader.complete() || players.size() != seats || button >= std::max<std::uint32_t>(seats, 1)) {
+        return false;
+    }
+
+    gameSettings_ = settings;
+    gameManager_ = std::move(manager);
+    setBlinds(smallBlind, bigBlind, ante);
+    button_ = button;
+    rng_ = rng;
+    players_.clear();
+    for (auto &player: players) {
+        addPlayer(std::move(player));
+    }
+    restored_ = true;
+    return true;
+}
+
+void PokerTable::recordStacks() {
+    if (!onSettlement_) {
+        return;
+    }
+    settlements_.clear();
+    for (const auto &player: players_) {
+        settlements_.push_back({player.get(), player->getChipCount()});
+    }
+}
+
+void PokerTable::settleHand() {
+    if (!onSettlement_) {
+        return;
+    }
+    for (auto &[player, delta]: settlements_) {
+        delta = player->getChipCount() - delta;
+    }
+    onSettlement_(settlements_);
+}
+
+void PokerTable::removeBustedPlayers() {
+    for (const auto &player: players_) {
+        if (player->getChipCount() <= 0) {
+            gameManager_.recordElimination(*player);
+        } else {
+            gameManager_.recordChips(*player);
+        }
+    }
+    std::erase_if(players_,
+                  [](const std::unique_ptr<Player> &p) {
+                      return p->getChipCount() <= 0;
+                  });
 }
 
 void PokerTable::showWelcomeScreen() {
-    std::cout << "==========================================" << std::endl;
-    std::cout << "           🎰 德州扑克游戏 🎰           " << std::endl;
-    std::cout << "==========================================" << std::endl;
+    Console::out() << "==========================================" << '\n';
+    Console::out() << "           🎰 德州扑克游戏 🎰           " << '\n';
+    Console::out() << "==========================================" << '\n';
 
     char choice;
-    std::cout << "1. 开始游戏（默认设置）" << std::endl;
-    std::cout << "2. 配置游戏设置" << std::endl;
-    std::cout << "3. 退出游戏" << std::endl;
-    std::cout << "请选择 (1-3): ";
+    Console::out() << "1. 开始游戏（默认设置）" << '\n';
+    Console::out() << "2. 配置游戏设置" << '\n';
+    Console::out() << "3. 退出游戏" << '\n';
+    Console::out() << "请选择 (1-3): ";
     std::cin >> choice;
 
     if (choice == '2') {
         gameSettings_.configureSettings();
-        gameManager_ = GameManager(gameSettings_.getMaxRounds());
+        gameManager_ = GameManager(gameSettings_.getMaxRounds(), gameSettings_.isHistoryRecorded());
+        for (const auto &player: players_) {
+            gameManager_.recordChips(*player);
+        }
     } else if (choice == '3') {
         exit(0);
     }
@@ -62,34 +250,32 @@ void PokerTable::showWelcomeScreen() {
 
 void PokerTable::initializeDeck() {
     deck_.clear();
-    for (auto s = 0; s < 4; s++) {
-        for (auto r = 2; r <= 14; r++) {
-            deck_.emplace_back(
-                static_cast<Card::Suit>(s),
-                static_cast<Card::Rank>(r)
-            );
-        }
+    for (const auto index: HoldemVariant::DECK) {
+        deck_.push_back(HandEvaluator::cardFromIndex(index));
     }
 }
 
 void PokerTable::shuffleDeck() {
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::ranges::shuffle(deck_, g);
+    POKER_TIME_SCOPE(Instrumentation::Phase::SHUFFLE);
+    POKER_TRACE_SCOPE("shuffle");
+    std::ranges::shuffle(deck_, rng_);
 }
 
 void PokerTable::dealHoleCards() {
+    POKER_TIME_SCOPE(Instrumentation::Phase::DEAL);
+    POKER_TRACE_SCOPE("deal");
     for (const auto &player: players_) {
         player->clearHand();
-        player->receiveCard(deck_.back());
-        deck_.pop_back();
-        player->receiveCard(deck_.back());
-        deck_.pop_back();
+        for (auto i = 0; i < gameSettings_.getHoleCardCount(); i++) {
+            player->receiveCard(deck_.back());
+            deck_.pop_back();
+        }
     }
 }
 
-int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards) {
-    std::vector<Card> allCards = holeCards;
+int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards,
+                                     std::pmr::memory_resource *resource) {
+    std::pmr::vector<Card> allCards(holeCards.begin(), holeCards.end(), resource);
     allCards.insert(allCards.end(), communityCards.begin(), communityCards.end());
 
     std::ranges::sort(allCards,
@@ -99,15 +285,15 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
 
     auto score = 0;
 
-    std::map<Card::Suit, int> suitCount;
-    std::map<Card::Suit, std::vector<Card> > suitCards;
+    std::pmr::map<Card::Suit, int> suitCount(resource);
+    std::pmr::map<Card::Suit, std::pmr::vector<Card> > suitCards(resource);
     for (const auto &card: allCards) {
         suitCount[card.getSuit()]++;
         suitCards[card.getSuit()].push_back(card);
     }
 
     for (const auto &card: suitCards | std::views::values) {
-        if (const std::vector<Card> &cards = card; cards.size() >= 5) {
+        if (const std::pmr::vector<Card> &cards = card; cards.size() >= 5) {
             auto straightCount = 1;
             for (size_t i = 1; i < cards.size(); i++) {
                 if (static_cast<int>(cards[i - 1].getRank()) == static_cast<int>(cards[i].getRank()) + 1) {
@@ -122,7 +308,7 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
         }
     }
 
-    std::map<Card::Rank, int> rankCount;
+    std::pmr::map<Card::Rank, int> rankCount(resource);
     for (const auto &card: allCards) {
         rankCount[card.getRank()]++;
     }
@@ -164,7 +350,7 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
         return 6000000 + static_cast<int>(threeRank) * 10000 + static_cast<int>(twoRank);
     }
 
-    std::vector<int> uniqueRanks;
+    std::pmr::vector<int> uniqueRanks(resource);
     for (const auto &card: allCards) {
         uniqueRanks.push_back(static_cast<int>(card.getRank()));
     }
@@ -184,7 +370,7 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
     }
 
     if (hasThree) {
-        std::vector<int> kickers;
+        std::pmr::vector<int> kickers(resource);
         for (const auto &card: allCards) {
             if (card.getRank() != threeRank) {
                 kickers.push_back(static_cast<int>(card.getRank()));
@@ -200,7 +386,7 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
         return 3000000 + static_cast<int>(threeRank) * 10000 + kickerScore;
     }
 
-    std::vector<Card::Rank> pairs;
+    std::pmr::vector<Card::Rank> pairs(resource);
     for (const auto &[rk, index]: rankCount) {
         Card::Rank rank = rk;
         if (auto count = index; count == 2) {
@@ -223,7 +409,7 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
     }
 
     if (pairs.size() == 1) {
-        std::vector<int> kickers;
+        std::pmr::vector<int> kickers(resource);
         for (const auto &card: allCards) {
             if (card.getRank() != pairs[0]) {
                 kickers.push_back(static_cast<int>(card.getRank()));
@@ -237,7 +423,7 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
         return 1000000 + static_cast<int>(pairs[0]) * 10000 + kickerScore;
     }
 
-    std::vector<int> highCards;
+    std::pmr::vector<int> highCards(resource);
     for (const auto &card: allCards) {
         highCards.push_back(static_cast<int>(card.getRank()));
     }
@@ -247,9 +433,11 @@ int PokerTable::evaluateHandStrength(const std::vector<Card> &holeCards, const s
 }
 
 void PokerTable::determineWinner() {
-    std::cout << "\n=== Showdown ===" << std::endl;
+    POKER_TIME_SCOPE(Instrumentation::Phase::SHOWDOWN);
+    POKER_TRACE_SCOPE("showdown");
+    Console::out() << "\n=== Showdown ===" << '\n';
 
-    std::vector<int> activePlayers;
+    std::pmr::vector<int> activePlayers(&arena_);
     for (size_t i = 0; i < players_.size(); i++) {
         if (!players_[i]->isFolded()) {
             activePlayers.push_back(static_cast<int>(i));
@@ -257,7 +445,7 @@ void PokerTable::determineWinner() {
     }
 
     if (activePlayers.empty()) {
-        std::cout << "No active players!" << std::endl;
+        Console::out() << "No active players!" << '\n';
         return;
     }
 
@@ -265,81 +453,161 @@ void PokerTable::determineWinner() {
         const auto winnerIndex = activePlayers[0];
         potDisplay_.distributeToWinner(players_[winnerIndex]->getName());
         players_[winnerIndex]->addChips(pot_);
-        gameManager_.recordRoundResult(players_[winnerIndex]->getName() + " 获胜");
+        gameManager_.recordRoundWinner(players_[winnerIndex]->getName());
         return;
     }
 
     for (const auto i: activePlayers) {
-        std::cout << players_[i]->getName() << "'s hand: ";
+        Console::out() << players_[i]->getName() << "'s hand: ";
         for (const auto &card: players_[i]->getHoleCards()) {
-            std::cout << card.toString() << " ";
+            Console::out() << card.toString() << " ";
         }
-        std::cout << std::endl;
+        Console::out() << '\n';
     }
 
-    std::cout << "Community cards: ";
+    Console::out() << "Community cards: ";
     for (const auto &card: communityCards_) {
-        std::cout << card.toString() << " ";
+        Console::out() << card.toString() << " ";
     }
-    std::cout << std::endl;
+    Console::out() << '\n';
 
-    std::vector<std::pair<int, int> > playerScores;
+    std::pmr::vector<std::pair<int, int> > playerScores(&arena_);
 
+    const auto omaha = gameSettings_.getVariant() == GameSettings::Variant::POT_LIMIT_OMAHA;
     for (auto i: activePlayers) {
-        auto score = evaluateHandStrength(players_[i]->getHoleCards(), communityCards_);
+        const auto holeCards = HandEvaluator::toMask(players_[i]->getHoleCards());
+        const auto board = HandEvaluator::toMask(communityCards_);
+        auto score = omaha
+                         ? HandEvaluator::evaluateOmaha(holeCards, board)
+                         : HandEvaluator::evaluate(holeCards | board);
         playerScores.emplace_back(i, score);
-        std::cout << players_[i]->getName() << "'s hand score: " << score << std::endl;
+        Console::out() << players_[i]->getName() << "'s hand score: " << score << '\n';
+    }
+
+    for (const auto i: activePlayers) {
+        for (const auto &observer: players_) {
+            observer->observeShowdown(players_[i]->getName(), players_[i]->getHoleCards(), communityCards_);
+        }
+        if (observer_) {
+            observer_->onShowdown(players_[i]->getName(), players_[i]->getHoleCards());
+        }
     }
 
-    const auto winner = std::ranges::max_element(playerScores,
-                                                 [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
-                                                     return a.second < b.second;
-                                                 });
+    std::pmr::vector<int> levels(&arena_);
+    for (const auto i: activePlayers) {
+        levels.push_back(contributed_[i]);
+    }
+    std::ranges::sort(levels);
+    const auto duplicates = std::ranges::unique(levels);
+    levels.erase(duplicates.begin(), duplicates.end());
+
+    std::pmr::vector<int> winners(&arena_);
+    auto awarded = 0;
+    auto previous = 0;
+    for (std::size_t level = 0; level < levels.size(); level++) {
+        const auto cap = levels[level];
+        auto amount = 0;
+        for (const auto contribution: contributed_) {
+            amount += std::clamp(contribution, previous, cap) - previous;
+        }
+        previous = cap;
+        if (amount == 0) {
+            continue;
+        }
 
-    const int maxScore = winner->second;
+        winners.clear();
+        auto bestScore = -1;
+        auto eligible = 0;
+        for (const auto &[index, score]: playerScores) {
+            if (contributed_[index] < cap) continue;
+            eligible++;
+            if (score > bestScore) {
+                bestScore = score;
+                winners.clear();
+            }
+            if (score == bestScore) {
+                winners.push_back(index);
+            }
+        }
+        awardShare(level == 0, level == 0 && levels.size() == 1, eligible, amount, winners);
+        awarded += amount;
+    }
+    if (awarded < pot_ && !winners.empty()) {
+        players_[winners.front()]->addChips(pot_ - awarded);
+    }
+}
 
-    std::vector<int> winners;
-    for (const auto &[score, index]: playerScores) {
-        if (index == maxScore) {
-            winners.push_back(score);
+void PokerTable::awardShare(const bool mainPot, const bool onlyPot, const int eligible, const int amount,
+                            const std::span<const int> winners) {
+    if (eligible == 1) {
+        Console::out() << "未被跟注的 " << amount << " 筹码退还给 " << players_[winners.front()]->getName() << '\n';
+        players_[winners.front()]->addChips(amount);
+        if (mainPot) {
+            gameManager_.recordRoundWinner(players_[winners.front()]->getName());
         }
+        return;
     }
 
     if (winners.size() == 1) {
-        const auto winnerIndex = winners[0];
-        potDisplay_.distributeToWinner(players_[winnerIndex]->getName());
-        players_[winnerIndex]->addChips(pot_);
-        gameManager_.recordRoundResult(players_[winnerIndex]->getName() + " 获胜");
-    } else {
-        std::vector<std::string> winnerNames;
+        if (onlyPot) {
+            potDisplay_.distributeToWinner(players_[winners.front()]->getName());
+        } else {
+            Console::out() << players_[winners.front()]->getName() << " 赢得" << (mainPot ? "主池 " : "边池 ")
+                    << amount << " 筹码" << '\n';
+        }
+        players_[winners.front()]->addChips(amount);
+        if (mainPot) {
+            gameManager_.recordRoundWinner(players_[winners.front()]->getName());
+        }
+        return;
+    }
+
+    if (onlyPot) {
+        std::pmr::vector<std::string_view> winnerNames(&arena_);
         for (const auto winnerIndex: winners) {
             winnerNames.push_back(players_[winnerIndex]->getName());
         }
         potDisplay_.distributeToWinners(winners, winnerNames);
-
-        const auto share = pot_ / winners.size();
+    } else {
         for (const auto winnerIndex: winners) {
-            players_[winnerIndex]->addChips(static_cast<int>(share));
+            Console::out() << players_[winnerIndex]->getName() << " ";
         }
-        gameManager_.recordRoundResult("平局: " + std::to_string(winners.size()) + " 人");
+        Console::out() << "平分" << (mainPot ? "主池 " : "边池 ") << amount << " 筹码" << '\n';
+    }
+
+    const auto share = amount / static_cast<int>(winners.size());
+    for (const auto winnerIndex: winners) {
+        players_[winnerIndex]->addChips(share);
+    }
+    players_[winners.front()]->addChips(amount - share * static_cast<int>(winners.size()));
+    if (mainPot) {
+        gameManager_.recordRoundSplit(winners.size());
     }
 }
 
-void PokerTable::awardPot(const std::vector<bool> &folded) const {
+void PokerTable::awardPot(const std::pmr::vector<bool> &folded) const {
     for (size_t i = 0; i < players_.size(); i++) {
         if (!folded[i]) {
-            std::cout << players_[i]->getName() << " wins " << pot_ << " chips!" << std::endl;
+            Console::out() << players_[i]->getName() << " wins " << pot_ << " chips!" << '\n';
             players_[i]->addChips(pot_);
             break;
         }
     }
 }
 
-bool PokerTable::bettingRound() {
-    std::vector chipsCommitted(players_.size(), 0);
-    auto currentBet = 0;
-    std::vector acted(players_.size(), false);
-    constexpr auto startPlayer = 0;
+int PokerTable::postForcedBet(const std::size_t seat, const int amount) {
+    const auto posted = std::min(amount, players_[seat]->getChipCount());
+    players_[seat]->takeChips(posted);
+    pot_ += posted;
+    contributed_[seat] += posted;
+    return posted;
+}
+
+Task<bool> PokerTable::bettingRoundAsync(std::pmr::vector<int> chipsCommitted, int currentBet,
+                                         const int startPlayer) {
+    POKER_TIME_SCOPE(Instrumentation::streetPhase(currentStreet()));
+    POKER_TRACE_ASYNC_SCOPE(Tracer::streetName(currentStreet()), this);
+    std::pmr::vector<bool> acted(players_.size(), false, &arena_);
     auto currentPlayer = startPlayer;
 
     while (true) {
@@ -366,13 +634,32 @@ bool PokerTable::bettingRound() {
 
         if (!players_[currentPlayer]->isFolded() && !acted[currentPlayer] && !players_[currentPlayer]->isAllIn()) {
             const auto &player = players_[currentPlayer];
+            const auto potBefore = pot_;
 
-            const Player::Action action = player->makeDecision(
-                currentBet, chipsCommitted[currentPlayer], communityCards_);
+            auto opponents = 0;
+            for (const auto &plr: players_) {
+                if (plr != player && !plr->isFolded()) opponents++;
+            }
+            const Player::DecisionView view{
+                currentBet, chipsCommitted[currentPlayer], pot_, opponents, currentStreet(), communityCards_,
+                TableScheduler::current()
+            };
+            Player::Decision decision{};
+            {
+                POKER_TIME_SCOPE(Instrumentation::Phase::DECISION);
+                POKER_TRACE_ASYNC_SCOPE("decision", this, currentPlayer);
+                decision = co_await player->decide(view);
+            }
+            const auto [action, raiseAmount] = decision;
+            POKER_COUNT(static_cast<Instrumentation::Counter>(action));
 
             switch (action) {
-                case Player::Action::CHECK:
                 case Player::Action::FOLD:
+                    player->fold();
+                    acted[currentPlayer] = true;
+                    break;
+
+                case Player::Action::CHECK:
                     acted[currentPlayer] = true;
                     break;
 
@@ -381,10 +668,12 @@ bool PokerTable::bettingRound() {
                         callAmount)) {
                         chipsCommitted[currentPlayer] += callAmount;
                         pot_ += callAmount;
+                        contributed_[currentPlayer] += callAmount;
                     } else {
                         const auto allInAmount = player->getChipCount();
                         chipsCommitted[currentPlayer] += allInAmount;
                         pot_ += allInAmount;
+                        contributed_[currentPlayer] += allInAmount;
                         player->takeChips(allInAmount);
                     }
                     acted[currentPlayer] = true;
@@ -392,13 +681,18 @@ bool PokerTable::bettingRound() {
                 }
 
                 case Player::Action::RAISE: {
-                    if (const auto raiseAmount = player->getRaiseAmount(currentBet, chipsCommitted[currentPlayer]);
-                        raiseAmount > currentBet) {
-                        if (const auto totalNeeded = raiseAmount - chipsCommitted[currentPlayer]; player->takeChips(
-                            totalNeeded)) {
-                            chipsCommitted[currentPlayer] = raiseAmount;
-                            pot_ += totalNeeded;
-                            currentBet = raiseAmount;
+                    if (raiseAmount > currentBet) {
+                        auto target = std::min(raiseAmount, chipsCommitted[currentPlayer] + player->getChipCount());
+                        if (gameSettings_.getVariant() == GameSettings::Variant::POT_LIMIT_OMAHA) {
+                            target = std::min(target, currentBet + pot_ + currentBet - chipsCommitted[currentPlayer]);
+                        }
+                        const auto totalNeeded = target - chipsCommitted[currentPlayer];
+                        player->takeChips(totalNeeded);
+                        chipsCommitted[currentPlayer] = target;
+                        pot_ += totalNeeded;
+                        contributed_[currentPlayer] += totalNeeded;
+                        if (target > currentBet) {
+                            currentBet = target;
                             for (size_t i = 0; i < players_.size(); i++) {
                                 if (static_cast<int>(i) != currentPlayer && !players_[i]->isFolded() && !players_[i]->
                                     isAllIn()) {
@@ -412,12 +706,14 @@ bool PokerTable::bettingRound() {
                 }
             }
 
+            notifyAction(currentPlayer, action, pot_ - potBefore, potBefore);
+
             int activeCount = 0;
             for (const auto &plr: players_) {
                 if (!plr->isFolded()) activeCount++;
             }
             if (activeCount <= 1) {
-                return false;
+                co_return false;
             }
         }
 
@@ -437,11 +733,35 @@ bool PokerTable::bettingRound() {
         }
     }
 
-    return true;
+    co_return true;
+}
+
+int PokerTable::currentStreet() const {
+    return communityCards_.size() < 3 ? 0 : static_cast<int>(communityCards_.size()) - 2;
+}
+
+void PokerTable::notifyAction(const int seat, const Player::Action action, const int amount, const int pot) const {
+    const auto street = currentStreet();
+    for (const auto &observer: players_) {
+        observer->observeAction(players_[seat]->getName(), action, amount, pot, street);
+    }
+    if (observer_) {
+        observer_->onAction(players_[seat]->getName(), action, amount, pot, street);
+    }
 }
 
 void PokerTable::playHand() {
+    recordStacks();
+    runSync(playHandAsync());
+    settleHand();
+}
+
+Task<> PokerTable::playHandAsync() {
+    POKER_TIME_SCOPE(Instrumentation::Phase::HAND);
+    POKER_TRACE_ASYNC_SCOPE("hand", this);
+    arena_.reset();
     pot_ = 0;
+    contributed_.assign(players_.size(), 0);
     potDisplay_.clearAllPots();
     communityCards_.clear();
     initializeDeck();
@@ -453,18 +773,40 @@ void PokerTable::playHand() {
 
     dealHoleCards();
 
+    const auto seats = static_cast<int>(players_.size());
+    std::pmr::vector<int> blinds(players_.size(), 0, &arena_);
+    auto currentBet = 0;
+    auto preflopStart = 0;
+    auto postflopStart = 0;
+    if (bigBlind_ > 0 && seats > 1) {
+        button_ = (button_ + 1) % seats;
+        const auto small = seats == 2 ? static_cast<int>(button_) : static_cast<int>(button_ + 1) % seats;
+        const auto big = (small + 1) % seats;
+        for (std::size_t seat = 0; seat < players_.size(); seat++) {
+            postForcedBet(seat, ante_);
+        }
+        blinds[small] = postForcedBet(small, smallBlind_);
+        blinds[big] = postForcedBet(big, bigBlind_);
+        currentBet = bigBlind_;
+        preflopStart = (big + 1) % seats;
+        postflopStart = static_cast<int>(button_ + 1) % seats;
+    }
+
     potDisplay_.displaySimple();
+    if (observer_) {
+        observer_->onHandStarted(players_, button_, pot_);
+    }
 
-    if (!bettingRound()) {
+    if (!co_await bettingRoundAsync(std::move(blinds), currentBet, preflopStart)) {
         potDisplay_.setMainPot(pot_);
         potDisplay_.displaySimple();
 
-        std::vector<bool> folded(players_.size(), false);
+        std::pmr::vector<bool> folded(players_.size(), false, &arena_);
         for (int i = 0; i < players_.size(); i++) {
             folded[i] = players_[i]->isFolded();
         }
         awardPot(folded);
-        return;
+        co_return;
     }
 
     deck_.pop_back();
@@ -472,47 +814,50 @@ void PokerTable::playHand() {
         communityCards_.push_back(deck_.back());
         deck_.pop_back();
     }
-    std::cout << "\nFlop: ";
+    Console::out() << "\nFlop: ";
     showCommunityCards();
+    notifyStreet();
 
     potDisplay_.setMainPot(pot_);
     potDisplay_.displaySimple();
 
-    if (!bettingRound()) {
-        std::vector<bool> folded(players_.size(), false);
+    if (!co_await bettingRoundAsync(std::pmr::vector<int>(players_.size(), 0, &arena_), 0, postflopStart)) {
+        std::pmr::vector<bool> folded(players_.size(), false, &arena_);
         for (int i = 0; i < players_.size(); i++) {
             folded[i] = players_[i]->isFolded();
         }
         awardPot(folded);
-        return;
+        co_return;
     }
 
     deck_.pop_back();
     communityCards_.push_back(deck_.back());
     deck_.pop_back();
-    std::cout << "\nTurn: " << communityCards_.back().toString() << std::endl;
+    Console::out() << "\nTurn: " << communityCards_.back().toString() << '\n';
+    notifyStreet();
 
-    if (!bettingRound()) {
-        std::vector<bool> folded(players_.size(), false);
+    if (!co_await bettingRoundAsync(std::pmr::vector<int>(players_.size(), 0, &arena_), 0, postflopStart)) {
+        std::pmr::vector<bool> folded(players_.size(), false, &arena_);
         for (int i = 0; i < players_.size(); i++) {
             folded[i] = players_[i]->isFolded();
         }
         awardPot(folded);
-        return;
+        co_return;
     }
 
     deck_.pop_back();
     communityCards_.push_back(deck_.back());
     deck_.pop_back();
-    std::cout << "\nRiver: " << communityCards_.back().toString() << std::endl;
+    Console::out() << "\nRiver: " << communityCards_.back().toString() << '\n';
+    notifyStreet();
 
-    if (!bettingRound()) {
-        std::vector<bool> folded(players_.size(), false);
+    if (!co_await bettingRoundAsync(std::pmr::vector<int>(players_.size(), 0, &arena_), 0, postflopStart)) {
+        std::pmr::vector<bool> folded(players_.size(), false, &arena_);
         for (int i = 0; i < players_.size(); i++) {
             folded[i] = players_[i]->isFolded();
         }
         awardPot(folded);
-        return;
+        co_return;
     }
 
     determineWinner();
@@ -520,7 +865,13 @@ void PokerTable::playHand() {
 
 void PokerTable::showCommunityCards() const {
     for (const auto &card: communityCards_) {
-        std::cout << card.toString() << " ";
+        Console::out() << card.toString() << " ";
+    }
+    Console::out() << '\n';
+}
+
+void PokerTable::notifyStreet() const {
+    if (observer_) {
+        observer_->onStreet(currentStreet(), communityCards_, pot_);
     }
-    std::cout << std::endl;
 }
@@ -5,6 +5,7 @@
 #include <ranges>
 #include <vector>
 
+#include "Console.h"
 #include "Player.h"
 
 PotDisplay::PotDisplay() : mainPot_(0) {
@@ -24,26 +25,26 @@ void PotDisplay::clearAllPots() {
 }
 
 void PotDisplay::display(const std::vector<std::unique_ptr<Player> > &players) const {
-    std::cout << "\n" << std::string(50, '=') << std::endl;
-    std::cout << "                   筹码池信息" << std::endl;
-    std::cout << std::string(50, '=') << std::endl;
+    Console::out() << "\n" << std::string(50, '=') << '\n';
+    Console::out() << "                   筹码池信息" << '\n';
+    Console::out() << std::string(50, '=') << '\n';
 
-    std::cout << "主池: " << mainPot_ << " 筹码" << std::endl;
+    Console::out() << "主池: " << mainPot_ << " 筹码" << '\n';
 
     if (!sidePots_.empty()) {
         for (size_t i = 0; i < sidePots_.size(); i++) {
-            std::cout << "边池 " << (i + 1) << ": " << sidePots_[i].first << " 筹码 - 参与者: ";
+            Console::out() << "边池 " << (i + 1) << ": " << sidePots_[i].first << " 筹码 - 参与者: ";
             for (const size_t playerIndex: sidePots_[i].second) {
                 if (playerIndex < players.size()) {
-                    std::cout << players[playerIndex]->getName() << " ";
+                    Console::out() << players[playerIndex]->getName() << " ";
                 }
             }
-            std::cout << std::endl;
+            Console::out() << '\n';
         }
     }
 
-    std::cout << "总池: " << getTotalPot() << " 筹码" << std::endl;
-    std::cout << std::string(50, '=') << std::endl;
+    Console::out() << "总池: " << getTotalPot() << " 筹码" << '\n';
+    Console::out() << std::string(50, '=') << '\n';
 }
 
 int PotDisplay::getTotalPot() const {
@@ -63,49 +64,49 @@ size_t PotDisplay::getSidePotCount() const {
 }
 
 void PotDisplay::displaySimple() const {
-    std::cout << "💰 当前总池: " << getTotalPot() << " 筹码";
+    Console::out() << "💰 当前总池: " << getTotalPot() << " 筹码";
     if (!sidePots_.empty()) {
-        std::cout << " (包含 " << sidePots_.size() << " 个边池)";
+        Console::out() << " (包含 " << sidePots_.size() << " 个边池)";
     }
-    std::cout << std::endl;
+    Console::out() << '\n';
 }
 
 void PotDisplay::distributeToWinner(const std::string &playerName) {
     const auto totalWon = getTotalPot();
-    std::cout << "\n🎉 " << playerName << " 赢得 ";
+    Console::out() << "\n🎉 " << playerName << " 赢得 ";
 
     if (!sidePots_.empty()) {
-        std::cout << "总池 " << totalWon << " 筹码 (主池: " << mainPot_ << " + ";
+        Console::out() << "总池 " << totalWon << " 筹码 (主池: " << mainPot_ << " + ";
         for (size_t i = 0; i < sidePots_.size(); i++) {
-            std::cout << "边池" << (i + 1) << ": " << sidePots_[i].first;
-            if (i < sidePots_.size() - 1) std::cout << " + ";
+            Console::out() << "边池" << (i + 1) << ": " << sidePots_[i].first;
+            if (i < sidePots_.size() - 1) Console::out() << " + ";
         }
-        std::cout << ")";
+        Console::out() << ")";
     } else {
-        std::cout << totalWon << " 筹码";
+        Console::out() << totalWon << " 筹码";
     }
-    std::cout << std::endl;
+    Console::out() << '\n';
 
     clearAllPots();
 }
 
-void PotDisplay::distributeToWinners(const std::vector<int> &winnerIndices,
-                                     const std::vector<std::string> &winnerNames) {
+void PotDisplay::distributeToWinners(const std::span<const int> winnerIndices,
+                                     const std::span<const std::string_view> winnerNames) {
     const auto totalPot = getTotalPot();
     const auto share = totalPot / winnerIndices.size();
 
-    std::cout << "\n🤝 平局！获胜者: ";
+    Console::out() << "\n🤝 平局！获胜者: ";
     for (size_t i = 0; i < winnerNames.size(); i++) {
-        std::cout << winnerNames[i];
-        if (i < winnerNames.size() - 1) std::cout << ", ";
+        Console::out() << winnerNames[i];
+        if (i < winnerNames.size() - 1) Console::out() << ", ";
     }
 
     if (!sidePots_.empty()) {
-        std::cout << "\n每人获得 " << share << " 筹码 (从总池 " << totalPot << " 筹码中分配)";
+        Console::out() << "\n每人获得 " << share << " 筹码 (从总池 " << totalPot << " 筹码中分配)";
     } else {
-        std::cout << "\n每人获得 " << share << " 筹码";
+        Console::out() << "\n每人获得 " << share << " 筹码";
     }
-    std::cout << std::endl;
+    Console::out() << '\n';
 
     clearAllPots();
 }
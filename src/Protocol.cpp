@@ -0,0 +1,293 @@
+﻿#include "Protocol.h"
+
+#include <algorithm>
+
+namespace {
+    class FrameWriter {
+    public:
+        FrameWriter(std::vector<std::uint8_t> &out, const Protocol::MessageType type)
+            : out_(out), start_(out.size()) {
+            out_.resize(start_ + Protocol::HEADER_SIZE);
+            out_[start_ + 2] = static_cast<std::uint8_t>(type);
+        }
+
+        ~FrameWriter() {
+            const auto length = out_.size() - start_ - Protocol::HEADER_SIZE;
+            out_[start_] = static_cast<std::uint8_t>(length & 0xFF);
+            out_[start_ + 1] = static_cast<std::uint8_t>(length >> 8);
+        }
+
+        FrameWriter(const FrameWriter &) = delete;
+
+        FrameWriter &operator=(const FrameWriter &) = delete;
+
+        void u8(const std::uint8_t value) const { out_.push_back(value); }
+
+        void u32(const std::uint32_t value) const {
+            for (auto shift = 0; shift < 32; shift += 8) {
+                out_.push_back(static_cast<std::uint8_t>(value >> shift));
+            }
+        }
+
+        void i32(const std::int32_t value) const { u32(static_cast<std::uint32_t>(value)); }
+
+        void text(const std::string &value) const {
+            const auto length = std::min(value.size(), Protocol::MAX_NAME);
+            u8(static_cast<std::uint8_t>(length));
+            out_.insert(out_.end(), value.begin(), value.begin() + static_cast<std::ptrdiff_t>(length));
+        }
+
+    private:
+        std::vector<std::uint8_t> &out_;
+        std::size_t start_;
+    };
+
+    class PayloadReader {
+    public:
+        explicit PayloadReader(const std::span<const std::uint8_t> payload) : payload_(payload), pos_(0), ok_(true) {
+        }
+
+        std::uint8_t u8() {
+            if (!require(1)) return 0;
+            return payload_[pos_++];
+        }
+
+        std::uint32_t u32() {
+            if (!require(4)) return 0;
+            std::uint32_t value = 0;
+            for (auto shift = 0; shift < 32; shift += 8) {
+                value |= static_cast<std::uint32_t>(payload_[pos_++]) << shift;
+            }
+            return value;
+        }
+
+        std::int32_t i32() { return static_cast<std::int32_t>(u32()); }
+
+        std::string text() {
+            const auto length = u8();
+            if (length > Protocol::MAX_NAME || !require(length)) {
+                ok_ = false;
+                return {};
+            }
+            std::string value(reinterpret_cast<const char *>(payload_.data() + pos_), length);
+            pos_ += length;
+            return value;
+        }
+
+        Player::Action action() {
+            const auto value = u8();
+            if (value > static_cast<std::uint8_t>(Player::Action::RAISE)) ok_ = false;
+            return static_cast<Player::Action>(value);
+        }
+
+        bool complete() const { return ok_ && pos_ == payload_.size(); }
+
+    private:
+        std::span<const std::uint8_t> payload_;
+        std::size_t pos_;
+        bool ok_;
+
+        bool require(const std::size_t bytes) {
+            if (pos_ + bytes > payload_.size()) ok_ = false;
+            return ok_;
+        }
+    };
+}
+
+std::optional<Protocol::Frame> Protocol::nextFrame(const std::span<const std::uint8_t> buffer) {
+    if (buffer.size() < HEADER_SIZE) {
+        return std::nullopt;
+    }
+    const auto length = static_cast<std::size_t>(buffer[0]) | static_cast<std::size_t>(buffer[1]) << 8;
+    if (buffer.size() < HEADER_SIZE + length) {
+        return std::nullopt;
+    }
+    return Frame{static_cast<MessageType>(buffer[2]), buffer.subspan(HEADER_SIZE, length), HEADER_SIZE + length};
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const Join &message) {
+    const FrameWriter writer(out, MessageType::JOIN);
+    writer.u32(message.tableKey);
+    writer.text(message.name);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const Action &message) {
+    const FrameWriter writer(out, MessageType::ACTION);
+    writer.u32(message.sequence);
+    writer.u8(static_cast<std::uint8_t>(message.action));
+    writer.i32(message.raiseAmount);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const Spectate &message) {
+    const FrameWriter writer(out, MessageType::SPECTATE);
+    writer.u32(message.tableKey);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const Joined &message) {
+    const FrameWriter writer(out, MessageType::JOINED);
+    writer.u32(message.tableKey);
+    writer.u8(message.seat);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const DecisionRequest &message) {
+    const FrameWriter writer(out, MessageType::DECISION_REQUEST);
+    writer.u32(message.sequence);
+    writer.i32(message.currentBet);
+    writer.i32(message.chipsCommitted);
+    writer.i32(message.pot);
+    writer.i32(message.chipCount);
+    writer.u32(message.timeLimitMs);
+    writer.u32(message.timeBankMs);
+    writer.u8(message.street);
+    writer.u8(message.opponents);
+    writer.u8(message.holeCount);
+    for (std::size_t i = 0; i < message.holeCount; i++) writer.u8(message.holeCards[i]);
+    writer.u8(message.boardCount);
+    for (std::size_t i = 0; i < message.boardCount; i++) writer.u8(message.board[i]);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const ActionNotice &message) {
+    const FrameWriter writer(out, MessageType::ACTION_NOTICE);
+    writer.text(message.playerName);
+    writer.u8(static_cast<std::uint8_t>(message.action));
+    writer.i32(message.amount);
+    writer.u8(message.street);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const ChipUpdate &message) {
+    const FrameWriter writer(out, MessageType::CHIP_UPDATE);
+    writer.i32(message.chipCount);
+    writer.u32(message.handsPlayed);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const TableClosed &message) {
+    const FrameWriter writer(out, MessageType::TABLE_CLOSED);
+    writer.i32(message.chipCount);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const HandStarted &message) {
+    const FrameWriter writer(out, MessageType::HAND_STARTED);
+    writer.u32(message.handNumber);
+    writer.u8(message.button);
+    writer.i32(message.pot);
+    const auto seats = std::min(message.seats.size(), MAX_SEATS);
+    writer.u8(static_cast<std::uint8_t>(seats));
+    for (std::size_t i = 0; i < seats; i++) {
+        writer.text(message.seats[i].name);
+        writer.i32(message.seats[i].chipCount);
+    }
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const StreetDealt &message) {
+    const FrameWriter writer(out, MessageType::STREET_DEALT);
+    writer.u8(message.street);
+    writer.i32(message.pot);
+    writer.u8(message.boardCount);
+    for (std::size_t i = 0; i < message.boardCount; i++) writer.u8(message.board[i]);
+}
+
+void Protocol::encode(std::vector<std::uint8_t> &out, const Showdown &message) {
+    const FrameWriter writer(out, MessageType::SHOWDOWN);
+    writer.text(message.playerName);
+    writer.u8(message.holeCount);
+    for (std::size_t i = 0; i < message.holeCount; i++) writer.u8(message.holeCards[i]);
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, Join &message) {
+    PayloadReader reader(payload);
+    message.tableKey = reader.u32();
+    message.name = reader.text();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, Action &message) {
+    PayloadReader reader(payload);
+    message.sequence = reader.u32();
+    message.action = reader.action();
+    message.raiseAmount = reader.i32();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, Spectate &message) {
+    PayloadReader reader(payload);
+    message.tableKey = reader.u32();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, Joined &message) {
+    PayloadReader reader(payload);
+    message.tableKey = reader.u32();
+    message.seat = reader.u8();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, DecisionRequest &message) {
+    PayloadReader reader(payload);
+    message.sequence = reader.u32();
+    message.currentBet = reader.i32();
+    message.chipsCommitted = reader.i32();
+    message.pot = reader.i32();
+    message.chipCount = reader.i32();
+    message.timeLimitMs = reader.u32();
+    message.timeBankMs = reader.u32();
+    message.street = reader.u8();
+    message.opponents = reader.u8();
+    message.holeCount = std::min<std::uint8_t>(reader.u8(), message.holeCards.size());
+    for (std::size_t i = 0; i < message.holeCount; i++) message.holeCards[i] = reader.u8();
+    message.boardCount = std::min<std::uint8_t>(reader.u8(), message.board.size());
+    for (std::size_t i = 0; i < message.boardCount; i++) message.board[i] = reader.u8();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, ActionNotice &message) {
+    PayloadReader reader(payload);
+    message.playerName = reader.text();
+    message.action = reader.action();
+    message.amount = reader.i32();
+    message.street = reader.u8();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, ChipUpdate &message) {
+    PayloadReader reader(payload);
+    message.chipCount = reader.i32();
+    message.handsPlayed = reader.u32();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, TableClosed &message) {
+    PayloadReader reader(payload);
+    message.chipCount = reader.i32();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, HandStarted &message) {
+    PayloadReader reader(payload);
+    message.handNumber = reader.u32();
+    message.button = reader.u8();
+    message.pot = reader.i32();
+    const auto seats = std::min<std::size_t>(reader.u8(), MAX_SEATS);
+    message.seats.clear();
+    for (std::size_t i = 0; i < seats; i++) {
+        auto name = reader.text();
+        message.seats.push_back({std::move(name), reader.i32()});
+    }
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, StreetDealt &message) {
+    PayloadReader reader(payload);
+    message.street = reader.u8();
+    message.pot = reader.i32();
+    message.boardCount = std::min<std::uint8_t>(reader.u8(), message.board.size());
+    for (std::size_t i = 0; i < message.boardCount; i++) message.board[i] = reader.u8();
+    return reader.complete();
+}
+
+bool Protocol::decode(const std::span<const std::uint8_t> payload, Showdown &message) {
+    PayloadReader reader(payload);
+    message.playerName = reader.text();
+    message.holeCount = std::min<std::uint8_t>(reader.u8(), message.holeCards.size());
+    for (std::size_t i = 0; i < message.holeCount; i++) message.holeCards[i] = reader.u8();
+    return reader.complete();
+}
@@ -0,0 +1,47 @@
+﻿#include "RemotePlayer.h"
+
+RemotePlayer::RemotePlayer(const std::string &name, const int initialChips)
+    : Player(name, initialChips) {
+}
+
+Player::Action RemotePlayer::makeDecision(const int currentBet, const int chipsCommitted,
+                                          const std::vector<Card> &) {
+    return currentBet > chipsCommitted ? Action::FOLD : Action::CHECK;
+}
+
+int RemotePlayer::getRaiseAmount(const int currentBet, int) {
+    return currentBet;
+}
+
+Task<Player::Decision> RemotePlayer::decide(const DecisionView &view) {
+    auto awaiter = slot_.wait(view.scheduler);
+    if (onDecisionRequest_) {
+        onDecisionRequest_(*this, view);
+    }
+    co_return co_await awaiter;
+}
+
+bool RemotePlayer::isHuman() const { return true; }
+
+bool RemotePlayer::deliver(const Decision &decision) {
+    return slot_.fulfill(decision);
+}
+
+bool RemotePlayer::isAwaitingDecision() const {
+    return slot_.isWaiting();
+}
+
+void RemotePlayer::setDecisionRequestHandler(DecisionRequestHandler handler) {
+    onDecisionRequest_ = std::move(handler);
+}
+
+void RemotePlayer::observeAction(const std::string &playerName, const Action action, const int amount, int,
+                                 const int street) {
+    if (onAction_) {
+        onAction_(playerName, action, amount, street);
+    }
+}
+
+void RemotePlayer::setActionObserver(ActionObserver observer) {
+    onAction_ = std::move(observer);
+}
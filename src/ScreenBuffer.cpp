@@ -0,0 +1,293 @@
+﻿#include "ScreenBuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr std::array<std::string_view, 7> STYLE_CODES{
+        "\x1b[0m", "\x1b[0;1m", "\x1b[0;2m", "\x1b[0;31m", "\x1b[0;32m", "\x1b[0;33m", "\x1b[0;36m"
+    };
+
+    char32_t decode(const std::string_view text, std::size_t &pos) {
+        const auto lead = static_cast<unsigned char>(text[pos++]);
+        if (lead < 0x80) {
+            return lead;
+        }
+        const auto length = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+        if (length == 0 || pos + length > text.size()) {
+            return U'�';
+        }
+        char32_t glyph = lead & (0x3F >> length);
+        for (auto i = 0; i < length; i++) {
+            const auto next = static_cast<unsigned char>(text[pos]);
+            if ((next & 0xC0) != 0x80) {
+                return U'�';
+            }
+            glyph = glyph << 6 | (next & 0x3F);
+            pos++;
+        }
+        return glyph;
+    }
+
+    void encode(std::string &out, const char32_t glyph) {
+        if (glyph < 0x80) {
+            out += static_cast<char>(glyph);
+        } else if (glyph < 0x800) {
+            out += static_cast<char>(0xC0 | glyph >> 6);
+            out += static_cast<char>(0x80 | (glyph & 0x3F));
+        } else if (glyph < 0x10000) {
+            out += static_cast<char>(0xE0 | glyph >> 12);
+            out += static_cast<char>(0x80 | (glyph >> 6 & 0x3F));
+            out += static_cast<char>(0x80 | (glyph & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | glyph >> 18);
+            out += static_cast<char>(0x80 | (glyph >> 12 & 0x3F));
+            out += static_cast<char>(0x80 | (glyph >> 6 & 0x3F));
+            out += static_cast<char>(0x80 | (glyph & 0x3F));
+        }
+    }
+
+    void appendNumber(std::string &out, const int value) {
+        char digits[12];
+        const auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+        out.append(digits, end);
+    }
+
+    void moveCursor(std::string &out, const int row, const int column) {
+        out += "\x1b[";
+        appendNumber(out, row + 1);
+        out += ';';
+        appendNumber(out, column + 1);
+        out += 'H';
+    }
+
+    std::size_t writeAll(const std::string_view bytes) {
+        std::cout.flush();
+#ifdef _WIN32
+        const auto written = std::fwrite(bytes.data(), 1, bytes.size(), stdout);
+        std::fflush(stdout);
+        return written;
+#else
+        std::size_t written = 0;
+        while (written < bytes.size()) {
+            const auto result = ::write(STDOUT_FILENO, bytes.data() + written, bytes.size() - written);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                break;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        return written;
+#endif
+    }
+}
+
+ScreenBuffer::ScreenBuffer(const int rows, const int columns)
+    : rows_(std::max(1, rows)), columns_(std::max(1, columns)),
+      front_(static_cast<std::size_t>(rows_) * columns_, Cell{STALE, Style::NORMAL}),
+      back_(front_.size(), Cell{U' ', Style::NORMAL}), cursorRow_(rows_), cursorColumn_(0), cursorVisible_(false),
+      cursorShown_(false), cursorMoved_(false), started_(false), framesPresented_(0), cellsWritten_(0),
+      bytesWritten_(0) {
+    frame_.reserve(back_.size() * 4);
+}
+
+ScreenBuffer::~ScreenBuffer() {
+    if (started_) {
+        std::string restore(STYLE_CODES[0]);
+        moveCursor(restore, rows_, 0);
+        restore += "\x1b[?25h";
+        writeAll(restore);
+    }
+}
+
+int ScreenBuffer::getRows() const { return rows_; }
+
+int ScreenBuffer::getColumns() const { return columns_; }
+
+void ScreenBuffer::clear() {
+    std::ranges::fill(back_, Cell{U' ', Style::NORMAL});
+}
+
+int ScreenBuffer::draw(const int row, int column, const std::string_view text, const Style style,
+                       const int maxWidth) {
+    const auto start = column;
+    const auto end = column + std::min(maxWidth, columns_ - column);
+    for (std::size_t pos = 0; pos < text.size();) {
+        const auto glyph = decode(text, pos);
+        const auto width = glyphWidth(glyph);
+        if (column + width > end) {
+            break;
+        }
+        put(row, column, glyph, style);
+        column += width;
+    }
+    return column - start;
+}
+
+void ScreenBuffer::fill(const int row, const int column, const int width, const char32_t glyph,
+                        const Style style) {
+    const auto step = std::max(1, glyphWidth(glyph));
+    for (auto c = column; c + step <= column + width; c += step) {
+        put(row, c, glyph, style);
+    }
+}
+
+void ScreenBuffer::box(const int row, const int column, const int height, const int width,
+                       const std::string_view title) {
+    if (height < 2 || width < 2) {
+        return;
+    }
+    const auto bottom = row + height - 1;
+    const auto right = column + width - 1;
+    fill(row, column + 1, width - 2, U'─', Style::DIM);
+    fill(bottom, column + 1, width - 2, U'─', Style::DIM);
+    for (auto r = row + 1; r < bottom; r++) {
+        put(r, column, U'│', Style::DIM);
+        put(r, right, U'│', Style::DIM);
+    }
+    put(row, column, U'┌', Style::DIM);
+    put(row, right, U'┐', Style::DIM);
+    put(bottom, column, U'└', Style::DIM);
+    put(bottom, right, U'┘', Style::DIM);
+    if (!title.empty() && width > 4) {
+        const auto used = draw(row, column + 2, title, Style::BOLD, width - 4);
+        put(row, column + 1, U' ', Style::BOLD);
+        put(row, column + 2 + used, U' ', Style::BOLD);
+    }
+}
+
+void ScreenBuffer::setCursor(const int row, const int column, const bool visible) {
+    cursorMoved_ = cursorMoved_ || row != cursorRow_ || column != cursorColumn_;
+    cursorRow_ = row;
+    cursorColumn_ = column;
+    cursorVisible_ = visible;
+}
+
+std::string_view ScreenBuffer::compose() {
+    frame_.clear();
+    if (!started_) {
+        frame_ += "\x1b[?25l\x1b[2J";
+        started_ = true;
+        cursorShown_ = false;
+    }
+
+    auto cursorRow = -1;
+    auto cursorColumn = -1;
+    auto styled = false;
+    auto currentStyle = Style::NORMAL;
+    for (auto row = 0; row < rows_; row++) {
+        for (auto column = 0; column < columns_; column++) {
+            const auto index = static_cast<std::size_t>(row) * columns_ + column;
+            const auto &cell = back_[index];
+            if (cell == front_[index]) {
+                continue;
+            }
+            front_[index] = cell;
+            if (cell.glyph == CONTINUATION) {
+                continue;
+            }
+            if (row != cursorRow || column != cursorColumn) {
+                moveCursor(frame_, row, column);
+                cursorRow = row;
+            }
+            if (!styled || cell.style != currentStyle) {
+                frame_ += STYLE_CODES[static_cast<std::size_t>(cell.style)];
+                currentStyle = cell.style;
+                styled = true;
+            }
+            encode(frame_, cell.glyph);
+            cursorColumn = column + glyphWidth(cell.glyph);
+            cellsWritten_++;
+        }
+    }
+
+    if (styled) {
+        frame_ += STYLE_CODES[0];
+    }
+    if (styled || cursorMoved_) {
+        moveCursor(frame_, cursorRow_, cursorColumn_);
+        cursorMoved_ = false;
+    }
+    if (cursorVisible_ != cursorShown_) {
+        frame_ += cursorVisible_ ? "\x1b[?25h" : "\x1b[?25l";
+        cursorShown_ = cursorVisible_;
+    }
+    return frame_;
+}
+
+void ScreenBuffer::present() {
+    if (const auto frame = compose(); !frame.empty()) {
+        const auto written = writeAll(frame);
+        bytesWritten_ += written;
+        if (written < frame.size()) {
+            invalidate();
+        }
+    }
+    framesPresented_++;
+}
+
+void ScreenBuffer::invalidate() {
+    std::ranges::fill(front_, Cell{STALE, Style::NORMAL});
+    started_ = false;
+}
+
+std::uint64_t ScreenBuffer::getFramesPresented() const { return framesPresented_; }
+
+std::uint64_t ScreenBuffer::getCellsWritten() const { return cellsWritten_; }
+
+std::uint64_t ScreenBuffer::getBytesWritten() const { return bytesWritten_; }
+
+int ScreenBuffer::glyphWidth(const char32_t glyph) {
+    if (glyph < 0x20 || (glyph >= 0x7F && glyph < 0xA0) || (glyph >= 0x0300 && glyph < 0x0370) ||
+        (glyph >= 0x200B && glyph < 0x2010) || (glyph >= 0xFE00 && glyph < 0xFE10)) {
+        return 0;
+    }
+    if ((glyph >= 0x1100 && glyph < 0x1160) || (glyph >= 0x2E80 && glyph < 0xA4D0) ||
+        (glyph >= 0xAC00 && glyph < 0xD7A4) || (glyph >= 0xF900 && glyph < 0xFB00) ||
+        (glyph >= 0xFE30 && glyph < 0xFE50) || (glyph >= 0xFF00 && glyph < 0xFF61) ||
+        (glyph >= 0xFFE0 && glyph < 0xFFE7) || (glyph >= 0x1F300 && glyph < 0x1FB00) ||
+        (glyph >= 0x20000 && glyph < 0x3FFFE)) {
+        return 2;
+    }
+    return 1;
+}
+
+ScreenBuffer::Cell &ScreenBuffer::at(const int row, const int column) {
+    return back_[static_cast<std::size_t>(row) * columns_ + column];
+}
+
+void ScreenBuffer::put(const int row, const int column, char32_t glyph, const Style style) {
+    auto width = glyphWidth(glyph);
+    if (width == 0 || row < 0 || row >= rows_ || column < 0 || column >= columns_) {
+        return;
+    }
+    if (width == 2 && column + 1 >= columns_) {
+        glyph = U' ';
+        width = 1;
+    }
+
+    for (auto c = column; c < column + width; c++) {
+        const auto &cell = at(row, c);
+        if (cell.glyph == CONTINUATION && c > 0) {
+            at(row, c - 1).glyph = U' ';
+        } else if (glyphWidth(cell.glyph) == 2 && c + 1 < columns_) {
+            at(row, c + 1).glyph = U' ';
+        }
+    }
+    at(row, column) = {glyph, style};
+    if (width == 2) {
+        at(row, column + 1) = {CONTINUATION, style};
+    }
+}
@@ -0,0 +1,199 @@
+﻿#include "ShardedSimulation.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ComputerPlayer.h"
+#include "Console.h"
+#include "PokerTable.h"
+
+namespace {
+    constexpr std::uint64_t PROGRESS_HANDS = 64;
+    constexpr auto PROGRESS_INTERVAL = std::chrono::milliseconds(200);
+
+    [[noreturn]] void throwSystemError(const std::string &what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    std::uint64_t splitMix(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    void pinToCore(const int worker) {
+        const auto cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(worker % cores, &set);
+        ::sched_setaffinity(0, sizeof(set), &set);
+    }
+}
+
+ShardedSimulation::ShardedSimulation(Config config)
+    : config_(config), slots_(nullptr), length_(0) {
+    config_.processes = std::max(1, config_.processes);
+    config_.seats = std::clamp(config_.seats, 2, MAX_SEATS);
+
+    length_ = sizeof(WorkerSlot) * config_.processes;
+    auto *memory = ::mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throwSystemError("mmap shared results");
+    }
+    slots_ = new(memory) WorkerSlot[config_.processes];
+}
+
+ShardedSimulation::~ShardedSimulation() {
+    ::munmap(slots_, length_);
+}
+
+ShardedSimulation::Results ShardedSimulation::run(const ProgressHandler &onProgress) {
+    const auto started = std::chrono::steady_clock::now();
+    std::cout.flush();
+    std::cerr.flush();
+
+    std::vector<pid_t> children;
+    for (auto worker = 0; worker < config_.processes; worker++) {
+        const auto pid = ::fork();
+        if (pid < 0) {
+            const auto error = errno;
+            for (const auto child: children) {
+                ::kill(child, SIGKILL);
+                ::waitpid(child, nullptr, 0);
+            }
+            errno = error;
+            throwSystemError("fork");
+        }
+        if (pid == 0) {
+            auto status = 0;
+            try {
+                runWorker(worker);
+            } catch (...) {
+                status = 1;
+            }
+            ::_exit(status);
+        }
+        children.push_back(pid);
+    }
+
+    auto failed = false;
+    auto running = children.size();
+    while (running > 0) {
+        for (auto &child: children) {
+            auto status = 0;
+            if (child > 0 && ::waitpid(child, &status, WNOHANG) == child) {
+                failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+                child = 0;
+                running--;
+            }
+        }
+        if (onProgress) {
+            onProgress(getHandsPlayed(), config_.hands);
+        }
+        if (running > 0) {
+            std::this_thread::sleep_for(PROGRESS_INTERVAL);
+        }
+    }
+    if (failed) {
+        throw std::runtime_error("simulation worker exited abnormally");
+    }
+
+    auto results = collect();
+    results.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return results;
+}
+
+std::uint64_t ShardedSimulation::getHandsPlayed() const {
+    std::uint64_t hands = 0;
+    for (auto worker = 0; worker < config_.processes; worker++) {
+        hands += slots_[worker].hands.load(std::memory_order_relaxed);
+    }
+    return hands;
+}
+
+std::uint64_t ShardedSimulation::digest(const Results &results) {
+    auto hash = splitMix(results.hands);
+    for (const auto &[wins, chipDelta]: results.seats) {
+        hash = splitMix(hash ^ wins);
+        hash = splitMix(hash ^ static_cast<std::uint64_t>(chipDelta));
+    }
+    return hash;
+}
+
+void ShardedSimulation::runWorker(const int worker) {
+    Console::setQuiet(true);
+    if (config_.pinCores) {
+        pinToCore(worker);
+    }
+
+    auto &slot = slots_[worker];
+    std::array<std::uint64_t, MAX_SEATS> wins{};
+    std::array<std::int64_t, MAX_SEATS> chipDeltas{};
+    const auto blocks = (config_.hands + BLOCK_HANDS - 1) / BLOCK_HANDS;
+    for (std::uint64_t block = worker; block < blocks; block += config_.processes) {
+        const auto blockSeed = splitMix(config_.seed ^ splitMix(block));
+        PokerTable table;
+        table.setSeed(static_cast<std::uint32_t>(blockSeed));
+        table.setHistoryRecorded(false);
+        for (auto seat = 0; seat < config_.seats; seat++) {
+            auto player = std::make_unique<ComputerPlayer>("Seat " + std::to_string(seat + 1), config_.stack);
+            player->setSeed(static_cast<std::uint32_t>(splitMix(blockSeed + seat + 1)));
+            table.addPlayer(std::move(player));
+        }
+        table.setBlinds(config_.smallBlind, config_.bigBlind);
+        table.setSettlementHandler([&wins, &chipDeltas](const std::span<const PokerTable::Settlement> settlements) {
+            for (std::size_t seat = 0; seat < settlements.size(); seat++) {
+                chipDeltas[seat] += settlements[seat].delta;
+                if (settlements[seat].delta > 0) {
+                    wins[seat]++;
+                }
+            }
+        });
+
+        const auto hands = std::min(BLOCK_HANDS, config_.hands - block * BLOCK_HANDS);
+        for (std::uint64_t hand = 1; hand <= hands; hand++) {
+            for (const auto &player: table.getPlayers()) {
+                if (player->getChipCount() == 0) {
+                    player->addChips(config_.stack);
+                }
+            }
+            table.playHand();
+            if (hand % PROGRESS_HANDS == 0) {
+                slot.hands.fetch_add(PROGRESS_HANDS, std::memory_order_relaxed);
+            }
+        }
+        slot.hands.fetch_add(hands % PROGRESS_HANDS, std::memory_order_relaxed);
+
+        for (auto seat = 0; seat < config_.seats; seat++) {
+            slot.wins[seat].fetch_add(std::exchange(wins[seat], 0), std::memory_order_relaxed);
+            slot.chipDeltas[seat].fetch_add(std::exchange(chipDeltas[seat], 0), std::memory_order_relaxed);
+        }
+    }
+}
+
+ShardedSimulation::Results ShardedSimulation::collect() const {
+    Results results{getHandsPlayed(), std::vector<SeatResult>(config_.seats), 0.0};
+    for (auto worker = 0; worker < config_.processes; worker++) {
+        for (auto seat = 0; seat < config_.seats; seat++) {
+            results.seats[seat].wins += slots_[worker].wins[seat].load(std::memory_order_relaxed);
+            results.seats[seat].chipDelta += slots_[worker].chipDeltas[seat].load(std::memory_order_relaxed);
+        }
+    }
+    return results;
+}
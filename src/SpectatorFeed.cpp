@@ -0,0 +1,95 @@
+﻿#include "SpectatorFeed.h"
+
+SpectatorFeed::SpectatorFeed() : keyframes_{}, head_(0), lastKeyframe_(NO_KEYFRAME) {
+}
+
+void SpectatorFeed::publish(Buffer buffer, const bool keyframe) {
+    ring_[head_ % HISTORY] = std::move(buffer);
+    keyframes_[head_ % HISTORY] = keyframe;
+    if (keyframe) {
+        lastKeyframe_ = head_;
+    }
+    head_++;
+}
+
+SpectatorFeed::Cursor SpectatorFeed::subscribe() const {
+    Cursor cursor;
+    if (lastKeyframe_ != NO_KEYFRAME && retained(lastKeyframe_)) {
+        cursor.sequence = lastKeyframe_;
+    } else {
+        cursor.sequence = head_;
+        cursor.resync = true;
+    }
+    return cursor;
+}
+
+std::size_t SpectatorFeed::gather(Cursor &cursor, const std::span<std::span<const std::uint8_t> > out) const {
+    catchUp(cursor);
+    if (out.empty()) {
+        return 0;
+    }
+    if (cursor.partial) {
+        out[0] = std::span(*cursor.partial).subspan(cursor.offset);
+        return 1;
+    }
+
+    std::size_t count = 0;
+    for (auto sequence = cursor.sequence; sequence < head_ && count < out.size(); sequence++) {
+        const auto &buffer = *ring_[sequence % HISTORY];
+        out[count++] = std::span(buffer).subspan(sequence == cursor.sequence ? cursor.offset : 0);
+    }
+    return count;
+}
+
+void SpectatorFeed::consume(Cursor &cursor, std::size_t bytes) const {
+    while (bytes > 0) {
+        const auto &buffer = cursor.partial ? cursor.partial : ring_[cursor.sequence % HISTORY];
+        const auto remaining = buffer->size() - cursor.offset;
+        if (bytes < remaining) {
+            cursor.offset += bytes;
+            if (!cursor.partial) {
+                cursor.partial = buffer;
+            }
+            return;
+        }
+        bytes -= remaining;
+        cursor.partial.reset();
+        cursor.offset = 0;
+        cursor.sequence++;
+    }
+}
+
+bool SpectatorFeed::hasPending(const Cursor &cursor) const {
+    return cursor.partial || cursor.sequence < head_;
+}
+
+std::uint64_t SpectatorFeed::getPublished() const { return head_; }
+
+bool SpectatorFeed::retained(const std::uint64_t sequence) const {
+    return sequence < head_ && head_ - sequence <= HISTORY;
+}
+
+void SpectatorFeed::catchUp(Cursor &cursor) const {
+    if (cursor.partial) {
+        return;
+    }
+    if (cursor.sequence < head_ && !retained(cursor.sequence)) {
+        if (lastKeyframe_ != NO_KEYFRAME && lastKeyframe_ > cursor.sequence && retained(lastKeyframe_)) {
+            cursor.dropped += lastKeyframe_ - cursor.sequence;
+            cursor.sequence = lastKeyframe_;
+        } else {
+            cursor.dropped += head_ - cursor.sequence;
+            cursor.sequence = head_;
+            cursor.resync = true;
+        }
+        cursor.offset = 0;
+    }
+    while (cursor.resync && cursor.sequence < head_) {
+        if (keyframes_[cursor.sequence % HISTORY]) {
+            cursor.resync = false;
+        } else {
+            cursor.sequence++;
+            cursor.dropped++;
+        }
+    }
+}
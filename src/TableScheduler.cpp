@@ -0,0 +1,80 @@
+﻿#include "TableScheduler.h"
+
+#include <algorithm>
+
+namespace {
+    thread_local TableScheduler *runningScheduler = nullptr;
+}
+
+TableScheduler::TableScheduler() = default;
+
+void TableScheduler::spawn(Task<> task) {
+    const auto handle = task.handle();
+    tasks_.push_back(std::move(task));
+    post(handle);
+}
+
+void TableScheduler::post(const std::coroutine_handle<> handle) {
+    {
+        std::lock_guard lock(mutex_);
+        incoming_.push_back(handle);
+    }
+    wakeup_.notify_one();
+    if (notifier_) {
+        notifier_();
+    }
+}
+
+void TableScheduler::setNotifier(std::function<void()> notifier) {
+    notifier_ = std::move(notifier);
+}
+
+bool TableScheduler::runOnce(const bool block) {
+    {
+        std::unique_lock lock(mutex_);
+        if (block) {
+            wakeup_.wait(lock, [this] { return !incoming_.empty(); });
+        }
+        ready_.swap(incoming_);
+    }
+    if (ready_.empty()) {
+        return false;
+    }
+
+    auto *const previous = runningScheduler;
+    runningScheduler = this;
+    for (const auto handle: ready_) {
+        handle.resume();
+    }
+    runningScheduler = previous;
+    ready_.clear();
+
+    reapFinished();
+    return true;
+}
+
+void TableScheduler::run() {
+    while (!tasks_.empty()) {
+        runOnce(true);
+    }
+}
+
+std::size_t TableScheduler::getActiveTasks() const { return tasks_.size(); }
+
+TableScheduler *TableScheduler::current() { return runningScheduler; }
+
+void TableScheduler::reapFinished() {
+    const auto finished = std::ranges::partition(tasks_, [](const Task<> &task) { return !task.done(); });
+    std::exception_ptr failure;
+    for (auto it = finished.begin(); it != finished.end(); ++it) {
+        try {
+            it->result();
+        } catch (...) {
+            if (!failure) failure = std::current_exception();
+        }
+    }
+    tasks_.erase(finished.begin(), finished.end());
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
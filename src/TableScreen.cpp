@@ -0,0 +1,176 @@
+﻿#include "TableScreen.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr auto NAME_WIDTH = 20;
+    constexpr auto CHIPS_COLUMN = 26;
+    constexpr auto ACTION_COLUMN = 36;
+
+    std::string describe(const Player::Action action, const int amount) {
+        switch (action) {
+            case Player::Action::FOLD: return "弃牌";
+            case Player::Action::CHECK: return "过牌";
+            case Player::Action::CALL: return "跟注 " + std::to_string(amount);
+            case Player::Action::RAISE: return "加注到 " + std::to_string(amount);
+        }
+        return {};
+    }
+
+    std::string cardsText(const std::vector<Card> &cards) {
+        std::string text;
+        for (const auto &card: cards) {
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += card.toString();
+        }
+        return text;
+    }
+}
+
+TableScreen::TableScreen(const int rows, const int columns)
+    : screen_(rows, columns), previous_(std::cout.rdbuf(this)), players_(nullptr), button_(0), handNumber_(0),
+      pot_(0), awaitingInput_(false), rendering_(false) {
+}
+
+TableScreen::~TableScreen() {
+    if (!line_.empty()) {
+        append('\n');
+    }
+    render();
+    std::cout.rdbuf(previous_);
+}
+
+void TableScreen::onHandStarted(const std::vector<std::unique_ptr<Player> > &players, const std::size_t button,
+                                const int pot) {
+    players_ = &players;
+    button_ = button;
+    handNumber_++;
+    pot_ = pot;
+    board_.clear();
+    lastActions_.clear();
+    render();
+}
+
+void TableScreen::onAction(const std::string &playerName, const Player::Action action, const int amount,
+                           const int pot, int) {
+    lastActions_[playerName] = describe(action, amount);
+    pot_ = pot;
+    render();
+}
+
+void TableScreen::onStreet(int, const std::vector<Card> &communityCards, const int pot) {
+    board_ = cardsText(communityCards);
+    pot_ = pot;
+    lastActions_.clear();
+    render();
+}
+
+void TableScreen::onShowdown(const std::string &playerName, const std::vector<Card> &holeCards) {
+    lastActions_[playerName] = "亮牌 " + cardsText(holeCards);
+    render();
+}
+
+bool TableScreen::isTerminal() {
+#ifdef _WIN32
+    return _isatty(_fileno(stdout)) != 0;
+#else
+    return ::isatty(STDOUT_FILENO) != 0;
+#endif
+}
+
+TableScreen::int_type TableScreen::overflow(const int_type ch) {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        append(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize TableScreen::xsputn(const char *text, const std::streamsize count) {
+    for (std::streamsize i = 0; i < count; i++) {
+        append(text[i]);
+    }
+    return count;
+}
+
+int TableScreen::sync() {
+    render();
+    return 0;
+}
+
+void TableScreen::append(const char ch) {
+    if (awaitingInput_) {
+        awaitingInput_ = false;
+        screen_.invalidate();
+        log_.push_back(std::move(line_));
+        line_.clear();
+    }
+    if (ch != '\n') {
+        line_ += ch;
+        return;
+    }
+    log_.push_back(std::move(line_));
+    line_.clear();
+    if (log_.size() > LOG_LINES) {
+        log_.pop_front();
+    }
+}
+
+void TableScreen::render() {
+    if (rendering_) {
+        return;
+    }
+    rendering_ = true;
+    screen_.clear();
+    const auto rows = screen_.getRows();
+    const auto columns = screen_.getColumns();
+    const auto seats = players_ ? static_cast<int>(players_->size()) : 0;
+
+    const auto tableHeight = std::min(rows - 3, seats + 3);
+    screen_.box(0, 0, tableHeight, columns, handNumber_ > 0 ? "第 " + std::to_string(handNumber_) + " 手" : "德州扑克");
+    screen_.draw(1, 2, "底池 " + std::to_string(pot_) + "   公共牌 " + (board_.empty() ? "-" : board_),
+                 ScreenBuffer::Style::CYAN, columns - 4);
+    for (auto seat = 0; seat < seats && seat + 2 < tableHeight - 1; seat++) {
+        const auto &player = *(*players_)[seat];
+        const auto style = player.isFolded() ? ScreenBuffer::Style::DIM
+                           : player.isHuman() ? ScreenBuffer::Style::BOLD
+                           : ScreenBuffer::Style::NORMAL;
+        const auto row = 2 + seat;
+        if (static_cast<std::size_t>(seat) == button_) {
+            screen_.draw(row, 2, "*", ScreenBuffer::Style::YELLOW);
+        }
+        screen_.draw(row, 4, player.getName(), style, NAME_WIDTH);
+        screen_.draw(row, CHIPS_COLUMN, std::to_string(player.getChipCount()), style);
+        if (const auto action = lastActions_.find(player.getName()); action != lastActions_.end()) {
+            screen_.draw(row, ACTION_COLUMN, action->second, style, columns - ACTION_COLUMN - 2);
+        }
+    }
+
+    const auto logHeight = rows - tableHeight;
+    screen_.box(tableHeight, 0, logHeight, columns, "记录");
+    const auto visible = static_cast<std::size_t>(logHeight - 2);
+    const auto partial = line_.empty() ? 0u : 1u;
+    const auto shown = std::min(log_.size(), visible - partial);
+    auto row = tableHeight + 1;
+    for (auto line = log_.end() - static_cast<std::ptrdiff_t>(shown); line != log_.end(); ++line, row++) {
+        screen_.draw(row, 2, *line, ScreenBuffer::Style::NORMAL, columns - 4);
+    }
+    if (partial) {
+        const auto width = screen_.draw(row, 2, line_, ScreenBuffer::Style::BOLD, columns - 4);
+        screen_.setCursor(row, 2 + width, true);
+        awaitingInput_ = true;
+    } else {
+        screen_.setCursor(rows, 0, false);
+    }
+    screen_.present();
+    rendering_ = false;
+}
@@ -1,33 +1,40 @@
 ﻿#include "TerminalPlayer.h"
 
+#include <chrono>
+#include <iomanip>
 #include <iostream>
 
+#include "HandOdds.h"
 #include "Player.h"
 
-TerminalPlayer::TerminalPlayer(const std::string &name, const int initialChips)
-    : Player(name, initialChips) {
+TerminalPlayer::TerminalPlayer(const std::string &name, const int initialChips, const bool showHud)
+    : Player(name, initialChips), showHud_(showHud), pot_(0) {
 }
 
 Player::Action TerminalPlayer::makeDecision(const int currentBet, const int chipsCommitted,
                                             const std::vector<Card> &communityCards) {
     if (isFolded()) return Action::FOLD;
 
-    std::cout << "\n--- " << name_ << "'s Turn ---" << std::endl;
-    std::cout << "Chips: " << chips_.getChips() << std::endl;
-    std::cout << "Current bet: " << currentBet << ", You've committed: " << chipsCommitted << std::endl;
+    std::cout << "\n--- " << name_ << "'s Turn ---" << '\n';
+    std::cout << "Chips: " << chips_.getChips() << '\n';
+    std::cout << "Current bet: " << currentBet << ", You've committed: " << chipsCommitted << '\n';
 
     std::cout << "Your hole cards: ";
     for (const auto &card: holeCards_) {
         std::cout << card.toString() << " ";
     }
-    std::cout << std::endl;
+    std::cout << '\n';
 
     if (!communityCards.empty()) {
         std::cout << "Community cards: ";
         for (const auto &card: communityCards) {
             std::cout << card.toString() << " ";
         }
-        std::cout << std::endl;
+        std::cout << '\n';
+    }
+
+    if (showHud_) {
+        displayHud(currentBet - chipsCommitted, communityCards);
     }
 
     while (true) {
@@ -53,7 +60,7 @@ Player::Action TerminalPlayer::makeDecision(const int currentBet, const int chip
             }
             case 3: return Action::RAISE;
             default:
-                std::cout << "Invalid choice. Please try again." << std::endl;
+                std::cout << "Invalid choice. Please try again." << '\n';
         }
     }
 }
@@ -64,3 +71,49 @@ int TerminalPlayer::getRaiseAmount(const int currentBet, int _) {
     std::cin >> raiseAmount;
     return raiseAmount;
 }
+
+Task<Player::Decision> TerminalPlayer::decide(const DecisionView &view) {
+    pot_ = view.pot;
+    co_return co_await Player::decide(view);
+}
+
+bool TerminalPlayer::isHuman() const { return true; }
+
+void TerminalPlayer::setPot(const int pot) { pot_ = pot; }
+
+void TerminalPlayer::displayHud(const int toCall, const std::vector<Card> &communityCards) const {
+    const auto started = std::chrono::steady_clock::now();
+    const auto report = HandOdds::analyze(HandEvaluator::toMask(holeCards_), HandEvaluator::toMask(communityCards));
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    const auto flags = std::cout.flags();
+    const auto precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[HUD] Hand: " << HandEvaluator::categoryName(report.category)
+            << " | Equity vs random hand: " << report.equity * 100 << "% ("
+            << (report.exact ? "exact, " : "sampled, ") << report.showdowns << " showdowns, " << micros << "us)"
+            << '\n';
+
+    if (communityCards.size() == 3 || communityCards.size() == 4) {
+        std::cout << "[HUD] Outs: " << report.totalOuts;
+        auto first = true;
+        for (auto category = static_cast<int>(report.category) + 1; category < 9; category++) {
+            if (report.outs[category] == 0) continue;
+            std::cout << (first ? " (" : ", ")
+                    << HandEvaluator::categoryName(static_cast<HandEvaluator::Category>(category)) << " "
+                    << report.outs[category];
+            first = false;
+        }
+        std::cout << (first ? "" : ")") << '\n';
+    }
+
+    if (toCall > 0) {
+        const auto odds = HandOdds::potOdds(toCall, pot_);
+        std::cout << "[HUD] Pot odds: " << odds * 100 << "% (call " << toCall << " into " << pot_ << ") - "
+                << (report.equity >= odds ? "calling is profitable against a random hand"
+                                          : "calling needs more equity") << '\n';
+    }
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
@@ -0,0 +1,162 @@
+﻿#include "TimerWheel.h"
+
+#include <algorithm>
+#include <bit>
+
+TimerWheel::Timer::Timer() : next_(nullptr), link_(nullptr), wheel_(nullptr), expiry_(0), level_(0), slot_(0) {
+}
+
+TimerWheel::Timer::Timer(std::function<void()> callback) : Timer() {
+    callback_ = std::move(callback);
+}
+
+TimerWheel::Timer::~Timer() {
+    if (isArmed()) {
+        wheel_->cancel(*this);
+    }
+}
+
+void TimerWheel::Timer::setCallback(std::function<void()> callback) {
+    callback_ = std::move(callback);
+}
+
+bool TimerWheel::Timer::isArmed() const { return link_ != nullptr; }
+
+TimerWheel::TimerWheel(const std::chrono::milliseconds tick, const Clock::time_point start)
+    : tick_(std::max(tick, std::chrono::milliseconds(1))), start_(start), current_(0), armed_(0), slots_{},
+      occupied_{} {
+}
+
+TimerWheel::~TimerWheel() {
+    for (auto &level: slots_) {
+        for (auto &head: level) {
+            while (head) {
+                unlink(*head);
+            }
+        }
+    }
+}
+
+void TimerWheel::schedule(Timer &timer, const std::chrono::milliseconds delay) {
+    if (timer.isArmed()) {
+        timer.wheel_->cancel(timer);
+    }
+    const auto ticks = (std::max(delay, std::chrono::milliseconds(0)) + tick_ - std::chrono::milliseconds(1)) / tick_;
+    timer.wheel_ = this;
+    timer.expiry_ = current_ + std::max<std::uint64_t>(1, static_cast<std::uint64_t>(ticks));
+    insert(timer);
+    armed_++;
+}
+
+void TimerWheel::cancel(Timer &timer) {
+    if (timer.isArmed() && timer.wheel_ == this) {
+        unlink(timer);
+    }
+}
+
+std::size_t TimerWheel::advance(const Clock::time_point now) {
+    if (now < start_) {
+        return 0;
+    }
+    const auto target = static_cast<std::uint64_t>((now - start_) / tick_);
+    std::size_t fired = 0;
+
+    while (current_ < target) {
+        if (!occupied_[0]) {
+            const auto lastBeforeWrap = current_ | (SLOTS - 1);
+            if (lastBeforeWrap >= target) {
+                current_ = target;
+                break;
+            }
+            current_ = lastBeforeWrap;
+        }
+
+        current_++;
+        if ((current_ & (SLOTS - 1)) == 0) {
+            auto top = 1;
+            while (top < LEVELS - 1 && (current_ >> (SLOT_BITS * top) & (SLOTS - 1)) == 0) {
+                top++;
+            }
+            for (auto level = top; level >= 1; level--) {
+                cascade(level);
+            }
+        }
+
+        const auto index = current_ & (SLOTS - 1);
+        while (auto *timer = slots_[0][index]) {
+            unlink(*timer);
+            fired++;
+            if (timer->callback_) {
+                timer->callback_();
+            }
+        }
+    }
+    return fired;
+}
+
+int TimerWheel::nextTimeoutMs(const Clock::time_point now) const {
+    if (armed_ == 0) {
+        return -1;
+    }
+
+    std::uint64_t ticks;
+    if (const auto upcoming = std::rotr(occupied_[0], static_cast<int>((current_ + 1) & (SLOTS - 1))); upcoming) {
+        ticks = static_cast<std::uint64_t>(std::countr_zero(upcoming)) + 1;
+    } else {
+        ticks = SLOTS - (current_ & (SLOTS - 1));
+    }
+
+    const auto due = start_ + tick_ * static_cast<std::int64_t>(current_ + ticks);
+    if (due <= now) {
+        return 0;
+    }
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(due - now).count();
+    return static_cast<int>(std::min<std::int64_t>(remaining, INT32_MAX));
+}
+
+std::size_t TimerWheel::size() const { return armed_; }
+
+void TimerWheel::insert(Timer &timer) {
+    if (timer.expiry_ < current_) {
+        timer.expiry_ = current_ + 1;
+    }
+    const auto delta = timer.expiry_ - current_;
+    auto level = 0;
+    while (level < LEVELS - 1 && delta >= std::uint64_t{1} << (SLOT_BITS * (level + 1))) {
+        level++;
+    }
+    const auto slot = static_cast<int>(timer.expiry_ >> (SLOT_BITS * level) & (SLOTS - 1));
+
+    auto &head = slots_[level][slot];
+    timer.next_ = head;
+    if (head) {
+        head->link_ = &timer.next_;
+    }
+    head = &timer;
+    timer.link_ = &head;
+    timer.level_ = static_cast<std::uint8_t>(level);
+    timer.slot_ = static_cast<std::uint8_t>(slot);
+    occupied_[level] |= std::uint64_t{1} << slot;
+}
+
+void TimerWheel::unlink(Timer &timer) {
+    *timer.link_ = timer.next_;
+    if (timer.next_) {
+        timer.next_->link_ = timer.link_;
+    }
+    if (!slots_[timer.level_][timer.slot_]) {
+        occupied_[timer.level_] &= ~(std::uint64_t{1} << timer.slot_);
+    }
+    timer.next_ = nullptr;
+    timer.link_ = nullptr;
+    armed_--;
+}
+
+void TimerWheel::cascade(const int level) {
+    const auto index = current_ >> (SLOT_BITS * level) & (SLOTS - 1);
+    while (auto *timer = slots_[level][index]) {
+        unlink(*timer);
+        insert(*timer);
+        armed_++;
+    }
+}
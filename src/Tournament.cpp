@@ -0,0 +1,331 @@
+﻿#include "Tournament.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include "AllocationCounter.h"
+#include "ComputerPlayer.h"
+#include "Console.h"
+#include "DecisionService.h"
+#include "HandAbstraction.h"
+#include "Tracer.h"
+
+namespace {
+    int roundToNice(const double value) {
+        const auto magnitude = std::pow(10.0, std::floor(std::log10(value)) - 1);
+        return static_cast<int>(std::round(value / magnitude) * magnitude);
+    }
+}
+
+Tournament::Tournament(Config config)
+    : config_(std::move(config)), remaining_(0), activeTables_(0), finished_(false), handsPlayed_(0),
+      tableMoves_(0), tablesBroken_(0), allocatingHands_(0) {
+    if (config_.entrants < 2) {
+        throw std::invalid_argument("a tournament needs at least 2 entrants");
+    }
+    if (config_.seatsPerTable < 2) {
+        throw std::invalid_argument("a tournament table needs at least 2 seats");
+    }
+    config_.seatsPerTable = std::min(config_.seatsPerTable, 10);
+    config_.handsPerLevel = std::max(1, config_.handsPerLevel);
+    if (config_.blindSchedule.empty()) {
+        config_.blindSchedule = defaultBlindSchedule(config_.startingStack);
+    }
+    payouts_ = payoutTable(config_.entrants, getPrizePool(), config_.paidFraction);
+    if (config_.decisionService) {
+        decisionService_ = std::make_shared<DecisionService>();
+    }
+    if (!config_.abstractionPath.empty()) {
+#ifdef POKER_HAND_ABSTRACTION
+        abstraction_ = std::make_shared<const HandAbstraction>(config_.abstractionPath);
+#else
+        throw std::runtime_error("hand abstraction buckets are only supported on Linux");
+#endif
+    }
+}
+
+void Tournament::run() {
+    seatEntrants();
+    if (remaining_ == 1) {
+        recordFinish(*tables_.front()->poker.getPlayers().front());
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (auto i = 0; i < std::max(1, config_.workers); i++) {
+        workers.emplace_back(&Tournament::workerLoop, this);
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+std::vector<Tournament::Finish> Tournament::getResults() const {
+    std::lock_guard lock(mutex_);
+    auto results = finishes_;
+    std::ranges::sort(results, {}, &Finish::place);
+    return results;
+}
+
+std::uint64_t Tournament::getHandsPlayed() const { return handsPlayed_.load(); }
+
+std::uint64_t Tournament::getTableMoves() const { return tableMoves_.load(); }
+
+std::uint64_t Tournament::getTablesBroken() const { return tablesBroken_.load(); }
+
+std::uint64_t Tournament::getAllocatingHands() const { return allocatingHands_.load(); }
+
+int Tournament::getTablesOpened() const { return static_cast<int>(tables_.size()); }
+
+int Tournament::getPrizePool() const { return config_.entrants * config_.buyIn; }
+
+const Leaderboard &Tournament::getStandings() const { return standings_; }
+
+std::vector<Tournament::TableView> Tournament::getTableViews(const std::size_t count) const {
+    std::lock_guard lock(mutex_);
+    std::vector<TableView> views;
+    for (const auto &table: tables_) {
+        if (views.size() >= count) {
+            break;
+        }
+        if (!table->broken) {
+            views.push_back({table->id, table->handsPlayed, levelOf(*table), table->seats});
+        }
+    }
+    return views;
+}
+
+std::vector<Tournament::BlindLevel> Tournament::defaultBlindSchedule(const int startingStack) {
+    std::vector<BlindLevel> schedule;
+    auto bigBlind = std::max(2, startingStack / 100);
+    for (auto level = 0; level < 40; level++) {
+        const auto ante = level >= 3 ? bigBlind / 8 : 0;
+        schedule.push_back({bigBlind / 2, bigBlind, ante});
+        bigBlind = std::max(bigBlind + 2, roundToNice(bigBlind * 1.4));
+    }
+    return schedule;
+}
+
+std::vector<int> Tournament::payoutTable(const int entrants, const int prizePool, const double paidFraction) {
+    const auto places = std::clamp(static_cast<int>(entrants * paidFraction), 1, std::max(1, entrants));
+    auto harmonic = 0.0;
+    for (auto place = 1; place <= places; place++) {
+        harmonic += 1.0 / place;
+    }
+
+    const auto minCash = prizePool / (2 * places);
+    const auto ladder = prizePool - minCash * places;
+    std::vector<int> payouts(places);
+    auto paid = 0;
+    for (auto place = 1; place <= places; place++) {
+        payouts[place - 1] = minCash + static_cast<int>(ladder / (place * harmonic));
+        paid += payouts[place - 1];
+    }
+    payouts.front() += prizePool - paid;
+    return payouts;
+}
+
+void Tournament::seatEntrants() {
+    const auto seats = config_.seatsPerTable;
+    const auto tableCount = std::max(1, (config_.entrants + seats - 1) / seats);
+    for (auto id = 0; id < tableCount; id++) {
+        auto table = std::make_unique<Table>();
+        table->id = id;
+        table->poker.setVariant(config_.variant);
+        table->poker.setHistoryRecorded(false);
+        tables_.push_back(std::move(table));
+    }
+    for (auto i = 0; i < config_.entrants; i++) {
+        auto &table = *tables_[i % tableCount];
+        const auto name = "Entrant " + std::to_string(i + 1);
+        auto player = std::make_unique<ComputerPlayer>(name, config_.startingStack);
+        player->setDecisionService(decisionService_);
+        player->setHandAbstraction(abstraction_);
+        table.poker.addPlayer(std::move(player));
+        standings_.update(name, config_.startingStack);
+        table.seated++;
+    }
+
+    remaining_ = config_.entrants;
+    activeTables_ = tableCount;
+    for (const auto &table: tables_) {
+        applyLevel(*table);
+        snapshotSeats(*table);
+        openTables_.emplace(table->seated, table->id);
+        if (table->seated >= 2) {
+            readyTables_.push_back(table.get());
+        } else {
+            table->parked = true;
+        }
+    }
+}
+
+void Tournament::workerLoop() {
+    Console::setQuiet(true);
+    POKER_TRACE_THREAD("tournament worker");
+    std::vector<std::pair<const Player *, int> > startingStacks;
+    [[maybe_unused]] auto handsOnThread = 0;
+    while (true) {
+        Table *table;
+        {
+            std::unique_lock lock(mutex_);
+            ready_.wait(lock, [this] { return finished_ || !readyTables_.empty(); });
+            if (finished_) {
+                return;
+            }
+            table = readyTables_.front();
+            readyTables_.pop_front();
+            absorbInbox(*table);
+        }
+
+        startingStacks.clear();
+        for (const auto &player: table->poker.getPlayers()) {
+            startingStacks.emplace_back(player.get(), player->getChipCount());
+        }
+#ifdef POKER_COUNT_ALLOCATIONS
+        const auto allocationsBefore = AllocationCounter::threadAllocations();
+        table->poker.playHand();
+        if (handsOnThread >= WARMUP_HANDS && table->handsPlayed > 0 &&
+            AllocationCounter::threadAllocations() != allocationsBefore) {
+            allocatingHands_++;
+        }
+#else
+        table->poker.playHand();
+#endif
+        handsOnThread++;
+        handsPlayed_++;
+
+        std::lock_guard lock(mutex_);
+        finishHand(*table, startingStacks);
+    }
+}
+
+void Tournament::finishHand(Table &table, const std::vector<std::pair<const Player *, int> > &startingStacks) {
+    table.handsPlayed++;
+
+    auto busted = table.poker.takeBustedPlayers();
+    const auto stackOf = [&startingStacks](const std::unique_ptr<Player> &player) {
+        return std::ranges::find(startingStacks, player.get(), &std::pair<const Player *, int>::first)->second;
+    };
+    std::ranges::sort(busted, {}, stackOf);
+    for (const auto &player: busted) {
+        standings_.remove(player->getName());
+        recordFinish(*player);
+    }
+    for (const auto &player: table.poker.getPlayers()) {
+        standings_.update(player->getName(), player->getChipCount());
+    }
+    resize(table, table.seated - static_cast<int>(busted.size()));
+    absorbInbox(table);
+
+    snapshotSeats(table);
+
+    if (remaining_ == 1) {
+        recordFinish(*table.poker.getPlayers().front());
+        finished_ = true;
+        ready_.notify_all();
+        return;
+    }
+
+    if (const auto needed = (remaining_ + config_.seatsPerTable - 1) / config_.seatsPerTable;
+        activeTables_ > needed) {
+        breakTable(table);
+        return;
+    }
+
+    balanceFrom(table);
+    applyLevel(table);
+    if (table.seated >= 2) {
+        readyTables_.push_back(&table);
+        ready_.notify_one();
+    } else {
+        table.parked = true;
+    }
+}
+
+void Tournament::recordFinish(const Player &player) {
+    const auto place = remaining_--;
+    const auto prize = place <= static_cast<int>(payouts_.size()) ? payouts_[place - 1] : 0;
+    finishes_.push_back({player.getName(), place, prize});
+}
+
+const Tournament::BlindLevel &Tournament::levelOf(const Table &table) const {
+    const auto level = std::min(table.handsPlayed / config_.handsPerLevel,
+                                static_cast<int>(config_.blindSchedule.size()) - 1);
+    return config_.blindSchedule[level];
+}
+
+void Tournament::applyLevel(Table &table) const {
+    const auto &[smallBlind, bigBlind, ante] = levelOf(table);
+    table.poker.setBlinds(smallBlind, bigBlind, ante);
+}
+
+void Tournament::snapshotSeats(Table &table) {
+    const auto &players = table.poker.getPlayers();
+    table.seats.resize(players.size());
+    for (std::size_t i = 0; i < players.size(); i++) {
+        table.seats[i].name = players[i]->getName();
+        table.seats[i].chips = players[i]->getChipCount();
+    }
+}
+
+void Tournament::breakTable(Table &table) {
+    openTables_.erase({table.seated, table.id});
+    table.broken = true;
+    activeTables_--;
+    tablesBroken_++;
+
+    while (!table.poker.getPlayers().empty()) {
+        auto *target = shortestTable(table);
+        moveSeat(table.poker.takePlayer(table.poker.getPlayers().size() - 1), table, *target);
+    }
+}
+
+void Tournament::balanceFrom(Table &table) {
+    while (true) {
+        auto *target = shortestTable(table);
+        if (!target || table.seated <= target->seated + 1) {
+            break;
+        }
+        moveSeat(table.poker.takePlayer(table.poker.getPlayers().size() - 1), table, *target);
+    }
+}
+
+void Tournament::moveSeat(std::unique_ptr<Player> player, Table &from, Table &to) {
+    resize(from, from.seated - 1);
+    resize(to, to.seated + 1);
+    to.inbox.push_back(std::move(player));
+    tableMoves_++;
+
+    if (to.parked && to.seated >= 2) {
+        to.parked = false;
+        readyTables_.push_back(&to);
+        ready_.notify_one();
+    }
+}
+
+void Tournament::resize(Table &table, const int seated) {
+    if (!table.broken) {
+        openTables_.erase({table.seated, table.id});
+        openTables_.emplace(seated, table.id);
+    }
+    table.seated = seated;
+}
+
+Tournament::Table *Tournament::shortestTable(const Table &exclude) const {
+    for (const auto &[seated, id]: openTables_) {
+        if (id != exclude.id) {
+            return tables_[id].get();
+        }
+    }
+    return nullptr;
+}
+
+void Tournament::absorbInbox(Table &table) {
+    for (auto &player: table.inbox) {
+        table.poker.addPlayer(std::move(player));
+    }
+    table.inbox.clear();
+}
@@ -0,0 +1,250 @@
+﻿#include "Tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "Instrumentation.h"
+
+namespace {
+    constexpr auto MASK = Tracer::RING_CAPACITY - 1;
+
+    struct Event {
+        std::atomic<const char *> name;
+        std::atomic<std::uint64_t> ticks;
+        std::atomic<std::int32_t> argument;
+        std::atomic<std::uint64_t> id;
+        std::atomic<char> phase;
+    };
+
+    struct Ring {
+        std::vector<Event> events = std::vector<Event>(Tracer::RING_CAPACITY);
+        std::atomic<std::uint64_t> head{0};
+        std::atomic<const char *> threadName{nullptr};
+        int id = 0;
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Ring> > rings;
+        std::vector<Ring *> idle;
+        std::chrono::steady_clock::time_point wallOrigin = std::chrono::steady_clock::now();
+        std::uint64_t tickOrigin = Instrumentation::ticks();
+    };
+
+    Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    std::atomic dumpRequested = false;
+
+    class Lease {
+    public:
+        Lease() : registry_(registry()) {
+            std::lock_guard lock(registry_.mutex);
+            if (registry_.idle.empty()) {
+                ring_ = registry_.rings.emplace_back(std::make_unique<Ring>()).get();
+                ring_->id = static_cast<int>(registry_.rings.size());
+            } else {
+                ring_ = registry_.idle.back();
+                registry_.idle.pop_back();
+            }
+        }
+
+        Lease(const Lease &) = delete;
+
+        Lease &operator=(const Lease &) = delete;
+
+        ~Lease() {
+            std::lock_guard lock(registry_.mutex);
+            registry_.idle.push_back(ring_);
+        }
+
+        Ring &ring() const { return *ring_; }
+
+    private:
+        Registry &registry_;
+        Ring *ring_;
+    };
+
+    Ring &localRing() {
+        thread_local Lease lease;
+        return lease.ring();
+    }
+
+    void push(const char *name, const std::int32_t argument, const char phase, const std::uint64_t id = 0) {
+        auto &ring = localRing();
+        const auto head = ring.head.load(std::memory_order_relaxed);
+        auto &event = ring.events[head & MASK];
+        event.name.store(name, std::memory_order_relaxed);
+        event.ticks.store(Instrumentation::ticks(), std::memory_order_relaxed);
+        event.argument.store(argument, std::memory_order_relaxed);
+        event.id.store(id, std::memory_order_relaxed);
+        event.phase.store(phase, std::memory_order_relaxed);
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    struct Snapshot {
+        const char *name;
+        std::uint64_t ticks;
+        std::int32_t argument;
+        std::uint64_t id;
+        char phase;
+    };
+
+    struct AsyncEvent {
+        Snapshot event;
+        int tid;
+    };
+
+    std::vector<Snapshot> snapshot(const Ring &ring) {
+        const auto head = ring.head.load(std::memory_order_acquire);
+        const auto first = head > Tracer::RING_CAPACITY ? head - Tracer::RING_CAPACITY : 0;
+        std::vector<Snapshot> events;
+        events.reserve(head - first);
+        for (auto i = first; i < head; i++) {
+            const auto &event = ring.events[i & MASK];
+            events.push_back({
+                event.name.load(std::memory_order_relaxed), event.ticks.load(std::memory_order_relaxed),
+                event.argument.load(std::memory_order_relaxed), event.id.load(std::memory_order_relaxed),
+                event.phase.load(std::memory_order_relaxed)
+            });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto after = ring.head.load(std::memory_order_relaxed);
+        if (const auto overwritten = after > Tracer::RING_CAPACITY ? after - Tracer::RING_CAPACITY : 0;
+            overwritten > first) {
+            events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(
+                                             std::min<std::uint64_t>(overwritten - first, events.size())));
+        }
+        return events;
+    }
+
+    void writeString(std::ostream &out, const char *text) {
+        out << '"';
+        for (; *text; text++) {
+            if (*text == '"' || *text == '\\') {
+                out << '\\';
+            }
+            out << *text;
+        }
+        out << '"';
+    }
+}
+
+void Tracer::begin(const char *name, const std::int32_t argument) { push(name, argument, 'B'); }
+
+void Tracer::end(const char *name) { push(name, NO_ARGUMENT, 'E'); }
+
+void Tracer::beginAsync(const char *name, const std::uint64_t id, const std::int32_t argument) {
+    push(name, argument, 'b', id);
+}
+
+void Tracer::endAsync(const char *name, const std::uint64_t id) { push(name, NO_ARGUMENT, 'e', id); }
+
+void Tracer::setThreadName(const char *name) {
+    localRing().threadName.store(name, std::memory_order_relaxed);
+}
+
+std::size_t Tracer::dump(std::ostream &out) {
+    auto &shared = registry();
+    std::lock_guard lock(shared.mutex);
+    const auto elapsedTicks = Instrumentation::ticks() - shared.tickOrigin;
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                                   shared.wallOrigin).count();
+    const auto microsecondsPerTick = elapsedTicks == 0 ? 0.0 : elapsed / static_cast<double>(elapsedTicks);
+
+    std::size_t written = 0;
+    const auto flags = out.flags();
+    const auto precision = out.precision(3);
+    out << std::fixed;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    const auto writeEvent = [&](const Snapshot &event, const int tid) {
+        const auto since = static_cast<double>(static_cast<std::int64_t>(event.ticks - shared.tickOrigin));
+        out << ",\n{\"name\":";
+        writeString(out, event.name);
+        out << ",\"ph\":\"" << event.phase << "\",\"ts\":" << since * microsecondsPerTick << ",\"pid\":1,\"tid\":"
+            << tid;
+        if (event.phase == 'b' || event.phase == 'e') {
+            out << R"(,"cat":"table","id":")" << std::hex << event.id << std::dec << '"';
+        }
+        if (event.argument != NO_ARGUMENT) {
+            out << ",\"args\":{\"seat\":" << event.argument << "}";
+        }
+        out << "}";
+        written++;
+    };
+
+    std::vector<AsyncEvent> async;
+    for (const auto &ring: shared.rings) {
+        const auto tid = ring->id;
+        out << (written == 0 ? "\n" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid
+            << R"(,"args":{"name":)";
+        const auto threadName = ring->threadName.load(std::memory_order_relaxed);
+        writeString(out, threadName ? threadName : ("thread " + std::to_string(tid)).c_str());
+        out << "}}";
+        written++;
+
+        auto depth = 0;
+        for (const auto &event: snapshot(*ring)) {
+            if (event.phase == 'b' || event.phase == 'e') {
+                async.push_back({event, tid});
+                continue;
+            }
+            if (event.phase == 'E' && depth == 0) {
+                continue;
+            }
+            depth += event.phase == 'B' ? 1 : -1;
+            writeEvent(event, tid);
+        }
+    }
+
+    std::ranges::stable_sort(async, {}, [](const AsyncEvent &entry) { return entry.event.ticks; });
+    std::map<std::pair<std::uint64_t, std::string_view>, int> asyncDepth;
+    for (const auto &[event, tid]: async) {
+        auto &open = asyncDepth[{event.id, event.name}];
+        if (event.phase == 'e' && open == 0) {
+            continue;
+        }
+        open += event.phase == 'b' ? 1 : -1;
+        writeEvent(event, tid);
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+    return written;
+}
+
+std::size_t Tracer::dump(const std::string &path) {
+    const auto temporary = path + ".tmp";
+    std::size_t written;
+    {
+        std::ofstream out(temporary);
+        if (!out) {
+            throw std::runtime_error("failed to write trace: " + temporary);
+        }
+        written = dump(out);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("failed to write trace: " + path);
+    }
+    return written;
+}
+
+void Tracer::requestDump() { dumpRequested.store(true, std::memory_order_relaxed); }
+
+bool Tracer::takeDumpRequest() { return dumpRequested.exchange(false, std::memory_order_relaxed); }
+
+const char *Tracer::streetName(const int street) {
+    static constexpr const char *NAMES[] = {"preflop", "flop", "turn", "river"};
+    return NAMES[std::clamp(street, 0, 3)];
+}
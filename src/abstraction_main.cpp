@@ -0,0 +1,53 @@
+﻿#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "HandAbstraction.h"
+
+int main(const int argc, char *argv[]) {
+    HandAbstraction::BuildConfig config;
+    config.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string streets = "all";
+    std::string directory = ".";
+
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--street") streets = value;
+        else if (option == "--buckets") config.buckets = std::stoi(value);
+        else if (option == "--bins") config.bins = std::stoi(value);
+        else if (option == "--rollouts") config.rollouts = std::stoi(value);
+        else if (option == "--opponents") config.opponents = std::stoi(value);
+        else if (option == "--iterations") config.iterations = std::stoi(value);
+        else if (option == "--threads") config.threads = std::stoi(value);
+        else if (option == "--seed") config.seed = std::stoull(value);
+        else if (option == "--out") directory = value;
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    std::filesystem::create_directories(directory);
+    for (auto street = 0; street < 4; street++) {
+        if (streets != "all" && streets != std::to_string(street)) {
+            continue;
+        }
+        config.street = street;
+        const auto path = (std::filesystem::path(directory) / HandAbstraction::fileName(street)).string();
+        const auto stats = HandAbstraction::build(config, path);
+        std::cout << HandAbstraction::fileName(street) << ": " << stats.hands << " hands, " << config.buckets
+                << " buckets, features " << stats.featureSeconds << "s, clustering " << stats.clusterSeconds
+                << "s (" << stats.iterations << " iterations, " << config.threads << " threads)" << std::endl;
+    }
+
+    const HandAbstraction abstraction(directory);
+    const std::vector holeCards{Card(Card::Suit::SPADES, Card::Rank::ACE), Card(Card::Suit::HEARTS, Card::Rank::ACE)};
+    const std::vector trash{Card(Card::Suit::SPADES, Card::Rank::SEVEN), Card(Card::Suit::HEARTS, Card::Rank::TWO)};
+    if (abstraction.hasStreet(0)) {
+        std::cout << "Preflop bucket AA: " << abstraction.bucket(holeCards, {}) << ", 72o: "
+                << abstraction.bucket(trash, {}) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,396 @@
+﻿#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Console.h"
+#include "DecisionService.h"
+#include "HandEvaluator.h"
+#include "PokerTable.h"
+
+class PokerTableBench {
+public:
+    PokerTableBench(const int seats, const int stack, const std::uint32_t seed) : stack_(stack) {
+        table_.rng_.seed(seed);
+        table_.setHistoryRecorded(false);
+        table_.setBlinds(5, 10);
+        for (auto seat = 0; seat < seats; seat++) {
+            table_.addPlayer(std::make_unique<ScriptedPlayer>("Seat " + std::to_string(seat + 1), stack,
+                                                              scriptFor(seat, seats)));
+        }
+    }
+
+    static int evaluateHandStrength(const std::vector<Card> &holeCards, const std::vector<Card> &communityCards) {
+        return PokerTable::evaluateHandStrength(holeCards, communityCards);
+    }
+
+    void initializeDeck() { table_.initializeDeck(); }
+
+    void shuffleDeck() { table_.shuffleDeck(); }
+
+    std::size_t deckSize() const { return table_.deck_.size(); }
+
+    bool bettingRound() {
+        reset();
+        const auto seats = static_cast<int>(table_.players_.size());
+        std::pmr::vector<int> blinds(seats, 0, &table_.arena_);
+        blinds[0] = 5;
+        blinds[1] = 10;
+        table_.pot_ = 15;
+        table_.contributed_.assign(seats, 0);
+        table_.contributed_[0] = 5;
+        table_.contributed_[1] = 10;
+        return runSync(table_.bettingRoundAsync(std::move(blinds), 10, 2 % seats));
+    }
+
+    int showdown(const std::vector<std::vector<Card> > &holeCards, const std::vector<Card> &board) {
+        reset();
+        for (std::size_t seat = 0; seat < table_.players_.size(); seat++) {
+            auto &player = *table_.players_[seat];
+            player.clearHand();
+            for (const auto &card: holeCards[seat]) {
+                player.receiveCard(card);
+            }
+        }
+        table_.communityCards_ = board;
+        table_.pot_ = 100 * static_cast<int>(table_.players_.size());
+        table_.contributed_.assign(table_.players_.size(), 100);
+        table_.determineWinner();
+        return table_.players_.front()->getChipCount();
+    }
+
+    int playHand() {
+        table_.playHand();
+        refill();
+        return table_.players_.front()->getChipCount();
+    }
+
+    int settle(const std::size_t winner) {
+        reset();
+        std::pmr::vector<bool> folded(table_.players_.size(), true, &table_.arena_);
+        folded[winner % folded.size()] = false;
+        table_.pot_ = 100 * static_cast<int>(table_.players_.size());
+        table_.awardPot(folded);
+        return table_.players_[winner % folded.size()]->getChipCount();
+    }
+
+private:
+    class ScriptedPlayer final : public Player {
+    public:
+        ScriptedPlayer(std::string name, const int chips, std::vector<Action> script)
+            : Player(std::move(name), chips), script_(std::move(script)), step_(0) {
+        }
+
+        Action makeDecision(const int currentBet, const int chipsCommitted, const std::vector<Card> &) override {
+            const auto action = script_[std::min(step_++, script_.size() - 1)];
+            if (action == Action::CHECK && currentBet > chipsCommitted) {
+                return Action::CALL;
+            }
+            if (action == Action::CALL && currentBet <= chipsCommitted) {
+                return Action::CHECK;
+            }
+            return action;
+        }
+
+        int getRaiseAmount(const int currentBet, int) override { return currentBet * 3; }
+
+        void clearHand() override {
+            Player::clearHand();
+            step_ = 0;
+        }
+
+    private:
+        std::vector<Action> script_;
+        std::size_t step_;
+    };
+
+    PokerTable table_;
+    int stack_;
+
+    static std::vector<Player::Action> scriptFor(const int seat, const int seats) {
+        using enum Player::Action;
+        if (seat == 2 % seats) return {RAISE, CALL};
+        if (seat == seats - 1) return {FOLD};
+        if (seat == 0) return {CALL, RAISE, CALL};
+        return {CALL};
+    }
+
+    void refill() const {
+        for (const auto &player: table_.players_) {
+            if (const auto difference = stack_ - player->getChipCount(); difference > 0) {
+                player->addChips(difference);
+            } else {
+                player->takeChips(-difference);
+            }
+        }
+    }
+
+    void reset() {
+        table_.arena_.reset();
+        refill();
+        for (const auto &player: table_.players_) {
+            player->clearHand();
+        }
+    }
+};
+
+namespace {
+    struct Options {
+        double minTime = 0.2;
+        int repetitions = 5;
+        std::uint32_t seed = 1;
+        int seats = 6;
+        std::string filter;
+        std::string out;
+        bool checkAllocations = false;
+    };
+
+    struct Result {
+        std::string name;
+        std::uint64_t iterations;
+        double nsPerOp;
+        double opsPerSecond;
+        double allocationsPerOp;
+    };
+
+    constexpr auto HANDS_PER_CATEGORY = 1024;
+    constexpr std::size_t DECISION_BATCH = 256;
+    constexpr std::array<std::string_view, 4> STEADY_STATE_BENCHMARKS{
+        "betting_round", "determine_winner", "award_pot", "play_hand"
+    };
+
+    volatile std::int64_t sink;
+
+    template<typename Body>
+    Result measure(const std::string &name, const Options &options, Body &&body) {
+        using Clock = std::chrono::steady_clock;
+        const auto timeBatch = [&body](const std::uint64_t iterations) {
+            std::int64_t total = 0;
+            const auto started = Clock::now();
+            for (std::uint64_t i = 0; i < iterations; i++) {
+                total += body(i);
+            }
+            const auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+            sink = total;
+            return elapsed;
+        };
+
+        std::uint64_t iterations = 1;
+        while (timeBatch(iterations) < options.minTime && iterations < (1ull << 40)) {
+            iterations *= 2;
+        }
+
+        std::vector<double> samples;
+        samples.reserve(std::max(1, options.repetitions));
+        const auto allocationsBefore = AllocationCounter::threadAllocations();
+        for (auto r = 0; r < std::max(1, options.repetitions); r++) {
+            samples.push_back(timeBatch(iterations) * 1e9 / static_cast<double>(iterations));
+        }
+        const auto allocations = AllocationCounter::threadAllocations() - allocationsBefore;
+        std::ranges::sort(samples);
+
+        const auto nsPerOp = samples[samples.size() / 2];
+        return {
+            name, iterations, nsPerOp, 1e9 / nsPerOp,
+            static_cast<double>(allocations) / static_cast<double>(iterations * samples.size())
+        };
+    }
+
+    std::vector<std::vector<Card> > handsOfCategory(const HandEvaluator::Category category, std::mt19937 &rng) {
+        std::array<int, 52> deck{};
+        std::iota(deck.begin(), deck.end(), 0);
+        std::vector<std::vector<Card> > hands;
+        while (hands.size() < HANDS_PER_CATEGORY) {
+            HandEvaluator::CardMask mask = 0;
+            for (auto i = 0; i < 7; i++) {
+                std::uniform_int_distribution pick(i, 51);
+                std::swap(deck[i], deck[pick(rng)]);
+                mask |= HandEvaluator::cardBit(deck[i]);
+            }
+            if (HandEvaluator::categoryOf(HandEvaluator::evaluate(mask)) == category) {
+                std::vector<Card> cards;
+                for (auto i = 0; i < 7; i++) {
+                    cards.push_back(HandEvaluator::cardFromIndex(deck[i]));
+                }
+                hands.push_back(std::move(cards));
+            }
+        }
+        return hands;
+    }
+
+    std::string benchmarkName(std::string name) {
+        std::ranges::transform(name, name.begin(), [](const char c) {
+            return c == ' ' ? '_' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        });
+        return name;
+    }
+
+    void writeJson(std::ostream &out, const Options &options, const std::vector<Result> &results) {
+        out << "{\n  \"context\": {\"seed\": " << options.seed << ", \"seats\": " << options.seats
+            << ", \"min_time\": " << options.minTime << ", \"repetitions\": " << options.repetitions << "},\n";
+        out << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const auto &[name, iterations, nsPerOp, opsPerSecond, allocationsPerOp] = results[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << name << "\", \"iterations\": " << iterations
+                << ", \"ns_per_op\": " << nsPerOp << ", \"ops_per_sec\": " << opsPerSecond
+                << ", \"allocations_per_op\": " << allocationsPerOp << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    Options options;
+    if (argc % 2 == 0) {
+        std::cerr << "Missing value for " << argv[argc - 1] << std::endl;
+        return 1;
+    }
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--min-time") options.minTime = std::stod(value);
+        else if (option == "--repetitions") options.repetitions = std::stoi(value);
+        else if (option == "--seed") options.seed = static_cast<std::uint32_t>(std::stoul(value));
+        else if (option == "--seats") options.seats = std::clamp(std::stoi(value), 3, 10);
+        else if (option == "--filter") options.filter = value;
+        else if (option == "--out") options.out = value;
+        else if (option == "--check-allocations") options.checkAllocations = value != "0";
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    Console::setQuiet(true);
+    std::vector<Result> results;
+    const auto run = [&options, &results](const std::string &name, auto &&body) {
+        if (name.find(options.filter) != std::string::npos) {
+            results.push_back(measure(name, options, body));
+        }
+    };
+
+    std::mt19937 rng(options.seed);
+    for (auto c = 0; c <= static_cast<int>(HandEvaluator::Category::STRAIGHT_FLUSH); c++) {
+        const auto category = static_cast<HandEvaluator::Category>(c);
+        const auto suffix = "/" + benchmarkName(HandEvaluator::categoryName(category));
+        const auto legacyName = "evaluate_hand_strength" + suffix;
+        const auto evaluatorName = "hand_evaluator" + suffix;
+        if (legacyName.find(options.filter) == std::string::npos &&
+            evaluatorName.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        const auto hands = handsOfCategory(category, rng);
+        std::vector<std::vector<Card> > holes;
+        std::vector<std::vector<Card> > boards;
+        std::vector<HandEvaluator::CardMask> masks;
+        for (const auto &hand: hands) {
+            holes.emplace_back(hand.begin(), hand.begin() + 2);
+            boards.emplace_back(hand.begin() + 2, hand.end());
+            masks.push_back(HandEvaluator::toMask(hand));
+        }
+        run(legacyName, [&holes, &boards](const std::uint64_t i) {
+            return PokerTableBench::evaluateHandStrength(holes[i % HANDS_PER_CATEGORY], boards[i % HANDS_PER_CATEGORY]);
+        });
+        run(evaluatorName, [&masks](const std::uint64_t i) {
+            return HandEvaluator::evaluate(masks[i % HANDS_PER_CATEGORY]);
+        });
+    }
+
+    PokerTableBench bench(options.seats, 1000, options.seed);
+    run("initialize_deck", [&bench](std::uint64_t) {
+        bench.initializeDeck();
+        return static_cast<int>(bench.deckSize());
+    });
+    run("shuffle_deck", [&bench](std::uint64_t) {
+        bench.shuffleDeck();
+        return static_cast<int>(bench.deckSize());
+    });
+    run("betting_round", [&bench](std::uint64_t) { return static_cast<int>(bench.bettingRound()); });
+
+    std::vector<std::vector<std::vector<Card> > > showdownHoles;
+    std::vector<std::vector<Card> > showdownBoards;
+    std::array<int, 52> deck{};
+    std::iota(deck.begin(), deck.end(), 0);
+    for (auto deal = 0; deal < 256; deal++) {
+        std::ranges::shuffle(deck, rng);
+        auto next = 0;
+        auto &holes = showdownHoles.emplace_back(options.seats);
+        for (auto &hole: holes) {
+            hole = {HandEvaluator::cardFromIndex(deck[next]), HandEvaluator::cardFromIndex(deck[next + 1])};
+            next += 2;
+        }
+        auto &board = showdownBoards.emplace_back();
+        for (auto i = 0; i < 5; i++) {
+            board.push_back(HandEvaluator::cardFromIndex(deck[next++]));
+        }
+    }
+    run("determine_winner", [&](const std::uint64_t i) {
+        return bench.showdown(showdownHoles[i % showdownHoles.size()], showdownBoards[i % showdownBoards.size()]);
+    });
+    run("award_pot", [&bench](const std::uint64_t i) { return bench.settle(i); });
+    run("play_hand", [&bench](std::uint64_t) { return bench.playHand(); });
+
+    if (std::string_view("decision/per_call decision/service").find(options.filter) != std::string_view::npos) {
+        std::vector<DecisionService::Request> requests;
+        for (std::size_t deal = 0; deal < showdownHoles.size(); deal++) {
+            for (const auto &hole: showdownHoles[deal]) {
+                requests.push_back({
+                    HandEvaluator::toMask(hole),
+                    HandEvaluator::toMask(std::vector(showdownBoards[deal].begin(), showdownBoards[deal].begin() + 3)),
+                    options.seats - 1, 20, 0, 1000
+                });
+            }
+        }
+        DecisionService service(DECISION_BATCH);
+        run("decision/per_call", [&service, &requests](const std::uint64_t i) {
+            return static_cast<int>(service.decideNow(requests[i % requests.size()]).action);
+        });
+        std::vector<std::future<DecisionService::Result> > pending(DECISION_BATCH);
+        std::vector<int> actions(DECISION_BATCH);
+        run("decision/service", [&service, &requests, &pending, &actions](const std::uint64_t i) {
+            if (i % DECISION_BATCH == 0) {
+                for (std::size_t j = 0; j < DECISION_BATCH; j++) {
+                    pending[j] = service.submit(requests[(i + j) % requests.size()]);
+                }
+                for (std::size_t j = 0; j < DECISION_BATCH; j++) {
+                    actions[j] = static_cast<int>(pending[j].get().action);
+                }
+            }
+            return actions[i % DECISION_BATCH];
+        });
+    }
+    Console::setQuiet(false);
+
+    if (options.out.empty()) {
+        writeJson(std::cout, options, results);
+    } else {
+        std::ofstream file(options.out);
+        if (!file) {
+            std::cerr << "Cannot open " << options.out << std::endl;
+            return 1;
+        }
+        writeJson(file, options, results);
+    }
+
+    auto allocating = 0;
+    for (const auto &result: results) {
+        if (options.checkAllocations && result.allocationsPerOp > 0 &&
+            std::ranges::find(STEADY_STATE_BENCHMARKS, result.name) != STEADY_STATE_BENCHMARKS.end()) {
+            std::cerr << "Steady-state allocation check failed: " << result.name << " makes "
+                    << result.allocationsPerOp << " allocations per op" << std::endl;
+            allocating++;
+        }
+    }
+    return allocating > 0 ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+﻿#include <iostream>
+#include <span>
+#include <string>
+
+#include "GameClient.h"
+#include "HandEvaluator.h"
+#include "TerminalPlayer.h"
+
+namespace {
+    const char *describe(const Player::Action action) {
+        switch (action) {
+            case Player::Action::FOLD: return "folds";
+            case Player::Action::CHECK: return "checks";
+            case Player::Action::CALL: return "calls";
+            case Player::Action::RAISE: return "raises";
+        }
+        return "";
+    }
+
+    std::string cardsText(const std::span<const std::uint8_t> cards) {
+        std::string text;
+        for (const auto index: cards) {
+            text += HandEvaluator::cardFromIndex(index).toString() + " ";
+        }
+        return text;
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    std::string host = "127.0.0.1";
+    std::uint16_t port = 7777;
+    std::string unixPath;
+    std::uint32_t tableKey = 0;
+    std::string name = "Player";
+    auto showHud = false;
+    auto spectate = false;
+
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--host") host = value;
+        else if (option == "--port") port = static_cast<std::uint16_t>(std::stoi(value));
+        else if (option == "--unix") unixPath = value;
+        else if (option == "--table") tableKey = static_cast<std::uint32_t>(std::stoul(value));
+        else if (option == "--name") name = value;
+        else if (option == "--hud") showHud = value == "on";
+        else if (option == "--spectate") spectate = value == "1";
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    auto client = unixPath.empty() ? GameClient::connectTcp(host, port) : GameClient::connectUnix(unixPath);
+    if (spectate) {
+        client.send(Protocol::Spectate{tableKey});
+        std::cout << "Watching table " << tableKey << "..." << std::endl;
+    } else {
+        client.send(Protocol::Join{tableKey, name});
+    }
+
+    while (const auto frame = client.receive()) {
+        switch (frame->type) {
+            case Protocol::MessageType::JOINED: {
+                if (Protocol::Joined joined{}; Protocol::decode(frame->payload, joined)) {
+                    std::cout << "Joined table " << joined.tableKey << " in seat " << joined.seat + 1
+                            << ". Waiting for the hand to start..." << std::endl;
+                }
+                break;
+            }
+            case Protocol::MessageType::DECISION_REQUEST: {
+                Protocol::DecisionRequest request{};
+                if (!Protocol::decode(frame->payload, request)) break;
+
+                TerminalPlayer seat(name, request.chipCount, showHud);
+                seat.setPot(request.pot);
+                for (std::size_t i = 0; i < request.holeCount; i++) {
+                    seat.receiveCard(HandEvaluator::cardFromIndex(request.holeCards[i]));
+                }
+                std::vector<Card> board;
+                for (std::size_t i = 0; i < request.boardCount; i++) {
+                    board.push_back(HandEvaluator::cardFromIndex(request.board[i]));
+                }
+                if (request.timeLimitMs > 0) {
+                    std::cout << "Time limit: " << request.timeLimitMs / 1000.0 << "s (time bank "
+                            << request.timeBankMs / 1000.0 << "s)" << std::endl;
+                }
+
+                const auto action = seat.makeDecision(request.currentBet, request.chipsCommitted, board);
+                const auto raiseAmount = action == Player::Action::RAISE
+                                             ? seat.getRaiseAmount(request.currentBet, request.chipsCommitted)
+                                             : 0;
+                client.send(Protocol::Action{request.sequence, action, raiseAmount});
+                break;
+            }
+            case Protocol::MessageType::ACTION_NOTICE: {
+                if (Protocol::ActionNotice notice{}; Protocol::decode(frame->payload, notice) &&
+                                                     (spectate || notice.playerName != name)) {
+                    std::cout << notice.playerName << " " << describe(notice.action);
+                    if (notice.amount > 0) std::cout << " (" << notice.amount << ")";
+                    std::cout << std::endl;
+                }
+                break;
+            }
+            case Protocol::MessageType::CHIP_UPDATE: {
+                if (Protocol::ChipUpdate update{}; Protocol::decode(frame->payload, update)) {
+                    std::cout << "Hand " << update.handsPlayed << " finished. Chips: " << update.chipCount
+                            << std::endl;
+                }
+                break;
+            }
+            case Protocol::MessageType::HAND_STARTED: {
+                if (Protocol::HandStarted started{}; Protocol::decode(frame->payload, started)) {
+                    std::cout << "\n--- Hand " << started.handNumber << " (pot " << started.pot << ") ---" << std::endl;
+                    for (std::size_t seat = 0; seat < started.seats.size(); seat++) {
+                        std::cout << (seat == started.button ? " * " : "   ") << started.seats[seat].name << ": "
+                                << started.seats[seat].chipCount << std::endl;
+                    }
+                }
+                break;
+            }
+            case Protocol::MessageType::STREET_DEALT: {
+                if (Protocol::StreetDealt dealt{}; Protocol::decode(frame->payload, dealt)) {
+                    std::cout << "Board: " << cardsText(std::span(dealt.board).first(dealt.boardCount))
+                            << "(pot " << dealt.pot << ")" << std::endl;
+                }
+                break;
+            }
+            case Protocol::MessageType::SHOWDOWN: {
+                if (Protocol::Showdown showdown{}; Protocol::decode(frame->payload, showdown)) {
+                    std::cout << showdown.playerName << " shows "
+                            << cardsText(std::span(showdown.holeCards).first(showdown.holeCount)) << std::endl;
+                }
+                break;
+            }
+            case Protocol::MessageType::TABLE_CLOSED: {
+                if (Protocol::TableClosed closed{}; Protocol::decode(frame->payload, closed)) {
+                    std::cout << "Table closed. Final chips: " << closed.chipCount << std::endl;
+                }
+                return 0;
+            }
+            default:
+                break;
+        }
+    }
+
+    std::cout << "Connection closed by server." << std::endl;
+    return 0;
+}
@@ -0,0 +1,144 @@
+﻿#include <array>
+#include <bit>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <thread>
+#include <vector>
+
+#include "HandEvaluator.h"
+#include "HandHistoryImporter.h"
+#include "OpponentModel.h"
+
+namespace {
+    constexpr std::size_t MODEL_CAPACITY = 1 << 16;
+
+    struct Replay {
+        OpponentModelStore models{MODEL_CAPACITY};
+        std::array<std::uint64_t, OpponentModelStore::CATEGORIES> categories{};
+        std::uint64_t showdowns = 0;
+        std::uint64_t agreed = 0;
+    };
+
+    void replay(const HandHistoryImporter::Hand &hand, Replay &state) {
+        std::uint32_t folded = 0;
+        for (const auto &action: hand.actions) {
+            const auto &seat = hand.seats[action.seat];
+            state.models.recordAction(seat.name, action.action, action.amount, action.pot, action.street);
+            if (action.action == Player::Action::FOLD) folded |= 1u << action.seat;
+        }
+        if (std::popcount(hand.board) != 5) return;
+
+        std::array<std::pair<std::size_t, int>, HandHistoryImporter::MAX_SEATS> shown{};
+        std::size_t shownCount = 0;
+        for (std::size_t i = 0; i < hand.seats.size(); i++) {
+            if ((folded & (1u << i)) || std::popcount(hand.seats[i].holeCards) != 2) continue;
+            shown[shownCount++] = {i, HandEvaluator::evaluate(hand.seats[i].holeCards | hand.board)};
+        }
+        if (shownCount < 2) return;
+
+        auto bestScore = -1;
+        auto bestCollected = false;
+        for (std::size_t i = 0; i < shownCount; i++) {
+            const auto &[index, score] = shown[i];
+            const auto category = HandEvaluator::categoryOf(score);
+            state.categories[static_cast<int>(category)]++;
+            state.models.recordShowdown(hand.seats[index].name, category);
+            if (score > bestScore) {
+                bestScore = score;
+                bestCollected = hand.seats[index].collected > 0;
+            }
+        }
+        state.showdowns++;
+        if (bestCollected) state.agreed++;
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    auto threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string player;
+    std::vector<std::string> paths;
+
+    for (auto i = 1; i < argc; i++) {
+        const std::string option = argv[i];
+        if (!option.starts_with("--")) {
+            paths.push_back(option);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << std::endl;
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (option == "--threads") {
+            threads = std::stoi(value);
+            if (threads < 1) {
+                std::cerr << "--threads must be at least 1" << std::endl;
+                return 1;
+            }
+        } else if (option == "--player") player = value;
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "Usage: poker_import [--threads N] [--player NAME] FILE..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Replay> > replays;
+    for (auto i = 0; i < threads; i++) {
+        replays.push_back(std::make_unique<Replay>());
+    }
+    HandHistoryImporter::Stats stats{};
+    try {
+        stats = HandHistoryImporter::import(paths, threads, [&replays](const auto &hand, const int thread) {
+            replay(hand, *replays[thread]);
+        });
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Import failed: " << error.what() << std::endl;
+        return 1;
+    }
+
+    auto &merged = *replays.front();
+    for (std::size_t i = 1; i < replays.size(); i++) {
+        merged.models.merge(replays[i]->models);
+        for (auto c = 0; c < OpponentModelStore::CATEGORIES; c++) {
+            merged.categories[c] += replays[i]->categories[c];
+        }
+        merged.showdowns += replays[i]->showdowns;
+        merged.agreed += replays[i]->agreed;
+    }
+
+    const auto megabytes = static_cast<double>(stats.bytes) / (1 << 20);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Imported " << stats.hands << " hands (" << stats.skipped << " skipped, " << stats.actions
+            << " actions) from " << stats.files << " files, " << megabytes << " MB in " << stats.seconds << "s ("
+            << megabytes / stats.seconds << " MB/s on " << threads << " threads)" << std::endl;
+    std::cout << "Showdowns replayed: " << merged.showdowns << ", evaluator agreed with the winner in "
+            << merged.agreed << std::endl;
+    for (auto c = 0; c < OpponentModelStore::CATEGORIES; c++) {
+        std::cout << "  " << HandEvaluator::categoryName(static_cast<HandEvaluator::Category>(c)) << ": "
+                << merged.categories[c] << std::endl;
+    }
+    std::cout << "Players modeled: " << merged.models.size() << std::endl;
+
+    if (!player.empty()) {
+        const auto *model = merged.models.find(player);
+        if (!model) {
+            std::cout << player << ": no hands imported" << std::endl;
+            return 0;
+        }
+        std::cout << player << ":" << std::endl;
+        for (auto street = 0; street < OpponentModelStore::STREETS; street++) {
+            std::cout << "  street " << street << ": looseness " << model->looseness(street) << ", aggression "
+                    << model->aggression(street) << std::endl;
+        }
+        std::cout << "  showdown strength " << model->showdownStrength() << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,281 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "ComputerPlayer.h"
+#include "Console.h"
+#include "GameClient.h"
+#include "GameServer.h"
+#include "HandEvaluator.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::uint32_t REJOIN_KEYS = 1u << 24;
+
+    struct Options {
+        std::string host = "127.0.0.1";
+        std::uint16_t port = 0;
+        int clients = 1000;
+        int threads = 1;
+        int workers = 1;
+        int seats = 6;
+        int chips = 1000;
+        int hands = 100;
+        double seconds = 10.0;
+        double rate = 0.0;
+    };
+
+    struct Bot {
+        GameClient client;
+        std::string name;
+        ComputerPlayer brain;
+        std::vector<Card> board;
+        Protocol::Action reply{};
+        Clock::time_point sentAt;
+        bool awaitingEcho = false;
+
+        Bot(GameClient connection, const std::string &botName)
+            : client(std::move(connection)), name(botName), brain(botName) {
+        }
+    };
+
+    struct Shard {
+        std::vector<std::unique_ptr<Bot> > bots;
+        std::vector<std::uint32_t> latencies;
+        std::uint64_t actions = 0;
+        std::uint64_t chipUpdates = 0;
+        std::uint64_t rejoins = 0;
+        std::uint64_t disconnects = 0;
+    };
+
+    double secondsSince(const Clock::time_point started) {
+        return std::chrono::duration<double>(Clock::now() - started).count();
+    }
+
+    GameClient connectBot(const int epoll, Bot *bot, GameClient client) {
+        client.setNonBlocking();
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = bot;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, client.getFd(), &event);
+        return client;
+    }
+
+    void decide(Bot &bot, const Protocol::DecisionRequest &request) {
+        auto &brain = bot.brain;
+        brain.clearHand();
+        brain.resetFold();
+        if (const auto difference = request.chipCount - brain.getChipCount(); difference > 0) {
+            brain.addChips(difference);
+        } else if (difference < 0) {
+            brain.takeChips(-difference);
+        }
+        for (std::size_t i = 0; i < request.holeCount; i++) {
+            brain.receiveCard(HandEvaluator::cardFromIndex(request.holeCards[i]));
+        }
+        bot.board.clear();
+        for (std::size_t i = 0; i < request.boardCount; i++) {
+            bot.board.push_back(HandEvaluator::cardFromIndex(request.board[i]));
+        }
+
+        const auto action = brain.makeDecision(request.currentBet, request.chipsCommitted, bot.board);
+        bot.reply = {
+            request.sequence, action, action == Player::Action::RAISE ? brain.getRaiseAmount(request.currentBet, 0) : 0
+        };
+    }
+
+    void sendReply(Shard &shard, Bot &bot) {
+        bot.sentAt = Clock::now();
+        bot.awaitingEcho = true;
+        bot.client.send(bot.reply);
+        shard.actions++;
+    }
+
+    void runShard(Shard &shard, const Options &options, const Clock::time_point deadline,
+                  std::atomic<std::uint32_t> &rejoinSeats) {
+        Console::setQuiet(true);
+        const auto epoll = epoll_create1(EPOLL_CLOEXEC);
+        for (const auto &bot: shard.bots) {
+            bot->client = connectBot(epoll, bot.get(), std::move(bot->client));
+        }
+
+        const auto interval = options.rate > 0
+                                  ? std::chrono::duration_cast<Clock::duration>(
+                                      std::chrono::duration<double>(options.threads / options.rate))
+                                  : Clock::duration::zero();
+        auto nextRelease = Clock::now();
+        std::deque<Bot *> queued;
+        std::vector<epoll_event> events(256);
+
+        while (Clock::now() < deadline) {
+            auto timeout = 50;
+            if (!queued.empty()) {
+                const auto wait = std::chrono::ceil<std::chrono::milliseconds>(nextRelease - Clock::now()).count();
+                timeout = static_cast<int>(std::clamp<long long>(wait, 0, timeout));
+            }
+            const auto count = epoll_wait(epoll, events.data(), static_cast<int>(events.size()), timeout);
+
+            for (auto i = 0; i < count; i++) {
+                auto &bot = *static_cast<Bot *>(events[i].data.ptr);
+                auto open = bot.client.fillNonBlocking();
+                auto closed = false;
+                while (const auto frame = bot.client.poll()) {
+                    if (Protocol::DecisionRequest request{}; frame->type == Protocol::MessageType::DECISION_REQUEST &&
+                                                             Protocol::decode(frame->payload, request)) {
+                        decide(bot, request);
+                        if (interval == Clock::duration::zero()) {
+                            sendReply(shard, bot);
+                        } else {
+                            queued.push_back(&bot);
+                        }
+                    } else if (Protocol::ActionNotice notice{};
+                        frame->type == Protocol::MessageType::ACTION_NOTICE &&
+                        Protocol::decode(frame->payload, notice) && bot.awaitingEcho && notice.playerName == bot.name) {
+                        const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            Clock::now() - bot.sentAt).count();
+                        shard.latencies.push_back(static_cast<std::uint32_t>(std::min<long long>(nanos, UINT32_MAX)));
+                        bot.awaitingEcho = false;
+                    } else if (frame->type == Protocol::MessageType::CHIP_UPDATE) {
+                        shard.chipUpdates++;
+                    } else if (frame->type == Protocol::MessageType::TABLE_CLOSED) {
+                        closed = true;
+                        break;
+                    }
+                }
+                if (!open) {
+                    shard.disconnects++;
+                    closed = true;
+                }
+                if (closed) {
+                    std::erase(queued, &bot);
+                    bot.awaitingEcho = false;
+                    const auto key = REJOIN_KEYS + rejoinSeats.fetch_add(1) / options.seats;
+                    bot.client = connectBot(epoll, &bot, GameClient::connectTcp(options.host, options.port));
+                    bot.client.send(Protocol::Join{key, bot.name});
+                    shard.rejoins++;
+                }
+            }
+
+            for (auto now = Clock::now(); !queued.empty() && nextRelease <= now; nextRelease += interval) {
+                sendReply(shard, *queued.front());
+                queued.pop_front();
+                nextRelease = std::max(nextRelease, now - interval);
+            }
+        }
+        for (const auto &bot: shard.bots) {
+            epoll_ctl(epoll, EPOLL_CTL_DEL, bot->client.getFd(), nullptr);
+        }
+        close(epoll);
+    }
+
+    double percentileMicros(const std::vector<std::uint32_t> &sorted, const double quantile) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const auto index = std::min(sorted.size() - 1, static_cast<std::size_t>(quantile * sorted.size()));
+        return sorted[index] / 1000.0;
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    Options options;
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--host") options.host = value;
+        else if (option == "--port") options.port = static_cast<std::uint16_t>(std::stoi(value));
+        else if (option == "--clients") options.clients = std::stoi(value);
+        else if (option == "--threads") options.threads = std::stoi(value);
+        else if (option == "--workers") options.workers = std::stoi(value);
+        else if (option == "--seats") options.seats = std::stoi(value);
+        else if (option == "--chips") options.chips = std::stoi(value);
+        else if (option == "--hands") options.hands = std::stoi(value);
+        else if (option == "--seconds") options.seconds = std::stod(value);
+        else if (option == "--rate") options.rate = std::stod(value);
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    options.clients = std::max(1, options.clients);
+    options.threads = std::clamp(options.threads, 1, options.clients);
+    options.seats = std::clamp(options.seats, 2, 10);
+
+    std::unique_ptr<GameServer> server;
+    if (options.port == 0) {
+        GameServer::Config config;
+        config.workers = std::max(1, options.workers);
+        config.seatsPerTable = options.seats;
+        config.botsPerTable = 0;
+        config.handsPerTable = std::max(1, options.hands);
+        config.initialChips = options.chips;
+        server = std::make_unique<GameServer>(config);
+        server->start();
+        options.port = server->getTcpPort();
+    }
+
+    std::vector<Shard> shards(options.threads);
+    for (auto i = 0; i < options.clients; i++) {
+        const auto name = "Load " + std::to_string(i + 1);
+        auto client = GameClient::connectTcp(options.host, options.port);
+        client.send(Protocol::Join{static_cast<std::uint32_t>(i / options.seats), name});
+        shards[i % options.threads].bots.push_back(std::make_unique<Bot>(std::move(client), name));
+    }
+
+    const auto handsBefore = server ? server->getHandsPlayed() : 0;
+    const auto started = Clock::now();
+    const auto deadline = started + std::chrono::duration_cast<Clock::duration>(
+                              std::chrono::duration<double>(options.seconds));
+    std::atomic<std::uint32_t> rejoinSeats = 0;
+    std::vector<std::thread> threads;
+    for (auto &shard: shards) {
+        threads.emplace_back(runShard, std::ref(shard), std::cref(options), deadline, std::ref(rejoinSeats));
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    const auto seconds = secondsSince(started);
+
+    Shard total;
+    for (auto &shard: shards) {
+        total.latencies.insert(total.latencies.end(), shard.latencies.begin(), shard.latencies.end());
+        total.actions += shard.actions;
+        total.chipUpdates += shard.chipUpdates;
+        total.rejoins += shard.rejoins;
+        total.disconnects += shard.disconnects;
+    }
+    std::ranges::sort(total.latencies);
+    const auto hands = server
+                           ? static_cast<double>(server->getHandsPlayed() - handsBefore)
+                           : static_cast<double>(total.chipUpdates) / options.seats;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Load: " << options.clients << " clients, " << options.seats << " seats per table, "
+            << options.threads << " client threads";
+    if (server) std::cout << ", " << options.workers << " server workers";
+    std::cout << ", " << seconds << "s" << std::endl;
+    std::cout << "Actions: " << total.actions << " (" << total.actions / seconds << "/s), hands: " << hands
+            << " (" << hands / seconds << "/s), rejoins: " << total.rejoins << ", disconnects: "
+            << total.disconnects << std::endl;
+    std::cout << "Action round trip: p50 " << percentileMicros(total.latencies, 0.5) << "us, p99 "
+            << percentileMicros(total.latencies, 0.99) << "us, p999 " << percentileMicros(total.latencies, 0.999)
+            << "us, max " << (total.latencies.empty() ? 0.0 : total.latencies.back() / 1000.0) << "us ("
+            << total.latencies.size() << " samples)" << std::endl;
+
+    shards.clear();
+    if (server) {
+        server->stop();
+    }
+    return 0;
+}
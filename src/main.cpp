@@ -1,16 +1,63 @@
-﻿#include <memory>
+﻿#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
+#include "Checkpoint.h"
 #include "ComputerPlayer.h"
 #include "Player.h"
 #include "PokerTable.h"
+#include "TableScreen.h"
 #include "TerminalPlayer.h"
 
-int main() {
+int main(const int argc, char *argv[]) {
+    auto showHud = false;
+    auto fullScreen = TableScreen::isTerminal();
+    std::string checkpointPath = "poker.checkpoint";
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--hud") showHud = value == "on";
+        else if (option == "--checkpoint") checkpointPath = value;
+        else if (option == "--screen") fullScreen = value == "on";
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
     PokerTable table;
+    table.setCheckpointPath(checkpointPath);
+
+    auto restored = false;
+    try {
+        if (const auto payload = Checkpoint::readFile(checkpointPath)) {
+            restored = table.restoreCheckpoint(*payload, [showHud](const std::string &name, const int chips,
+                                                                   const bool human) -> std::unique_ptr<Player> {
+                if (human) return std::make_unique<TerminalPlayer>(name, chips, showHud);
+                return std::make_unique<ComputerPlayer>(name, chips);
+            });
+            if (!restored) {
+                std::cerr << "Ignoring unreadable checkpoint: " << checkpointPath << std::endl;
+            }
+        }
+    } catch (const std::runtime_error &error) {
+        std::cerr << "Ignoring checkpoint: " << error.what() << std::endl;
+    }
+
+    std::unique_ptr<TableScreen> screen;
+    if (fullScreen) {
+        screen = std::make_unique<TableScreen>();
+        table.setObserver(screen.get());
+    }
 
-    table.addPlayer(std::unique_ptr<Player>(new TerminalPlayer("Player", 1000)));
-    table.addPlayer(std::unique_ptr<Player>(new ComputerPlayer("Computer 1", 1000)));
-    table.addPlayer(std::unique_ptr<Player>(new ComputerPlayer("Computer 2", 1000)));
+    if (restored) {
+        std::cout << "已从存档恢复游戏: " << checkpointPath << std::endl;
+    } else {
+        table.addPlayer(std::unique_ptr<Player>(new TerminalPlayer("Player", 1000, showHud)));
+        table.addPlayer(std::unique_ptr<Player>(new ComputerPlayer("Computer 1", 1000)));
+        table.addPlayer(std::unique_ptr<Player>(new ComputerPlayer("Computer 2", 1000)));
+    }
 
     table.startGame();
     return 0;
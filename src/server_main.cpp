@@ -0,0 +1,110 @@
+﻿#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "GameServer.h"
+#include "Tracer.h"
+
+namespace {
+    std::atomic stopRequested = false;
+
+    void requestStop(int) {
+        stopRequested = true;
+    }
+
+#ifdef POKER_TRACE
+    void requestTraceDump(int) {
+        Tracer::requestDump();
+    }
+#endif
+
+    void serviceTraceDump([[maybe_unused]] const std::string &path) {
+#ifdef POKER_TRACE
+        if (!path.empty() && Tracer::takeDumpRequest()) {
+            try {
+                const auto events = Tracer::dump(path);
+                std::cout << "trace: " << events << " events written to " << path << std::endl;
+            } catch (const std::exception &error) {
+                std::cerr << error.what() << std::endl;
+            }
+        }
+#endif
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    GameServer::Config config;
+    config.tcpPort = 7777;
+    config.workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string tracePath;
+
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--bind") config.bindAddress = value;
+        else if (option == "--port") config.tcpPort = static_cast<std::uint16_t>(std::stoi(value));
+        else if (option == "--no-tcp") config.enableTcp = value != "1";
+        else if (option == "--unix") config.unixPath = value;
+        else if (option == "--workers") config.workers = std::stoi(value);
+        else if (option == "--seats") config.seatsPerTable = std::stoi(value);
+        else if (option == "--bots") config.botsPerTable = std::stoi(value);
+        else if (option == "--hands") config.handsPerTable = std::stoi(value);
+        else if (option == "--chips") config.initialChips = std::stoi(value);
+        else if (option == "--timeout") config.decisionTimeoutMs = std::stoi(value);
+        else if (option == "--timebank") config.timeBankMs = std::stoi(value);
+        else if (option == "--trace") tracePath = value;
+        else if (option == "--bankroll") config.bankrollPath = value;
+        else if (option == "--decision-service") config.decisionService = value == "on";
+        else if (option == "--abstraction") config.abstractionPath = value;
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    if (!tracePath.empty()) {
+#ifdef POKER_TRACE
+        std::signal(SIGUSR1, requestTraceDump);
+#else
+        std::cerr << "Tracing is not compiled in; reconfigure with -DPOKER_TRACE=ON" << std::endl;
+#endif
+    }
+
+    GameServer server(config);
+    server.start();
+
+    std::cout << "Poker server running with " << config.workers << " workers";
+    if (config.enableTcp) std::cout << ", tcp " << config.bindAddress << ":" << server.getTcpPort();
+    if (!config.unixPath.empty()) std::cout << ", unix " << config.unixPath;
+    std::cout << std::endl;
+
+    auto lastReport = std::chrono::steady_clock::now();
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        serviceTraceDump(tracePath);
+        if (const auto now = std::chrono::steady_clock::now(); now - lastReport >= std::chrono::seconds(5)) {
+            lastReport = now;
+            std::cout << "connections: " << server.getConnectionsAccepted()
+                    << ", tables: " << server.getTablesOpened()
+                    << ", hands: " << server.getHandsPlayed()
+                    << ", actions: " << server.getActionsReceived()
+                    << ", timeouts: " << server.getDecisionTimeouts()
+                    << ", spectators: " << server.getSpectators()
+                    << ", settlements: " << server.getSettlements()
+                    << ", rejected: " << server.getSettlementsRejected() << std::endl;
+        }
+    }
+
+    server.stop();
+#ifdef POKER_TRACE
+    Tracer::requestDump();
+#endif
+    serviceTraceDump(tracePath);
+    return 0;
+}
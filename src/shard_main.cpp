@@ -0,0 +1,48 @@
+﻿#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "ShardedSimulation.h"
+
+int main(const int argc, char *argv[]) {
+    ShardedSimulation::Config config;
+    config.processes = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--hands") config.hands = std::stoull(value);
+        else if (option == "--processes") config.processes = std::stoi(value);
+        else if (option == "--seats") config.seats = std::stoi(value);
+        else if (option == "--stack") config.stack = std::stoi(value);
+        else if (option == "--blinds") {
+            config.bigBlind = std::stoi(value);
+            config.smallBlind = config.bigBlind / 2;
+        } else if (option == "--seed") config.seed = std::stoull(value);
+        else if (option == "--pin") config.pinCores = value != "0";
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    ShardedSimulation simulation(config);
+    const auto results = simulation.run([](const std::uint64_t played, const std::uint64_t total) {
+        std::cout << "\rPlayed " << played << " / " << total << " hands" << std::flush;
+    });
+    std::cout << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << results.hands << " hands on " << config.processes << " processes in " << results.seconds << "s ("
+            << static_cast<double>(results.hands) / results.seconds << " hands/s)" << std::endl;
+    for (std::size_t seat = 0; seat < results.seats.size(); seat++) {
+        const auto &[wins, chipDelta] = results.seats[seat];
+        std::cout << "Seat " << seat + 1 << ": won " << wins << " hands ("
+                << 100.0 * static_cast<double>(wins) / static_cast<double>(results.hands) << "%), net "
+                << chipDelta << " chips (" << static_cast<double>(chipDelta) / static_cast<double>(results.hands)
+                << " per hand)" << std::endl;
+    }
+    std::cout << "Result digest: " << std::hex << ShardedSimulation::digest(results) << std::dec << std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+﻿#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+
+#include "ComputerPlayer.h"
+#include "Console.h"
+#include "PokerTable.h"
+#include "SimulationTable.h"
+
+namespace {
+    constexpr std::size_t MAX_SEATS = 10;
+
+    struct Options {
+        long long hands = 1000000;
+        long long baselineHands = 0;
+        int seats = 9;
+        int stack = 1000;
+        std::uint64_t seed = 1;
+        std::string policy = "random";
+        std::string variant = "holdem";
+    };
+
+    double secondsSince(const std::chrono::steady_clock::time_point started) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    template<typename Policy, typename Variant>
+    void runSimulation(const Options &options) {
+        SimulationTable<MAX_SEATS, Policy, Variant> table(options.seats, options.stack, options.seed);
+        const auto started = std::chrono::steady_clock::now();
+        for (auto hand = 0LL; hand < options.hands; hand++) {
+            table.refill(options.stack);
+            table.playHand();
+        }
+        const auto seconds = secondsSince(started);
+
+        const auto &stacks = table.getSeats().stack;
+        std::cout << "Simulation (" << options.variant << ", " << options.policy << "): " << table.getHandsPlayed() << " hands, "
+                << table.getDecisions() << " decisions in " << seconds << "s ("
+                << static_cast<double>(table.getHandsPlayed()) / seconds << " hands/s)" << std::endl;
+        std::cout << "Chips on table: " << std::accumulate(stacks.begin(), stacks.end(), 0) << std::endl;
+    }
+
+    template<typename Policy>
+    bool runVariant(const Options &options) {
+        if (options.variant == "holdem") {
+            runSimulation<Policy, HoldemVariant>(options);
+        } else if (options.variant == "shortdeck") {
+            runSimulation<Policy, ShortDeckVariant>(options);
+        } else {
+            std::cerr << "Unknown variant: " << options.variant << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void runBaseline(const Options &options) {
+        Console::setQuiet(true);
+        PokerTable table;
+        table.setHistoryRecorded(false);
+        for (auto seat = 0; seat < options.seats; seat++) {
+            table.addPlayer(std::make_unique<ComputerPlayer>("Seat " + std::to_string(seat + 1), options.stack));
+        }
+        table.setBlinds(5, 10);
+
+        const auto started = std::chrono::steady_clock::now();
+        auto played = 0LL;
+        for (; played < options.baselineHands && table.getPlayers().size() > 1; played++) {
+            table.playHand();
+            for (const auto &player: table.getPlayers()) {
+                if (player->getChipCount() == 0) {
+                    player->addChips(options.stack);
+                }
+            }
+        }
+        const auto seconds = secondsSince(started);
+        Console::setQuiet(false);
+
+        std::cout << "PokerTable baseline: " << played << " hands in " << seconds << "s ("
+                << static_cast<double>(played) / seconds << " hands/s)" << std::endl;
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    Options options;
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--hands") options.hands = std::stoll(value);
+        else if (option == "--baseline") options.baselineHands = std::stoll(value);
+        else if (option == "--seats") options.seats = std::stoi(value);
+        else if (option == "--stack") options.stack = std::stoi(value);
+        else if (option == "--seed") options.seed = std::stoull(value);
+        else if (option == "--policy") options.policy = value;
+        else if (option == "--variant") options.variant = value;
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    if (options.seats < 2 || options.seats > static_cast<int>(MAX_SEATS)) {
+        std::cerr << "Seats must be between 2 and " << MAX_SEATS << std::endl;
+        return 1;
+    }
+
+    if (options.policy == "strength") {
+        if (!runVariant<StrengthPolicy>(options)) return 1;
+    } else if (options.policy == "random") {
+        if (!runVariant<RandomPolicy>(options)) return 1;
+    } else {
+        std::cerr << "Unknown policy: " << options.policy << std::endl;
+        return 1;
+    }
+
+    if (options.baselineHands > 0) {
+        runBaseline(options);
+    }
+    return 0;
+}
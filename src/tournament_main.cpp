@@ -0,0 +1,212 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "Instrumentation.h"
+#include "ScreenBuffer.h"
+#include "Tournament.h"
+#include "Tracer.h"
+
+namespace {
+    constexpr auto SPECTATE_COLUMNS = 4;
+    constexpr auto TABLE_WIDTH = 30;
+
+#ifdef POKER_TRACE
+    void requestTraceDump(int) {
+        Tracer::requestDump();
+    }
+#endif
+
+    void serviceTraceDump([[maybe_unused]] const std::string &path) {
+#ifdef POKER_TRACE
+        if (!path.empty() && Tracer::takeDumpRequest()) {
+            try {
+                const auto events = Tracer::dump(path);
+                std::cerr << "Trace: " << events << " events written to " << path << std::endl;
+            } catch (const std::exception &error) {
+                std::cerr << error.what() << std::endl;
+            }
+        }
+#endif
+    }
+
+    void drawTables(ScreenBuffer &screen, const Tournament &tournament, const int tables, const int seats,
+                    const double seconds) {
+        screen.clear();
+        const auto hands = tournament.getHandsPlayed();
+        const auto header = "Remaining: " + std::to_string(tournament.getStandings().size()) + "   Hands: " +
+                            std::to_string(hands) + "   Hands/s: " +
+                            std::to_string(static_cast<long long>(seconds > 0 ? hands / seconds : 0)) +
+                            "   Tables broken: " + std::to_string(tournament.getTablesBroken());
+        screen.draw(0, 0, header, ScreenBuffer::Style::BOLD);
+
+        const auto views = tournament.getTableViews(tables);
+        const auto height = seats + 3;
+        for (std::size_t v = 0; v < views.size(); v++) {
+            const auto &[id, handsPlayed, blinds, players] = views[v];
+            const auto top = 2 + static_cast<int>(v) / SPECTATE_COLUMNS * height;
+            const auto left = static_cast<int>(v) % SPECTATE_COLUMNS * TABLE_WIDTH;
+            screen.box(top, left, height, TABLE_WIDTH, "Table " + std::to_string(id + 1));
+            screen.draw(top + 1, left + 2, "Blinds " + std::to_string(blinds.smallBlind) + "/" +
+                                           std::to_string(blinds.bigBlind) + "  Hand " +
+                                           std::to_string(handsPlayed + 1), ScreenBuffer::Style::CYAN,
+                        TABLE_WIDTH - 4);
+
+            auto leader = 0;
+            for (const auto &seat: players) {
+                leader = std::max(leader, seat.chips);
+            }
+            for (std::size_t s = 0; s < players.size() && static_cast<int>(s) < seats; s++) {
+                const auto &[name, chips] = players[s];
+                const auto style = chips == leader ? ScreenBuffer::Style::GREEN
+                                   : chips < 10 * blinds.bigBlind ? ScreenBuffer::Style::RED
+                                   : ScreenBuffer::Style::NORMAL;
+                const auto stack = std::to_string(chips);
+                const auto row = top + 2 + static_cast<int>(s);
+                screen.draw(row, left + 2, name, style, TABLE_WIDTH - 6 - static_cast<int>(stack.size()));
+                screen.draw(row, left + TABLE_WIDTH - 2 - static_cast<int>(stack.size()), stack, style);
+            }
+        }
+        screen.present();
+    }
+
+#ifdef POKER_INSTRUMENT
+    void printPhaseLatencies() {
+        std::cout << std::left << std::setw(10) << "Phase" << std::right << std::setw(12) << "Count"
+                << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "p999 us"
+                << std::setw(12) << "max us" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (const auto &[phase, count, p50, p99, p999, max]: Instrumentation::summarize()) {
+            std::cout << std::left << std::setw(10) << Instrumentation::phaseName(phase) << std::right
+                    << std::setw(12) << count << std::setw(12) << p50 / 1000 << std::setw(12) << p99 / 1000
+                    << std::setw(12) << p999 / 1000 << std::setw(12) << max / 1000 << std::endl;
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        const auto counters = Instrumentation::counters();
+        for (auto c = 0; c < Instrumentation::COUNTERS; c++) {
+            std::cout << (c == 0 ? "Decisions: " : ", ")
+                    << Instrumentation::counterName(static_cast<Instrumentation::Counter>(c)) << " " << counters[c];
+        }
+        std::cout << std::endl;
+    }
+#endif
+}
+
+int main(const int argc, char *argv[]) {
+    Tournament::Config config;
+    config.workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    auto spectate = 0;
+    std::string tracePath;
+
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--entrants") config.entrants = std::stoi(value);
+        else if (option == "--seats") config.seatsPerTable = std::stoi(value);
+        else if (option == "--stack") config.startingStack = std::stoi(value);
+        else if (option == "--buyin") config.buyIn = std::stoi(value);
+        else if (option == "--workers") config.workers = std::stoi(value);
+        else if (option == "--level-hands") config.handsPerLevel = std::stoi(value);
+        else if (option == "--paid") config.paidFraction = std::stod(value);
+        else if (option == "--spectate") spectate = std::stoi(value);
+        else if (option == "--trace") tracePath = value;
+        else if (option == "--decision-service") config.decisionService = value == "on";
+        else if (option == "--abstraction") config.abstractionPath = value;
+        else if (option == "--variant") {
+            config.variant = value == "plo" ? GameSettings::Variant::POT_LIMIT_OMAHA
+                                            : GameSettings::Variant::TEXAS_HOLDEM;
+        }
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.entrants < 2) {
+        std::cerr << "--entrants must be at least 2" << std::endl;
+        return 1;
+    }
+    if (config.seatsPerTable < 2) {
+        std::cerr << "--seats must be at least 2" << std::endl;
+        return 1;
+    }
+
+    if (!tracePath.empty()) {
+#ifdef POKER_TRACE
+        std::signal(SIGUSR1, requestTraceDump);
+#else
+        std::cerr << "Tracing is not compiled in; reconfigure with -DPOKER_TRACE=ON" << std::endl;
+#endif
+    }
+
+    Tournament tournament(config);
+    const auto started = std::chrono::steady_clock::now();
+    std::atomic running = true;
+    std::thread reporter([&tournament, &running, &config, &tracePath, spectate, started] {
+        if (spectate > 0) {
+            const auto gridRows = (spectate + SPECTATE_COLUMNS - 1) / SPECTATE_COLUMNS;
+            ScreenBuffer screen(2 + gridRows * (config.seatsPerTable + 3),
+                                std::min(spectate, SPECTATE_COLUMNS) * TABLE_WIDTH);
+            while (running) {
+                const auto elapsed = std::chrono::steady_clock::now() - started;
+                drawTables(screen, tournament, spectate, config.seatsPerTable,
+                           std::chrono::duration<double>(elapsed).count());
+                std::this_thread::sleep_for(std::chrono::milliseconds(33));
+                serviceTraceDump(tracePath);
+            }
+            drawTables(screen, tournament, spectate, config.seatsPerTable,
+                       std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+            return;
+        }
+        while (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (const auto &standings = tournament.getStandings(); running && standings.size() > 1) {
+                if (const auto leaders = standings.top(1); !leaders.empty()) {
+                    std::cout << "Remaining: " << standings.size() << ", chip leader: " << leaders.front().name
+                            << " (" << leaders.front().chips << ")" << std::endl;
+                }
+            }
+            for (auto i = 0; i < 9 && running; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                serviceTraceDump(tracePath);
+            }
+        }
+    });
+    tournament.run();
+    running = false;
+    reporter.join();
+#ifdef POKER_TRACE
+    Tracer::requestDump();
+#endif
+    serviceTraceDump(tracePath);
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    const auto results = tournament.getResults();
+    std::cout << "Entrants: " << config.entrants << ", tables: " << tournament.getTablesOpened()
+            << ", workers: " << config.workers << std::endl;
+    std::cout << "Hands: " << tournament.getHandsPlayed() << " in " << seconds << "s ("
+            << static_cast<double>(tournament.getHandsPlayed()) / seconds << " hands/s)" << std::endl;
+    std::cout << "Table moves: " << tournament.getTableMoves() << ", tables broken: "
+            << tournament.getTablesBroken() << std::endl;
+    std::cout << "Prize pool: " << tournament.getPrizePool() << std::endl;
+    for (const auto &[name, place, prize]: results) {
+        if (place > 10) break;
+        std::cout << place << ". " << name << " - " << prize << std::endl;
+    }
+#ifdef POKER_INSTRUMENT
+    printPhaseLatencies();
+#endif
+#ifdef POKER_COUNT_ALLOCATIONS
+    if (const auto allocating = tournament.getAllocatingHands(); allocating > 0) {
+        std::cerr << "Steady-state hands that allocated: " << allocating << std::endl;
+        return 1;
+    }
+#endif
+    return 0;
+}
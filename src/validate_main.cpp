@@ -0,0 +1,302 @@
+﻿#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "GameVariant.h"
+#include "HandArena.h"
+#include "HandEvaluator.h"
+#include "PokerTable.h"
+
+class EvaluatorHarness {
+public:
+    struct Evaluator {
+        const char *name;
+        int (*evaluate)(HandEvaluator::CardMask cards);
+        HandEvaluator::Category (*categoryOf)(int score);
+    };
+
+    static std::span<const Evaluator> evaluators() {
+        static constexpr Evaluator EVALUATORS[] = {
+            {"fast", HandEvaluator::evaluate, HandEvaluator::categoryOf},
+            {"five", bestOfFive, HandEvaluator::categoryOf},
+            {"variant", HoldemVariant::evaluate, HoldemVariant::categoryOf},
+            {"legacy", legacy, legacyCategory},
+        };
+        return EVALUATORS;
+    }
+
+    static const Evaluator *find(const std::string &name) {
+        const auto all = evaluators();
+        const auto found = std::ranges::find(all, name, [](const Evaluator &evaluator) {
+            return std::string(evaluator.name);
+        });
+        return found == all.end() ? nullptr : &*found;
+    }
+
+private:
+    static int bestOfFive(const HandEvaluator::CardMask cards) {
+        std::array<HandEvaluator::CardMask, 7> singles{};
+        auto count = 0;
+        for (auto rest = cards; rest && count < 7; rest &= rest - 1) {
+            singles[count++] = rest & -rest;
+        }
+        auto best = -1;
+        for (auto skipA = 0; skipA < count; skipA++) {
+            for (auto skipB = skipA + 1; skipB < count; skipB++) {
+                best = std::max(best, HandEvaluator::evaluateFive(cards & ~singles[skipA] & ~singles[skipB]));
+            }
+        }
+        return best;
+    }
+
+    static int legacy(const HandEvaluator::CardMask cards) {
+        thread_local HandArena arena;
+        thread_local std::vector<Card> holeCards;
+        thread_local std::vector<Card> communityCards;
+        holeCards.clear();
+        communityCards.clear();
+        for (auto index = 0; index < 52; index++) {
+            if (cards & HandEvaluator::cardBit(index)) {
+                (holeCards.size() < 2 ? holeCards : communityCards).push_back(HandEvaluator::cardFromIndex(index));
+            }
+        }
+        arena.reset();
+        return PokerTable::evaluateHandStrength(holeCards, communityCards, &arena);
+    }
+
+    static HandEvaluator::Category legacyCategory(const int score) {
+        return static_cast<HandEvaluator::Category>(std::clamp(score / 1000000, 0, 8));
+    }
+};
+
+namespace {
+    constexpr auto CATEGORIES = 9;
+    constexpr auto MAX_EXAMPLES = 5;
+    constexpr std::uint64_t TOTAL_HANDS = 133784560;
+    constexpr std::array<std::uint64_t, CATEGORIES> EXPECTED_COUNTS{
+        23294460, 58627800, 31433400, 6461620, 6180020, 4047644, 3473184, 224848, 41584
+    };
+
+    struct Options {
+        std::string evaluator = "fast";
+        std::string compare;
+        int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    };
+
+    struct Tally {
+        std::array<std::array<std::uint64_t, CATEGORIES>, 2> counts{};
+        std::array<std::array<std::uint64_t, CATEGORIES>, CATEGORIES> confusion{};
+        std::unordered_map<int, std::pair<int, int> > classes;
+        std::uint64_t disagreements = 0;
+    };
+
+    struct Example {
+        std::array<int, 7> cards;
+        int primary;
+        int secondary;
+    };
+
+    std::string describe(const std::array<int, 7> &cards) {
+        std::string text;
+        for (const auto index: cards) {
+            text += HandEvaluator::cardFromIndex(index).toString() + " ";
+        }
+        return text;
+    }
+
+    void enumerate(const EvaluatorHarness::Evaluator &primary, const EvaluatorHarness::Evaluator *secondary,
+                   const int threads, Tally &total, std::vector<Example> &examples) {
+        std::vector<std::pair<int, int> > pairs;
+        for (auto first = 0; first < 52; first++) {
+            for (auto second = first + 1; second < 47; second++) {
+                pairs.emplace_back(first, second);
+            }
+        }
+
+        std::array<HandEvaluator::CardMask, 52> bits{};
+        for (auto index = 0; index < 52; index++) {
+            bits[index] = HandEvaluator::cardBit(index);
+        }
+
+        std::mutex merge;
+        std::atomic<std::size_t> next = 0;
+        const auto run = [&] {
+            Tally tally;
+            for (auto task = next++; task < pairs.size(); task = next++) {
+                const auto [c0, c1] = pairs[task];
+                const auto m1 = bits[c0] | bits[c1];
+                for (auto c2 = c1 + 1; c2 < 48; c2++) {
+                    const auto m2 = m1 | bits[c2];
+                    for (auto c3 = c2 + 1; c3 < 49; c3++) {
+                        const auto m3 = m2 | bits[c3];
+                        for (auto c4 = c3 + 1; c4 < 50; c4++) {
+                            const auto m4 = m3 | bits[c4];
+                            for (auto c5 = c4 + 1; c5 < 51; c5++) {
+                                const auto m5 = m4 | bits[c5];
+                                for (auto c6 = c5 + 1; c6 < 52; c6++) {
+                                    const auto cards = m5 | bits[c6];
+                                    const auto score = primary.evaluate(cards);
+                                    const auto category = static_cast<int>(primary.categoryOf(score));
+                                    tally.counts[0][category]++;
+                                    if (!secondary) {
+                                        continue;
+                                    }
+
+                                    const auto other = secondary->evaluate(cards);
+                                    const auto otherCategory = static_cast<int>(secondary->categoryOf(other));
+                                    tally.counts[1][otherCategory]++;
+                                    auto &[low, high] = tally.classes.try_emplace(score, other, other).first->second;
+                                    low = std::min(low, other);
+                                    high = std::max(high, other);
+                                    if (category != otherCategory) {
+                                        tally.confusion[category][otherCategory]++;
+                                        if (tally.disagreements++ < MAX_EXAMPLES) {
+                                            std::lock_guard lock(merge);
+                                            if (examples.size() < MAX_EXAMPLES) {
+                                                examples.push_back({{c0, c1, c2, c3, c4, c5, c6}, score, other});
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::lock_guard lock(merge);
+            for (auto side = 0; side < 2; side++) {
+                for (auto c = 0; c < CATEGORIES; c++) {
+                    total.counts[side][c] += tally.counts[side][c];
+                }
+            }
+            for (auto a = 0; a < CATEGORIES; a++) {
+                for (auto b = 0; b < CATEGORIES; b++) {
+                    total.confusion[a][b] += tally.confusion[a][b];
+                }
+            }
+            for (const auto &[score, range]: tally.classes) {
+                auto &[low, high] = total.classes.try_emplace(score, range).first->second;
+                low = std::min(low, range.first);
+                high = std::max(high, range.second);
+            }
+            total.disagreements += tally.disagreements;
+        };
+
+        std::vector<std::thread> pool;
+        for (auto worker = 1; worker < threads; worker++) {
+            pool.emplace_back(run);
+        }
+        run();
+        for (auto &thread: pool) {
+            thread.join();
+        }
+    }
+}
+
+int main(const int argc, char *argv[]) {
+    Options options;
+    if (argc % 2 == 0) {
+        std::cerr << "Missing value for " << argv[argc - 1] << std::endl;
+        return 1;
+    }
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--evaluator") options.evaluator = value;
+        else if (option == "--compare") options.compare = value;
+        else if (option == "--threads") options.threads = std::max(1, std::stoi(value));
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+
+    const auto *primary = EvaluatorHarness::find(options.evaluator);
+    const auto *secondary = options.compare.empty() ? nullptr : EvaluatorHarness::find(options.compare);
+    if (!primary || (!options.compare.empty() && !secondary)) {
+        std::cerr << "Evaluators:";
+        for (const auto &evaluator: EvaluatorHarness::evaluators()) {
+            std::cerr << " " << evaluator.name;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    Tally tally;
+    std::vector<Example> examples;
+    const auto started = std::chrono::steady_clock::now();
+    enumerate(*primary, secondary, options.threads, tally, examples);
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::uint64_t hands = 0;
+    for (const auto count: tally.counts[0]) {
+        hands += count;
+    }
+    std::cout << "Enumerated " << hands << " hands in " << seconds << "s with " << options.threads
+            << " threads (" << static_cast<double>(hands) / seconds / 1e6 << "M hands/s)" << std::endl;
+
+    auto passed = hands == TOTAL_HANDS;
+    std::cout << std::left << std::setw(18) << "Category" << std::right << std::setw(12) << "Expected"
+            << std::setw(12) << primary->name;
+    if (secondary) {
+        std::cout << std::setw(12) << secondary->name;
+    }
+    std::cout << std::endl;
+    for (auto c = CATEGORIES - 1; c >= 0; c--) {
+        const auto name = HandEvaluator::categoryName(static_cast<HandEvaluator::Category>(c));
+        std::cout << std::left << std::setw(18) << name << std::right << std::setw(12) << EXPECTED_COUNTS[c]
+                << std::setw(12) << tally.counts[0][c];
+        passed = passed && tally.counts[0][c] == EXPECTED_COUNTS[c];
+        if (secondary) {
+            std::cout << std::setw(12) << tally.counts[1][c];
+            passed = passed && tally.counts[1][c] == EXPECTED_COUNTS[c];
+        }
+        std::cout << std::endl;
+    }
+
+    if (secondary) {
+        std::vector<std::pair<int, std::pair<int, int> > > classes(tally.classes.begin(), tally.classes.end());
+        std::ranges::sort(classes);
+        auto splits = 0;
+        auto inversions = 0;
+        for (std::size_t i = 0; i < classes.size(); i++) {
+            if (classes[i].second.first != classes[i].second.second) {
+                splits++;
+            }
+            if (i > 0 && classes[i - 1].second.second >= classes[i].second.first) {
+                inversions++;
+            }
+        }
+        std::cout << "Category disagreements: " << tally.disagreements << std::endl;
+        for (auto a = 0; a < CATEGORIES; a++) {
+            for (auto b = 0; b < CATEGORIES; b++) {
+                if (tally.confusion[a][b] > 0) {
+                    std::cout << "  " << HandEvaluator::categoryName(static_cast<HandEvaluator::Category>(a))
+                            << " -> " << HandEvaluator::categoryName(static_cast<HandEvaluator::Category>(b))
+                            << ": " << tally.confusion[a][b] << std::endl;
+                }
+            }
+        }
+        std::cout << "Equivalence classes: " << classes.size() << ", split by " << secondary->name << ": "
+                << splits << ", ordered differently: " << inversions << std::endl;
+        for (const auto &[cards, score, other]: examples) {
+            std::cout << "  " << describe(cards) << "-> " << primary->name << " " << score << ", "
+                    << secondary->name << " " << other << std::endl;
+        }
+        passed = passed && tally.disagreements == 0 && splits == 0 && inversions == 0;
+    }
+
+    std::cout << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed ? 0 : 1;
+}